@@ -1,28 +1,29 @@
 import argparse
 import subprocess
 import time
-import random
 import shlex
 
-RANDOM_LIMIT = 1000
 SEED = 123456789
-random.seed(SEED)
 
-AMMUNITION = [
-    'localhost:8080/api/v1/maps/map1',
-    'localhost:8080/api/v1/maps'
-]
-
-SHOOT_COUNT = 100
-COOLDOWN = 0.1
+# Нагрузку даёт load_generator (см. CMakeLists.txt): постоянные соединения и открытая модель,
+# задержки считаются от запланированного момента отправки
+LOAD_GENERATOR = './build/bin/load_generator'
+SCENARIO = './scenarios/maps.txt'
+RATE = 1000
+DURATION = 10
+CONNECTIONS = 16
+LATENCY_REPORT = 'latency.hgrm'
 
 PERF_DATA = "perf.data"
 RESULT_SVG = "graph.svg"
 
-def start_server():
+def parse_args():
     parser = argparse.ArgumentParser()
     parser.add_argument('server', type=str, help='Command to start the server')
-    return parser.parse_args().server
+    parser.add_argument('--scenario', type=str, default=SCENARIO, help='Load generator scenario file')
+    parser.add_argument('--rate', type=float, default=RATE, help='Requests per second')
+    parser.add_argument('--duration', type=float, default=DURATION, help='Shooting duration in seconds')
+    return parser.parse_args()
 
 def run(command, output=None, shell=False):
     process = subprocess.Popen(shlex.split(command) if not shell else command, stdout=output, stderr=subprocess.DEVNULL, shell=shell)
@@ -46,21 +47,19 @@ def convert_to_flamegraph():
     convert_process = run(convert_command, shell=True)
     return convert_process
 
-def shoot(ammo):
-    hit = run('curl ' + ammo, output=subprocess.DEVNULL)
-    time.sleep(COOLDOWN)
-    stop(hit, wait=True)
-
-def make_shots():
-    for _ in range(SHOOT_COUNT):
-        ammo_number = random.randrange(RANDOM_LIMIT) % len(AMMUNITION)
-        shoot(AMMUNITION[ammo_number])
+def make_shots(args):
+    command = (f'{LOAD_GENERATOR} --scenario {args.scenario} --rate {args.rate} --duration {args.duration}'
+               f' --connections {CONNECTIONS} --seed {SEED} --wait-for-server 5000 --hgrm-file {LATENCY_REPORT}')
+    # Отчёт генератора (пропускная способность и перцентили задержек) выводим как есть
+    load = subprocess.Popen(shlex.split(command))
+    load.wait()
     print('Shooting complete')
 
-server = run(start_server())  
+args = parse_args()
+server = run(args.server)
 perf_process = record_perf(server.pid)
 
-make_shots()
+make_shots(args)
 
 stop(server)
 stop(perf_process, wait=True)
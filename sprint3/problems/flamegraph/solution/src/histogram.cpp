@@ -0,0 +1,159 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+namespace load_generator {
+    namespace {
+        // Проверка до сдвига: сдвиг на отрицательное или слишком большое число бит - неопределённое поведение
+        int CheckSubBucketBits(int sub_bucket_bits) {
+            if (sub_bucket_bits < 2 || sub_bucket_bits > 16) {
+                throw std::invalid_argument("sub_bucket_bits must be in [2, 16]");
+            }
+            return sub_bucket_bits;
+        }
+    }
+
+    LatencyHistogram::LatencyHistogram(int sub_bucket_bits)
+        : sub_bucket_bits_(CheckSubBucketBits(sub_bucket_bits))
+        , sub_bucket_count_(uint64_t{ 1 } << (sub_bucket_bits_ - 1)) {
+        // Точный диапазон [0, 2 * sub_bucket_count_) и по sub_bucket_count_ ячеек на каждую следующую степень двойки
+        counts_.resize((64 - sub_bucket_bits_ + 2) * sub_bucket_count_);
+    }
+
+    void LatencyHistogram::Record(uint64_t value) {
+        ++counts_[IndexOf(value)];
+        ++total_count_;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        sum_ += static_cast<double>(value);
+        sum_of_squares_ += static_cast<double>(value) * static_cast<double>(value);
+    }
+
+    void LatencyHistogram::Merge(const LatencyHistogram& other) {
+        if (other.sub_bucket_bits_ != sub_bucket_bits_) {
+            throw std::invalid_argument("Histograms have different precision");
+        }
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_count_ += other.total_count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+        sum_of_squares_ += other.sum_of_squares_;
+    }
+
+    uint64_t LatencyHistogram::GetCount() const {
+        return total_count_;
+    }
+
+    uint64_t LatencyHistogram::GetMin() const {
+        return total_count_ ? min_ : 0;
+    }
+
+    uint64_t LatencyHistogram::GetMax() const {
+        return max_;
+    }
+
+    double LatencyHistogram::GetMean() const {
+        return total_count_ ? sum_ / total_count_ : 0.0;
+    }
+
+    double LatencyHistogram::GetStdDeviation() const {
+        if (!total_count_) {
+            return 0.0;
+        }
+        double mean = GetMean();
+        return std::sqrt(std::max(sum_of_squares_ / total_count_ - mean * mean, 0.0));
+    }
+
+    uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+        if (!total_count_) {
+            return 0;
+        }
+
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        auto target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_count_));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            cumulative += counts_[i];
+            if (cumulative >= target) {
+                return std::min(HighestEquivalentValue(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    void LatencyHistogram::PrintPercentileDistribution(std::ostream& output, double value_unit_scale, int ticks_per_half_distance) const {
+        output << std::setw(12) << "Value" << ' ' << std::setw(14) << "Percentile" << ' '
+            << std::setw(10) << "TotalCount" << ' ' << std::setw(14) << "1/(1-Percentile)" << "\n\n";
+
+        output << std::fixed;
+
+        double percentile = 0;
+        while (total_count_) {
+            uint64_t value = ValueAtPercentile(percentile);
+            uint64_t count = CountAtOrBelow(value);
+            double fraction = static_cast<double>(count) / total_count_;
+
+            output << std::setw(12) << std::setprecision(3) << value / value_unit_scale << ' '
+                << std::setw(14) << std::setprecision(12) << fraction << ' '
+                << std::setw(10) << count;
+            if (count < total_count_) {
+                output << ' ' << std::setw(14) << std::setprecision(2) << 1.0 / (1.0 - fraction);
+            }
+            output << '\n';
+
+            if (count >= total_count_) {
+                break;
+            }
+
+            // Шаг уменьшается вдвое на каждой "половине расстояния" до 100%, как в HdrHistogram
+            double half_distance = std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - percentile))) + 1);
+            percentile = std::min(percentile + 100.0 / (ticks_per_half_distance * half_distance), 100.0);
+        }
+
+        output << std::setprecision(3)
+            << "#[Mean    = " << std::setw(12) << GetMean() / value_unit_scale
+            << ", StdDeviation   = " << std::setw(12) << GetStdDeviation() / value_unit_scale << "]\n"
+            << "#[Max     = " << std::setw(12) << GetMax() / value_unit_scale
+            << ", Total count    = " << std::setw(12) << total_count_ << "]\n"
+            << "#[Buckets = " << std::setw(12) << counts_.size() / sub_bucket_count_
+            << ", SubBuckets     = " << std::setw(12) << 2 * sub_bucket_count_ << "]\n";
+
+        output << std::defaultfloat;
+    }
+
+    size_t LatencyHistogram::IndexOf(uint64_t value) const {
+        if (value < 2 * sub_bucket_count_) {
+            return static_cast<size_t>(value);
+        }
+        // value лежит в [2^k, 2^(k+1)), k >= sub_bucket_bits_: отбрасываем младшие биты, оставляя sub_bucket_bits_ старших
+        int shift = std::bit_width(value) - sub_bucket_bits_;
+        return static_cast<size_t>(shift * sub_bucket_count_ + (value >> shift));
+    }
+
+    uint64_t LatencyHistogram::HighestEquivalentValue(size_t index) const {
+        if (index < 2 * sub_bucket_count_) {
+            return index;
+        }
+        uint64_t shift = index / sub_bucket_count_ - 1;
+        uint64_t mantissa = index % sub_bucket_count_ + sub_bucket_count_;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    uint64_t LatencyHistogram::CountAtOrBelow(uint64_t value) const {
+        uint64_t cumulative = 0;
+        size_t last = IndexOf(value);
+        for (size_t i = 0; i <= last; ++i) {
+            cumulative += counts_[i];
+        }
+        return cumulative;
+    }
+} // namespace load_generator
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace load_generator {
+    /*
+     * Лог-линейная гистограмма в духе HdrHistogram: значения до 2^sub_bucket_bits хранятся точно,
+     * дальше каждый интервал [2^k, 2^(k+1)) делится на 2^(sub_bucket_bits - 1) равных частей.
+     * Относительная погрешность не хуже 2^-(sub_bucket_bits - 1), память не зависит от числа записей.
+     */
+    class LatencyHistogram {
+    public:
+        explicit LatencyHistogram(int sub_bucket_bits = 8);
+
+        void Record(uint64_t value);
+
+        void Merge(const LatencyHistogram& other);
+
+        uint64_t GetCount() const;
+
+        uint64_t GetMin() const;
+
+        uint64_t GetMax() const;
+
+        double GetMean() const;
+
+        double GetStdDeviation() const;
+
+        // Наибольшее значение, эквивалентное тому, ниже которого лежит percentile процентов записей
+        uint64_t ValueAtPercentile(double percentile) const;
+
+        // Распределение в формате .hgrm, который понимают плоттеры HdrHistogram
+        void PrintPercentileDistribution(std::ostream& output, double value_unit_scale, int ticks_per_half_distance = 5) const;
+    private:
+        size_t IndexOf(uint64_t value) const;
+
+        uint64_t HighestEquivalentValue(size_t index) const;
+
+        uint64_t CountAtOrBelow(uint64_t value) const;
+
+        int sub_bucket_bits_;
+        uint64_t sub_bucket_count_;
+        std::vector<uint64_t> counts_;
+        uint64_t total_count_ = 0;
+        uint64_t min_ = UINT64_MAX;
+        uint64_t max_ = 0;
+        // Суммы в double, чтобы не переполниться на длинных прогонах
+        double sum_ = 0;
+        double sum_of_squares_ = 0;
+    };
+} // namespace load_generator
@@ -0,0 +1,399 @@
+#include "load_generator.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace load_generator {
+    namespace beast = boost::beast;
+    namespace json = boost::json;
+    namespace sys = boost::system;
+
+    using namespace std::literals;
+
+    namespace {
+        uint64_t ToMicroseconds(Clock::duration duration) {
+            return static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+        }
+    }
+
+    WorkerReport::WorkerReport(size_t request_kinds)
+        : latency_by_request(request_kinds)
+        , count_by_request(request_kinds) {
+    }
+
+    void WorkerReport::Merge(const WorkerReport& other) {
+        latency.Merge(other.latency);
+        service_time.Merge(other.service_time);
+        for (size_t i = 0; i < latency_by_request.size(); ++i) {
+            latency_by_request[i].Merge(other.latency_by_request[i]);
+            count_by_request[i] += other.count_by_request[i];
+        }
+
+        scheduled += other.scheduled;
+        completed += other.completed;
+        failed += other.failed;
+        non_success += other.non_success;
+        unsent += other.unsent;
+        connects += other.connects;
+        max_backlog = std::max(max_backlog, other.max_backlog);
+        last_response = std::max(last_response, other.last_response);
+    }
+
+    // Постоянное (keep-alive) соединение, через которое последовательно идут запросы одного Worker
+    class Worker::Connection : public std::enable_shared_from_this<Connection> {
+    public:
+        Connection(net::io_context& ioc, Worker& worker)
+            : stream_(ioc)
+            , worker_(worker) {
+        }
+
+        // Соединяемся заранее, чтобы установка соединения не попадала в замер
+        void Open() {
+            sys::error_code ec;
+            net::connect(stream_.socket(), worker_.endpoints_, ec);
+            if (!ec) {
+                OnConnected();
+            }
+        }
+
+        void Send(Shot shot, Scenario::Request&& request) {
+            shot_ = shot;
+            request_ = std::move(request);
+            sent_time_ = Clock::now();
+
+            // Сервер мог закрыть простаивавшее соединение, тогда один раз переподключаемся и повторяем
+            can_retry_ = is_connected_;
+            is_idempotent_ = request_.method() == http::verb::get || request_.method() == http::verb::head;
+
+            if (is_connected_) {
+                Write();
+            }
+            else {
+                Connect();
+            }
+        }
+
+        void Close() {
+            sys::error_code ec;
+            stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+            stream_.close();
+            buffer_.clear();
+            is_connected_ = false;
+        }
+    private:
+        void Connect() {
+            stream_.expires_after(worker_.options_.timeout);
+            stream_.async_connect(worker_.endpoints_,
+                beast::bind_front_handler(&Connection::OnConnect, shared_from_this()));
+        }
+
+        void OnConnect(beast::error_code ec, const tcp::endpoint&) {
+            if (ec) {
+                return Fail(false);
+            }
+            OnConnected();
+            Write();
+        }
+
+        void OnConnected() {
+            is_connected_ = true;
+            stream_.socket().set_option(tcp::no_delay(true));
+            ++worker_.report_.connects;
+        }
+
+        void Write() {
+            stream_.expires_after(worker_.options_.timeout);
+            http::async_write(stream_, request_,
+                beast::bind_front_handler(&Connection::OnWrite, shared_from_this()));
+        }
+
+        void OnWrite(beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+            if (ec) {
+                return Fail(true);
+            }
+
+            response_ = {};
+            stream_.expires_after(worker_.options_.timeout);
+            http::async_read(stream_, buffer_, response_,
+                beast::bind_front_handler(&Connection::OnRead, shared_from_this()));
+        }
+
+        void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
+            if (ec) {
+                // Запрос уже ушёл и мог быть выполнен: повторный POST (join, action) исказил бы счётчики прогона
+                return Fail(is_idempotent_);
+            }
+
+            if (!response_.keep_alive()) {
+                Close();
+            }
+
+            worker_.OnComplete(*this, shot_, sent_time_, true, response_.result_int());
+        }
+
+        // may_retry - повтор не приведёт к двойному выполнению запроса на сервере
+        void Fail(bool may_retry) {
+            Close();
+
+            if (may_retry && can_retry_ && !worker_.is_draining_) {
+                can_retry_ = false;
+                return Connect();
+            }
+
+            worker_.OnComplete(*this, shot_, sent_time_, false, 0);
+        }
+
+        beast::tcp_stream stream_;
+        beast::flat_buffer buffer_;
+        Scenario::Request request_;
+        http::response<http::string_body> response_;
+        Worker& worker_;
+
+        Shot shot_{};
+        Clock::time_point sent_time_;
+        bool is_connected_ = false;
+        bool can_retry_ = false;
+        bool is_idempotent_ = false;
+    };
+
+    Worker::Worker(const Options& options, const Scenario& scenario, const std::vector<std::string>& tokens,
+        const tcp::resolver::results_type& endpoints, double rate, unsigned seed)
+        : options_(options)
+        , scenario_(scenario)
+        , tokens_(tokens)
+        , endpoints_(endpoints)
+        , timer_(ioc_)
+        , engine_(seed)
+        , interval_(1.0 / rate)
+        , report_(scenario.GetRequests().size()) {
+        connections_.reserve(options_.connections);
+        for (size_t i = 0; i < options_.connections; ++i) {
+            auto connection = std::make_shared<Connection>(ioc_, *this);
+            connection->Open();
+            idle_connections_.push_back(connection.get());
+            connections_.push_back(std::move(connection));
+        }
+    }
+
+    Worker::~Worker() = default;
+
+    void Worker::Run(Clock::time_point start, Clock::time_point first_shot) {
+        first_shot_ = first_shot;
+        end_time_ = start + options_.duration;
+
+        ScheduleNext();
+        ioc_.run();
+    }
+
+    const WorkerReport& Worker::GetReport() const {
+        return report_;
+    }
+
+    Clock::time_point Worker::ShotTime(uint64_t shot_number) const {
+        return first_shot_ + std::chrono::duration_cast<Clock::duration>(interval_ * static_cast<double>(shot_number));
+    }
+
+    void Worker::ScheduleNext() {
+        auto next = ShotTime(shot_number_);
+
+        if (next < end_time_) {
+            timer_.expires_at(next);
+            timer_.async_wait([this](sys::error_code ec) {
+                if (!ec) {
+                    OnTimer();
+                }
+            });
+            return;
+        }
+
+        is_schedule_done_ = true;
+        if (IsIdle()) {
+            return;
+        }
+
+        // Даём отправленным и ожидающим в очереди запросам завершиться, но не дольше таймаута
+        timer_.expires_at(end_time_ + options_.timeout);
+        timer_.async_wait([this](sys::error_code ec) {
+            if (!ec) {
+                Drain();
+            }
+        });
+    }
+
+    void Worker::OnTimer() {
+        // Таймер мог сработать с опозданием: отправляем все просроченные запросы, не сдвигая расписание
+        auto now = Clock::now();
+        for (auto next = ShotTime(shot_number_); next <= now && next < end_time_; next = ShotTime(++shot_number_)) {
+            ++report_.scheduled;
+            Dispatch(Shot{ next, scenario_.PickRequest(engine_) });
+        }
+
+        ScheduleNext();
+    }
+
+    void Worker::Dispatch(Shot shot) {
+        if (idle_connections_.empty()) {
+            backlog_.push_back(shot);
+            report_.max_backlog = std::max(report_.max_backlog, backlog_.size());
+            return;
+        }
+
+        auto* connection = idle_connections_.back();
+        idle_connections_.pop_back();
+        Send(*connection, shot);
+    }
+
+    void Worker::Send(Connection& connection, Shot shot) {
+        connection.Send(shot, scenario_.MakeRequest(shot.request_index, tokens_, engine_, options_.host));
+    }
+
+    void Worker::OnComplete(Connection& connection, const Shot& shot, Clock::time_point sent_time, bool is_ok, unsigned status) {
+        if (is_ok) {
+            auto now = Clock::now();
+            auto latency = ToMicroseconds(now - shot.intended_time);
+
+            report_.latency.Record(latency);
+            report_.service_time.Record(ToMicroseconds(now - sent_time));
+            report_.latency_by_request[shot.request_index].Record(latency);
+            ++report_.count_by_request[shot.request_index];
+            ++report_.completed;
+            report_.last_response = now;
+
+            if (status < 200 || status >= 300) {
+                ++report_.non_success;
+            }
+        }
+        else {
+            ++report_.failed;
+        }
+
+        if (is_draining_) {
+            return;
+        }
+
+        if (!backlog_.empty()) {
+            auto next = backlog_.front();
+            backlog_.pop_front();
+            return Send(connection, next);
+        }
+
+        idle_connections_.push_back(&connection);
+
+        if (is_schedule_done_ && IsIdle()) {
+            timer_.cancel();
+        }
+    }
+
+    bool Worker::IsIdle() const {
+        return backlog_.empty() && idle_connections_.size() == connections_.size();
+    }
+
+    void Worker::Drain() {
+        is_draining_ = true;
+        report_.unsent += backlog_.size();
+        backlog_.clear();
+
+        for (auto& connection : connections_) {
+            connection->Close();
+        }
+    }
+
+    std::vector<std::string> JoinPlayers(const Options& options, const Scenario& scenario, std::chrono::milliseconds wait_for_server) {
+        net::io_context ioc;
+        tcp::resolver resolver(ioc);
+        beast::tcp_stream stream(ioc);
+        beast::flat_buffer buffer;
+
+        auto connect = [&] {
+            auto deadline = Clock::now() + wait_for_server;
+            while (true) {
+                try {
+                    stream.connect(resolver.resolve(options.host, options.port));
+                    return;
+                }
+                catch (const sys::system_error&) {
+                    if (Clock::now() >= deadline) {
+                        throw;
+                    }
+                    std::this_thread::sleep_for(100ms);
+                }
+            }
+        };
+
+        connect();
+
+        std::vector<std::string> tokens;
+        tokens.reserve(scenario.GetPlayersCount());
+
+        for (size_t i = 0; i < scenario.GetPlayersCount(); ++i) {
+            http::request<http::string_body> request{ http::verb::post, "/api/v1/game/join", 11 };
+            request.set(http::field::host, options.host);
+            request.set(http::field::content_type, "application/json");
+            request.keep_alive(true);
+            request.body() = json::serialize(json::object{
+                {"userName", "loader" + std::to_string(i)},
+                {"mapId", scenario.GetMapId()} });
+            request.prepare_payload();
+
+            http::write(stream, request);
+
+            http::response<http::string_body> response;
+            http::read(stream, buffer, response);
+
+            if (response.result() != http::status::ok) {
+                throw std::runtime_error("Join failed with status " + std::to_string(response.result_int()) + ": " + response.body());
+            }
+
+            tokens.push_back(std::string(json::parse(response.body()).as_object().at("authToken").as_string()));
+
+            if (!response.keep_alive()) {
+                stream.close();
+                connect();
+            }
+        }
+
+        return tokens;
+    }
+
+    WorkerReport RunLoad(const Options& options, const Scenario& scenario, const std::vector<std::string>& tokens, size_t threads) {
+        threads = std::max<size_t>(threads, 1);
+
+        net::io_context ioc;
+        tcp::resolver resolver(ioc);
+        auto endpoints = resolver.resolve(options.host, options.port);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.push_back(std::make_unique<Worker>(options, scenario, tokens, endpoints,
+                options.rate / threads, options.seed + static_cast<unsigned>(i)));
+        }
+
+        auto start = Clock::now();
+        auto interval = std::chrono::duration<double>(1.0 / options.rate);
+
+        {
+            std::vector<std::jthread> runners;
+            for (size_t i = 0; i < threads; ++i) {
+                // Сдвигаем расписания потоков, чтобы суммарно запросы шли равномерно
+                auto first_shot = start + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(i));
+                runners.emplace_back([&worker = *workers[i], start, first_shot] {
+                    worker.Run(start, first_shot);
+                });
+            }
+        }
+
+        WorkerReport report(scenario.GetRequests().size());
+        report.start = start;
+        for (const auto& worker : workers) {
+            report.Merge(worker->GetReport());
+        }
+        return report;
+    }
+} // namespace load_generator
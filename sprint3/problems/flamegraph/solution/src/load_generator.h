@@ -0,0 +1,134 @@
+#pragma once
+
+#include "histogram.h"
+#include "scenario.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace load_generator {
+    namespace net = boost::asio;
+    using tcp = net::ip::tcp;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string host;
+        std::string port;
+        // Целевая интенсивность, запросов в секунду суммарно по всем потокам
+        double rate = 100;
+        std::chrono::milliseconds duration{ 10000 };
+        // Постоянных соединений на поток
+        size_t connections = 16;
+        std::chrono::milliseconds timeout{ 5000 };
+        unsigned seed = 123456789;
+    };
+
+    struct WorkerReport {
+        explicit WorkerReport(size_t request_kinds);
+
+        void Merge(const WorkerReport& other);
+
+        // От запланированного момента отправки до получения ответа: включает ожидание свободного соединения
+        LatencyHistogram latency;
+        // От фактической отправки до получения ответа: то, что намерил бы закрытый цикл
+        LatencyHistogram service_time;
+        std::vector<LatencyHistogram> latency_by_request;
+        std::vector<uint64_t> count_by_request;
+
+        uint64_t scheduled = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;
+        uint64_t non_success = 0;
+        // Запланированы, но не были отправлены до окончания прогона
+        uint64_t unsent = 0;
+        // Установленных TCP-соединений, включая повторные после разрыва
+        uint64_t connects = 0;
+        size_t max_backlog = 0;
+        // Начало расписания: после того как все соединения установлены
+        Clock::time_point start;
+        Clock::time_point last_response;
+    };
+
+    /*
+     * Открытая модель нагрузки: запросы планируются строго по расписанию start + n / rate,
+     * независимо от того, успел ли сервер ответить на предыдущие. Если все соединения заняты,
+     * запрос ждёт в очереди, а задержка считается от запланированного момента, поэтому
+     * медленный сервер не "притормаживает" генератор и не прячет хвост распределения
+     * (coordinated omission).
+     * Каждый Worker владеет своим io_context и выполняется в одном потоке, поэтому синхронизация не нужна.
+     */
+    class Worker {
+    public:
+        Worker(const Options& options, const Scenario& scenario, const std::vector<std::string>& tokens,
+            const tcp::resolver::results_type& endpoints, double rate, unsigned seed);
+
+        ~Worker();
+
+        Worker(const Worker&) = delete;
+        Worker& operator=(const Worker&) = delete;
+
+        // Блокирует поток до окончания прогона и завершения отправленных запросов
+        void Run(Clock::time_point start, Clock::time_point first_shot);
+
+        const WorkerReport& GetReport() const;
+    private:
+        class Connection;
+
+        struct Shot {
+            Clock::time_point intended_time;
+            size_t request_index;
+        };
+
+        void ScheduleNext();
+
+        void OnTimer();
+
+        void Dispatch(Shot shot);
+
+        void Send(Connection& connection, Shot shot);
+
+        void OnComplete(Connection& connection, const Shot& shot, Clock::time_point sent_time, bool is_ok, unsigned status);
+
+        Clock::time_point ShotTime(uint64_t shot_number) const;
+
+        bool IsIdle() const;
+
+        void Drain();
+
+        const Options& options_;
+        const Scenario& scenario_;
+        const std::vector<std::string>& tokens_;
+        const tcp::resolver::results_type& endpoints_;
+
+        net::io_context ioc_;
+        net::steady_timer timer_;
+        std::mt19937 engine_;
+
+        std::chrono::duration<double> interval_;
+        Clock::time_point first_shot_;
+        Clock::time_point end_time_;
+        uint64_t shot_number_ = 0;
+        bool is_schedule_done_ = false;
+        bool is_draining_ = false;
+
+        std::vector<std::shared_ptr<Connection>> connections_;
+        std::vector<Connection*> idle_connections_;
+        std::deque<Shot> backlog_;
+
+        WorkerReport report_;
+    };
+
+    // Синхронно подключает игроков сценария и возвращает их токены.
+    // Повторяет попытки соединения, пока сервер не начнёт принимать подключения или не истечёт wait_for_server
+    std::vector<std::string> JoinPlayers(const Options& options, const Scenario& scenario, std::chrono::milliseconds wait_for_server);
+
+    WorkerReport RunLoad(const Options& options, const Scenario& scenario, const std::vector<std::string>& tokens, size_t threads);
+} // namespace load_generator
@@ -0,0 +1,145 @@
+#include "load_generator.h"
+
+#include <boost/program_options.hpp>
+#include <boost/json/src.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+
+using namespace std::literals;
+
+struct Args {
+    load_generator::Options options;
+    std::string scenario_file;
+    size_t threads = 1;
+    std::chrono::milliseconds wait_for_server{ 0 };
+    std::string hgrm_file;
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{ "Allowed options" };
+    Args args;
+    double duration_seconds = 10;
+    int timeout_ms = 5000;
+    int wait_for_server_ms = 0;
+
+    desc.add_options()
+        ("help,h", "produce help message")
+        ("scenario,s", po::value(&args.scenario_file)->value_name("file"), "set scenario file path")
+        ("host", po::value(&args.options.host)->default_value("127.0.0.1"), "server host")
+        ("port,p", po::value(&args.options.port)->default_value("8080"), "server port")
+        ("rate,r", po::value(&args.options.rate)->value_name("requests")->default_value(100), "target requests per second")
+        ("duration,d", po::value(&duration_seconds)->value_name("seconds")->default_value(10), "measurement duration")
+        ("connections,c", po::value(&args.options.connections)->default_value(16), "keep-alive connections per thread")
+        ("threads,t", po::value(&args.threads)->default_value(1), "generator threads, each with its own connections")
+        ("timeout", po::value(&timeout_ms)->value_name("milliseconds")->default_value(5000), "request timeout")
+        ("seed", po::value(&args.options.seed)->default_value(123456789), "random seed")
+        ("wait-for-server", po::value(&wait_for_server_ms)->value_name("milliseconds")->default_value(0), "retry connecting while the server starts")
+        ("hgrm-file", po::value(&args.hgrm_file)->value_name("file"), "write latency percentile distribution in HdrHistogram format");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    if (args.scenario_file.empty()) {
+        std::cerr << "Scenario file not specified.\n";
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    if (args.options.rate <= 0 || duration_seconds <= 0 || args.options.connections == 0 || args.threads == 0) {
+        std::cerr << "Rate, duration, connections and threads must be positive.\n";
+        return std::nullopt;
+    }
+
+    args.options.duration = std::chrono::milliseconds(static_cast<int64_t>(duration_seconds * 1000));
+    args.options.timeout = std::chrono::milliseconds(timeout_ms);
+    args.wait_for_server = std::chrono::milliseconds(wait_for_server_ms);
+
+    return args;
+}
+
+void PrintLatency(std::ostream& output, std::string_view title, const load_generator::LatencyHistogram& histogram) {
+    constexpr double MS = 1000.0;
+
+    output << title << ", ms:\n" << std::fixed << std::setprecision(3)
+        << "  min " << histogram.GetMin() / MS
+        << "  p50 " << histogram.ValueAtPercentile(50) / MS
+        << "  p90 " << histogram.ValueAtPercentile(90) / MS
+        << "  p99 " << histogram.ValueAtPercentile(99) / MS
+        << "  p99.9 " << histogram.ValueAtPercentile(99.9) / MS
+        << "  p99.99 " << histogram.ValueAtPercentile(99.99) / MS
+        << "  max " << histogram.GetMax() / MS
+        << "  mean " << histogram.GetMean() / MS << "\n"
+        << std::defaultfloat;
+}
+
+void PrintReport(std::ostream& output, const Args& args, const load_generator::Scenario& scenario,
+    const load_generator::WorkerReport& report, std::chrono::duration<double> elapsed) {
+    double throughput = elapsed.count() > 0 ? report.completed / elapsed.count() : 0.0;
+
+    output << "Requests: scheduled " << report.scheduled
+        << ", completed " << report.completed
+        << ", non-2xx " << report.non_success
+        << ", failed " << report.failed
+        << ", unsent " << report.unsent << "\n"
+        << "Throughput: " << std::fixed << std::setprecision(1) << throughput
+        << " req/s (target " << args.options.rate << " req/s)\n" << std::defaultfloat
+        << "Connections: " << args.threads * args.options.connections
+        << " (" << report.connects << " connects), max backlog " << report.max_backlog << "\n";
+
+    PrintLatency(output, "Latency from intended send time", report.latency);
+    PrintLatency(output, "Service time from actual send", report.service_time);
+
+    output << "By request:\n";
+    const auto& requests = scenario.GetRequests();
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& histogram = report.latency_by_request[i];
+        output << "  " << std::left << std::setw(32) << requests[i].GetName() << std::right
+            << " count " << std::setw(8) << report.count_by_request[i] << std::fixed << std::setprecision(3)
+            << "  p50 " << histogram.ValueAtPercentile(50) / 1000.0
+            << "  p99 " << histogram.ValueAtPercentile(99) / 1000.0
+            << "  max " << histogram.GetMax() / 1000.0 << " ms\n" << std::defaultfloat;
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+
+        if (!args) {
+            return EXIT_FAILURE;
+        }
+
+        auto scenario = load_generator::Scenario::Load(args->scenario_file);
+        auto tokens = load_generator::JoinPlayers(args->options, scenario, args->wait_for_server);
+
+        std::cout << "Joined " << tokens.size() << " players, shooting at " << args->options.rate << " req/s for "
+            << args->options.duration.count() / 1000.0 << " s" << std::endl;
+
+        auto report = load_generator::RunLoad(args->options, scenario, tokens, args->threads);
+        std::chrono::duration<double> elapsed = std::max(report.last_response, report.start) - report.start;
+
+        PrintReport(std::cout, *args, scenario, report, elapsed);
+
+        if (!args->hgrm_file.empty()) {
+            std::ofstream hgrm(args->hgrm_file);
+            report.latency.PrintPercentileDistribution(hgrm, 1000.0);
+        }
+
+        return report.failed == 0 && report.unsent == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,170 @@
+#include "scenario.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace load_generator {
+    using namespace std::literals;
+
+    namespace {
+        std::runtime_error ScenarioError(size_t line_number, const std::string& message) {
+            return std::runtime_error("Scenario line " + std::to_string(line_number) + ": " + message);
+        }
+
+        bool NeedsToken(RequestKind kind) {
+            return kind != RequestKind::GET;
+        }
+    }
+
+    std::string ScenarioRequest::GetName() const {
+        switch (kind) {
+        case RequestKind::MOVE:
+            return "move";
+        case RequestKind::STATE:
+            return "state";
+        case RequestKind::PLAYERS:
+            return "players";
+        case RequestKind::GET:
+            return "get " + target;
+        }
+        return {};
+    }
+
+    Scenario Scenario::Load(const std::filesystem::path& path) {
+        std::ifstream input(path);
+        if (!input) {
+            throw std::runtime_error("Could not open scenario file: " + path.string());
+        }
+
+        Scenario scenario;
+        std::string line;
+        size_t line_number = 0;
+
+        while (std::getline(input, line)) {
+            ++line_number;
+
+            if (auto comment = line.find('#'); comment != std::string::npos) {
+                line.erase(comment);
+            }
+
+            std::istringstream words(line);
+            std::string command;
+            if (!(words >> command)) {
+                continue;
+            }
+
+            if (command == "join") {
+                if (!(words >> scenario.players_count_ >> scenario.map_id_) || scenario.players_count_ == 0) {
+                    throw ScenarioError(line_number, "expected 'join <count> <map id>'");
+                }
+            }
+            else if (command == "request") {
+                ScenarioRequest request;
+                std::string kind;
+                if (!(words >> request.weight >> kind) || request.weight <= 0) {
+                    throw ScenarioError(line_number, "expected 'request <weight> <kind>'");
+                }
+
+                if (kind == "move") {
+                    request.kind = RequestKind::MOVE;
+                }
+                else if (kind == "state") {
+                    request.kind = RequestKind::STATE;
+                }
+                else if (kind == "players") {
+                    request.kind = RequestKind::PLAYERS;
+                }
+                else if (kind == "get") {
+                    request.kind = RequestKind::GET;
+                    if (!(words >> request.target) || !request.target.starts_with('/')) {
+                        throw ScenarioError(line_number, "expected 'request <weight> get /<target>'");
+                    }
+                }
+                else {
+                    throw ScenarioError(line_number, "unknown request kind '" + kind + "'");
+                }
+
+                double total_weight = scenario.cumulative_weights_.empty() ? 0.0 : scenario.cumulative_weights_.back();
+                scenario.cumulative_weights_.push_back(total_weight + request.weight);
+                scenario.requests_.push_back(std::move(request));
+            }
+            else {
+                throw ScenarioError(line_number, "unknown command '" + command + "'");
+            }
+        }
+
+        if (scenario.requests_.empty()) {
+            throw std::runtime_error("Scenario has no requests");
+        }
+
+        for (const auto& request : scenario.requests_) {
+            if (NeedsToken(request.kind) && scenario.players_count_ == 0) {
+                throw std::runtime_error("Scenario request '" + request.GetName() + "' needs players, add 'join <count> <map id>'");
+            }
+        }
+
+        return scenario;
+    }
+
+    size_t Scenario::GetPlayersCount() const {
+        return players_count_;
+    }
+
+    const std::string& Scenario::GetMapId() const {
+        return map_id_;
+    }
+
+    const std::vector<ScenarioRequest>& Scenario::GetRequests() const {
+        return requests_;
+    }
+
+    size_t Scenario::PickRequest(std::mt19937& engine) const {
+        std::uniform_real_distribution<double> distribution(0.0, cumulative_weights_.back());
+        auto it = std::upper_bound(cumulative_weights_.begin(), cumulative_weights_.end(), distribution(engine));
+        return std::min(static_cast<size_t>(it - cumulative_weights_.begin()), requests_.size() - 1);
+    }
+
+    Scenario::Request Scenario::MakeRequest(size_t index, const std::vector<std::string>& tokens, std::mt19937& engine, const std::string& host) const {
+        static constexpr std::string_view MOVES[] = { "U"sv, "D"sv, "L"sv, "R"sv, ""sv };
+
+        const auto& scenario_request = requests_.at(index);
+
+        Request request;
+        request.version(11);
+        request.keep_alive(true);
+        request.set(http::field::host, host);
+
+        if (NeedsToken(scenario_request.kind)) {
+            std::uniform_int_distribution<size_t> token_distribution(0, tokens.size() - 1);
+            request.set(http::field::authorization, "Bearer " + tokens[token_distribution(engine)]);
+        }
+
+        switch (scenario_request.kind) {
+        case RequestKind::MOVE: {
+            std::uniform_int_distribution<size_t> move_distribution(0, std::size(MOVES) - 1);
+            request.method(http::verb::post);
+            request.target("/api/v1/game/player/action");
+            request.set(http::field::content_type, "application/json");
+            request.body() = "{\"move\":\""s + std::string(MOVES[move_distribution(engine)]) + "\"}";
+            break;
+        }
+        case RequestKind::STATE:
+            request.method(http::verb::get);
+            request.target("/api/v1/game/state");
+            break;
+        case RequestKind::PLAYERS:
+            request.method(http::verb::get);
+            request.target("/api/v1/game/players");
+            break;
+        case RequestKind::GET:
+            request.method(http::verb::get);
+            request.target(scenario_request.target);
+            break;
+        }
+
+        request.prepare_payload();
+        return request;
+    }
+} // namespace load_generator
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace load_generator {
+    namespace http = boost::beast::http;
+
+    enum class RequestKind {
+        MOVE, STATE, PLAYERS, GET
+    };
+
+    struct ScenarioRequest {
+        RequestKind kind;
+        double weight;
+        // Для GET - адрес ресурса, для остальных не используется
+        std::string target;
+
+        std::string GetName() const;
+    };
+
+    /*
+     * Сценарий нагрузки, по одной команде на строку, '#' - комментарий:
+     *   join <count> <map id>         - до начала замера подключить count игроков к карте
+     *   request <weight> move         - POST /api/v1/game/player/action со случайным направлением
+     *   request <weight> state        - GET /api/v1/game/state
+     *   request <weight> players      - GET /api/v1/game/players
+     *   request <weight> get <target> - GET произвольного адреса
+     * Запросы выбираются случайно пропорционально весу, токен - случайный из подключённых игроков.
+     */
+    class Scenario {
+    public:
+        using Request = http::request<http::string_body>;
+
+        // Бросает std::runtime_error с номером строки при ошибке в сценарии
+        static Scenario Load(const std::filesystem::path& path);
+
+        size_t GetPlayersCount() const;
+
+        const std::string& GetMapId() const;
+
+        const std::vector<ScenarioRequest>& GetRequests() const;
+
+        size_t PickRequest(std::mt19937& engine) const;
+
+        Request MakeRequest(size_t index, const std::vector<std::string>& tokens, std::mt19937& engine, const std::string& host) const;
+    private:
+        size_t players_count_ = 0;
+        std::string map_id_;
+        std::vector<ScenarioRequest> requests_;
+        // Накопленные веса для выбора запроса бинарным поиском
+        std::vector<double> cumulative_weights_;
+    };
+} // namespace load_generator
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/histogram.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using load_generator::LatencyHistogram;
+
+TEST_CASE("Precision is checked before buckets are laid out") {
+    CHECK_THROWS_AS(LatencyHistogram(0), std::invalid_argument);
+    CHECK_THROWS_AS(LatencyHistogram(1), std::invalid_argument);
+    CHECK_THROWS_AS(LatencyHistogram(17), std::invalid_argument);
+    CHECK_THROWS_AS(LatencyHistogram(-5), std::invalid_argument);
+    CHECK_NOTHROW(LatencyHistogram(2));
+    CHECK_NOTHROW(LatencyHistogram(16));
+}
+
+TEST_CASE("Small values are stored exactly") {
+    LatencyHistogram histogram(4);
+    for (uint64_t value = 0; value < 16; ++value) {
+        histogram.Record(value);
+    }
+
+    CHECK(histogram.GetCount() == 16);
+    CHECK(histogram.GetMin() == 0);
+    CHECK(histogram.GetMax() == 15);
+    CHECK(histogram.ValueAtPercentile(50) == 7);
+    CHECK(histogram.ValueAtPercentile(100) == 15);
+}
+
+TEST_CASE("Large values keep the relative precision") {
+    LatencyHistogram histogram(8);
+    histogram.Record(1'000'000);
+    histogram.Record(2'000'000);
+
+    // Ответ - верхняя граница ячейки: не меньше записанного и больше не более чем на 2^-7
+    auto value = histogram.ValueAtPercentile(50);
+    CHECK(value >= 1'000'000);
+    CHECK(value <= 1'000'000 + 1'000'000 / 128);
+
+    histogram.Record(UINT64_MAX);
+    CHECK(histogram.ValueAtPercentile(100) == UINT64_MAX);
+}
+
+TEST_CASE("Percentiles of a uniform distribution") {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 10'000; ++value) {
+        histogram.Record(value);
+    }
+
+    auto near = [](uint64_t actual, uint64_t expected) {
+        return actual >= expected && actual <= expected + expected / 128;
+    };
+    CHECK(near(histogram.ValueAtPercentile(50), 5'000));
+    CHECK(near(histogram.ValueAtPercentile(90), 9'000));
+    CHECK(near(histogram.ValueAtPercentile(99), 9'900));
+    CHECK(histogram.ValueAtPercentile(100) == 10'000);
+    CHECK(histogram.GetMean() == 5'000.5);
+}
+
+TEST_CASE("Merged histograms add up") {
+    LatencyHistogram lhs, rhs;
+    lhs.Record(10);
+    rhs.Record(1'000);
+    rhs.Record(1'000);
+    lhs.Merge(rhs);
+
+    CHECK(lhs.GetCount() == 3);
+    CHECK(lhs.GetMin() == 10);
+    CHECK(lhs.GetMax() == 1'000);
+    CHECK(lhs.ValueAtPercentile(33) == 10);
+    CHECK_THROWS_AS(lhs.Merge(LatencyHistogram(4)), std::invalid_argument);
+
+    std::ostringstream hgrm;
+    lhs.PrintPercentileDistribution(hgrm, 1.0);
+    CHECK(hgrm.str().find("Total count    =            3") != std::string::npos);
+}
@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "arena.h"
+
+Arena::Arena (size_t n_blocksize)
+{
+	blocksize = n_blocksize;
+	current = NULL;
+	total = 0;
+}
+
+Arena::~Arena ()
+{
+	while (current != NULL)
+	{
+		ArenaBlock * next = current->next;
+		free (current);
+		current = next;
+	}
+}
+
+ArenaBlock * Arena::newBlock (size_t min_size)
+{
+	size_t size = blocksize;
+	if (size < min_size + sizeof(ArenaBlock) + alignof(max_align_t))
+		size = min_size + sizeof(ArenaBlock) + alignof(max_align_t);
+
+	ArenaBlock * block = (ArenaBlock *) malloc (size);
+	if (block == NULL)
+	{
+		perror("Out of memory");
+		exit(1);
+	}
+	block->next = current;
+	block->size = size;
+	block->used = sizeof(ArenaBlock);
+	current = block;
+	total += size;
+	return block;
+}
+
+void * Arena::alloc (size_t size, size_t align)
+{
+	ArenaBlock * block = current;
+	size_t offset = 0;
+
+	if (block != NULL)
+	{
+		uintptr_t base = (uintptr_t) block;
+		offset = ((base + block->used + align - 1) & ~(uintptr_t)(align - 1)) - base;
+	}
+	if ((block == NULL) || (offset + size > block->size))
+	{
+		block = newBlock (size + align);
+		uintptr_t base = (uintptr_t) block;
+		offset = ((base + block->used + align - 1) & ~(uintptr_t)(align - 1)) - base;
+	}
+
+	block->used = offset + size;
+	return (char *) block + offset;
+}
+
+char * Arena::strdup (const char * str, size_t length)
+{
+	char * retval = (char *) alloc (length + 1, 1);
+	memcpy (retval, str, length);
+	retval[length] = '\0';
+	return retval;
+}
+
+void Arena::adopt (Arena * other)
+{
+	if (other->current == NULL)
+		return;
+
+	/* other's blocks go behind ours, so our current block stays in use */
+	ArenaBlock * last = other->current;
+	while (last->next != NULL)
+		last = last->next;
+
+	if (current == NULL)
+	{
+		current = other->current;
+	}
+	else
+	{
+		last->next = current->next;
+		current->next = other->current;
+	}
+	total += other->total;
+	other->current = NULL;
+	other->total = 0;
+}
+
+void Arena::reset ()
+{
+	if (current == NULL)
+		return;
+
+	ArenaBlock * block = current->next;
+	while (block != NULL)
+	{
+		ArenaBlock * next = block->next;
+		free (block);
+		block = next;
+	}
+	current->next = NULL;
+	current->used = sizeof(ArenaBlock);
+	total = current->size;
+}
+
+void * Arena::grow (void * old, size_t old_size, size_t new_size, size_t align)
+{
+	void * retval = alloc (new_size, align);
+	if (old != NULL)
+		memcpy (retval, old, old_size);
+	return retval;
+}
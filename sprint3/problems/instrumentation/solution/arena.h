@@ -0,0 +1,59 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCKSIZE (1 << 20)
+
+struct ArenaBlock
+{
+	ArenaBlock * next;
+	size_t size;
+	size_t used;
+};
+
+/*
+ * Bump allocator: memory is handed out from big blocks and only
+ * released all at once, when the arena is destroyed. Used for
+ * everything that lives until the dot file is written (nodes,
+ * names, graphs, edges), so there is no malloc per event.
+ */
+class Arena
+{
+public:
+	Arena (size_t n_blocksize = ARENA_BLOCKSIZE);
+	~Arena ();
+
+	void * alloc (size_t size, size_t align = alignof(max_align_t));
+	char * strdup (const char * str, size_t length);
+
+	/* 
+	 * grows an array allocated from this arena; the old copy is not
+	 * reused, so growing by doubling wastes at most the final size
+	 */
+	void * grow (void * old, size_t old_size, size_t new_size, size_t align = alignof(max_align_t));
+
+	/* takes over all memory of other, which is left empty */
+	void adopt (Arena * other);
+
+	/*
+	 * releases everything allocated so far; the newest block is kept
+	 * for reuse, so an arena reset after every session stays at the
+	 * size of the biggest session
+	 */
+	void reset ();
+
+	size_t allocated () { return total; }
+
+private:
+	ArenaBlock * newBlock (size_t min_size);
+
+	ArenaBlock * current;
+	size_t blocksize;
+	size_t total;
+
+	Arena (const Arena &);
+	Arena & operator= (const Arena &);
+};
+
+#endif
@@ -1,64 +1,102 @@
 #include <assert.h>
+#include <string.h>
+#include <stdarg.h>
+#include <queue>
+#include <vector>
+#include <functional>
 #include "graph.h"
 
 #define BUFSIZE 100
+#define WRITERSIZE (1 << 16)
 #undef DEBUG
 
-/* a pointer to this struct * is passed on to FindTreshold while walking */
-struct findtreshold_arg
+/*
+ * Collects the output in a big buffer and hands it to dest in few large
+ * fwrite calls, instead of a formatted stdio call per line.
+ */
+class DotWriter
 {
-        int n_edges;
-        int current_treshold;
-};
-
-void CountEdges (void * content, void * arg)
-{
-        findtreshold_arg * args = (findtreshold_arg *) arg;
-        // TODO wat als edge->next != null? Juist!
-        AnnotatedEdge * current = (AnnotatedEdge *)content;
-        while (current != NULL)
-        {
-                if (current->n_taken > args->current_treshold)
-                        args->n_edges++;
-                current = current->next;
-        }
-}
+public:
+	DotWriter (FILE * n_dest)
+	{
+		dest = n_dest;
+		used = 0;
+	}
+	~DotWriter ()
+	{
+		flush();
+	}
 
-int FindTreshold(BinaryTree * tree_root, int max_edgecount)
-{
-	static findtreshold_arg * args = (findtreshold_arg*) malloc (sizeof(findtreshold_arg));
-	args->n_edges=-1;
-	args->current_treshold=0;
+	void print (const char * format, ...)
+	{
+		if (used + BUFSIZE * 8 > WRITERSIZE)
+			flush();
+
+		va_list args;
+		va_start(args, format);
+		int length = vsnprintf(buffer + used, WRITERSIZE - used, format, args);
+		va_end(args);
+
+		if (used + length >= WRITERSIZE)
+		{
+			// didn't fit: write out what we have and the long line on its own
+			flush();
+			va_start(args, format);
+			vfprintf(dest, format, args);
+			va_end(args);
+			return;
+		}
+		used += length;
+	}
 
-#ifdef DEBUG
-	fprintf(stderr, "  Finding treshold. max_edgecount: %d\n", max_edgecount);
-#endif
-	
-	while ((args->n_edges > max_edgecount) || (args->n_edges == -1))
+	void flush ()
 	{
-		//AnnotatedEdge * current_edge = start_edge;
-		args->n_edges = 0;
+		fwrite(buffer, 1, used, dest);
+		used = 0;
+	}
+
+private:
+	FILE * dest;
+	size_t used;
+	char buffer[WRITERSIZE];
+};
 
-		tree_root->walk(CountEdges, args);
+/*
+ * The smallest treshold for which at most max_edgecount edges are taken
+ * more often than the treshold. That is the (max_edgecount+1)-th largest
+ * n_taken, found with a min-heap holding the max_edgecount+1 largest ones.
+ */
+int FindTreshold(EdgeHashTbl * edges, int max_edgecount)
+{
+	if (max_edgecount < 0)
+		max_edgecount = 0;
 
 #ifdef DEBUG
-		fprintf(stderr, "  With treshold %d, found %d edges.\n", current_treshold, edges);
+	fprintf(stderr, "  Finding treshold. max_edgecount: %d\n", max_edgecount);
 #endif
 
-		args->current_treshold++;
+	std::priority_queue<int, std::vector<int>, std::greater<int> > largest;
+	for (int i=0; i<edges->count; i++)
+	{
+		int n_taken = edges->edges[i].n_taken;
+		if ((int) largest.size() <= max_edgecount)
+		{
+			largest.push(n_taken);
+		}
+		else if (n_taken > largest.top())
+		{
+			largest.pop();
+			largest.push(n_taken);
+		}
 	}
-	return args->current_treshold-1;
-}
 
-struct printedge_arg
-{
-        int min_edgewidth;
-};
+	if ((int) largest.size() <= max_edgecount)
+		return 0;
+	return largest.top();
+}
 
-void PrintNode (void * content, void * arg)
+void PrintNode (Node * node, DotWriter * dest)
 {
-	Node * node  = (Node *)content;
-	FILE * dest  = (FILE *)arg;
 	char * shape = "ellipse";
 
 	if (!node->used)
@@ -75,57 +113,55 @@ void PrintNode (void * content, void * arg)
 	{
 		shape = "diamond";
 	}
-	fprintf (dest, "\"%s\" [shape=%s];\n",
+	dest->print ("\"%s\" [shape=%s];\n",
 			node->name,
 			shape);
 }
-void PrintEdge (void * content, void * arg)
+
+void PrintEdge (AnnotatedEdge * edge, DotWriter * dest)
 {
-        printedge_arg * args = (printedge_arg*) arg;
-        AnnotatedEdge * current = (AnnotatedEdge *)content;
-
-        while (current != NULL)
-        {
-                if (current->n_taken > args->min_edgewidth)
-                {
-                        printf("\"%s\" -> \"%s\"[label=%d,color=\"0,0,%f\"];\n", 
-                                        current->from->name,
-                                        current->to->name,
-                                        current->n_taken, 
-					1.0-current->n_taken/60.0);
-                         current->from->used = true;
-                         current->to->used = true;
-                }
-                current = current->next;
-        }
+	dest->print("\"%s\" -> \"%s\"[label=%d,color=\"0,0,%f\"];\n", 
+			edge->from->name,
+			edge->to->name,
+			edge->n_taken, 
+			1.0-edge->n_taken/60.0);
+	edge->from->used = true;
+	edge->to->used = true;
 }
 
-
-	
 void GenerateDot (FILE * dest, AnnotatedGraph * g, NodeHashTbl * nodehash, Config * config)
 {
-	fprintf(dest, "digraph site_usage {\n");
-	//fprintf(dest, "concentrate=true\n");
-	fprintf(dest, "size=\"7,10\"\n");
-	fprintf(dest, "page=\"8.5,11\"\n");
-	fprintf(dest, "rotate=90\n");
-	fprintf(dest, "center=\"\";\n");
-	fprintf(dest, "node[width=.25,hight=.375,fontsize=9]\n");
+	DotWriter * writer = new DotWriter (dest);
 
-	printedge_arg * args = (printedge_arg*) malloc (sizeof(printedge_arg));
+	writer->print("digraph site_usage {\n");
+	//writer->print("concentrate=true\n");
+	writer->print("size=\"7,10\"\n");
+	writer->print("page=\"8.5,11\"\n");
+	writer->print("rotate=90\n");
+	writer->print("center=\"\";\n");
+	writer->print("node[width=.25,hight=.375,fontsize=9]\n");
+
+	int min_edgewidth;
 
 	if (config->min_edgewidth < 0)
 	{
-		args->min_edgewidth = FindTreshold(g->edgetree, config->max_edgecount);
-		fprintf(stderr, "  Chose treshold: %d\n", args->min_edgewidth);
+		min_edgewidth = FindTreshold(g->edgetable, config->max_edgecount);
+		fprintf(stderr, "  Chose treshold: %d\n", min_edgewidth);
 	} else {
-		args->min_edgewidth = config->min_edgewidth;
+		min_edgewidth = config->min_edgewidth;
 	}
 
-	g->edgetree->walk (PrintEdge, args);
-	nodehash->walk (PrintNode, dest);
-
-	/* TODO walk nodes */
+	EdgeHashTbl * edges = g->edgetable;
+	for (int i=0; i<edges->count; i++)
+	{
+		if (edges->edges[i].n_taken > min_edgewidth)
+			PrintEdge (&edges->edges[i], writer);
+	}
+	for (int i=0; i<nodehash->count; i++)
+	{
+		PrintNode (nodehash->nodes[i], writer);
+	}
 
-	fprintf(dest, "}\n");
+	writer->print("}\n");
+	delete writer;
 }
@@ -5,82 +5,106 @@
 
 void NodeHashTbl::walk (void (*func)(void *, void*), void* arg)
 {
-	for (int x=0; x<size; x++)
+	for (int x=0; x<count; x++)
 	{
-		if (table[x] != NULL)
-		{
-			table[x]->walk(func, arg);
-		}
+		func (nodes[x], arg);
 	}
 }
 
-void HashNode::walk (void (*func)(void *, void *), void * arg)
+/* FNV-1a: cheap, and unlike a shift-xor hash its low bits are well mixed */
+unsigned int NodeHashTbl::HashString (const char * str, size_t length)
 {
-	func (node, arg);
-	if (next != NULL)
-		next->walk(func, arg);
+        unsigned int retval = 2166136261u;
+        for (size_t i=0; i<length; i++)
+        {
+                retval ^= (unsigned char) str[i];
+                retval *= 16777619u;
+        }
+        return retval;
 }
 
-unsigned int NodeHashTbl::HashString (const char * str)
+NodeHashTbl::NodeHashTbl(int n_size)
 {
-        unsigned int retval = 0;
-        int length = strlen(str);
-
-        unsigned int top5bits = 0xf8000000;
-        unsigned int carry = 0;
-
-        const int kleftmove=5;
-        const int krightmove=27;
-
-        for (int i=0; i<length; i++)
+        size = 16;
+        while (size < n_size)
         {
-                carry = retval & top5bits;
-                carry = carry >> krightmove;
-                retval = retval << kleftmove;
-                retval ^= carry;
-                retval ^= str[i];
+                size *= 2;
         }
-        return retval;
+        count = 0;
+        table = (NodeHashSlot *) calloc (size, sizeof(NodeHashSlot));
+        nodes = (Node **) malloc (sizeof(Node *) * size);
 }
 
-NodeHashTbl::NodeHashTbl(int n_size)
+void NodeHashTbl::grow()
 {
-        size = n_size;
-        table = (HashNode **) malloc (sizeof(HashNode*)*size); 
-        for (int i=0; i<size; i++)
+        NodeHashSlot * old_table = table;
+        int old_size = size;
+
+        size *= 2;
+        table = (NodeHashSlot *) calloc (size, sizeof(NodeHashSlot));
+        for (int i=0; i<old_size; i++)
         {
-                table[i] = NULL;
+                if (old_table[i].node == NULL)
+                        continue;
+                unsigned int slot = old_table[i].hash & (size - 1);
+                while (table[slot].node != NULL)
+                {
+                        slot = (slot + 1) & (size - 1);
+                }
+                table[slot] = old_table[i];
         }
+        free (old_table);
+        nodes = (Node **) realloc (nodes, sizeof(Node *) * size);
 }
 
 void NodeHashTbl::add(char * key, Node * content)
 {
-        //assert (strcmp (key, content->name) == 0);
+        assert (strcmp (key, content->name) == 0);
+
+        if ((count + 1) * 4 > size * 3)
+        {
+                grow();
+        }
 
-        int hkey = HashString (key) % size;
-        table[hkey] = new HashNode(key, content, table[hkey]);
+        unsigned int hash = HashString (key, strlen(key));
+        unsigned int slot = hash & (size - 1);
+        while (table[slot].node != NULL)
+        {
+                slot = (slot + 1) & (size - 1);
+        }
+        table[slot].hash = hash;
+        table[slot].node = content;
+        content->id = count;
+        nodes[count++] = content;
 }
 
 Node * NodeHashTbl::get(char * key)
 {
-        HashNode * current_node = table[HashString (key) % size];
-        while (current_node != NULL)
+        return get(key, strlen(key));
+}
+
+Node * NodeHashTbl::get(const char * key, size_t length)
+{
+        unsigned int hash = HashString (key, length);
+        unsigned int slot = hash & (size - 1);
+        while (table[slot].node != NULL)
         {
-                if (strcmp(current_node->key, key) == 0)
+                Node * node = table[slot].node;
+                if ((table[slot].hash == hash)
+                        && (strncmp(node->name, key, length) == 0)
+                        && (node->name[length] == '\0'))
                 {
-                        //assert (strcmp (key, current_node->node->name) == 0);
-
-                        return current_node->node;
+                        return node;
                 }
-                current_node=current_node->next;
+                slot = (slot + 1) & (size - 1);
         }
         return NULL;
 }
 
-Node * newNode (char * name)
+Node * newNode (Arena * arena, const char * name, size_t length)
 {
-	Node * retval = (Node *) malloc (sizeof(Node));
-	retval->name = strdup(name);
+	Node * retval = (Node *) arena->alloc (sizeof(Node), alignof(Node));
+	retval->name = arena->strdup(name, length);
 	retval->start = 0;
 	retval->end = 0;
 	retval->used = false;
@@ -91,10 +115,12 @@ Node * newNode (char * name)
 void FixName (char * name)
 {
 	// Node names may not end with '\' or '/'
-	while ((name[strlen(name)-1] == '\\')
-		|| (name[strlen(name)-1] == '/'))
+	size_t length = strlen(name);
+	while ((length > 0)
+		&& ((name[length-1] == '\\')
+		|| (name[length-1] == '/')))
 	{
-		name[strlen(name)-1] = '\0';
+		name[--length] = '\0';
 	}
 }
 
@@ -102,27 +128,41 @@ Node * getNode (char * name, NodeHashTbl * nodehash)
 {
         FixName(name);
 
-        Node * retval = nodehash->get(name);
+        return getNode(name, strlen(name), nodehash);
+}
+
+Node * getNode (const char * name, size_t length, NodeHashTbl * nodehash)
+{
+        while ((length > 0)
+                && ((name[length-1] == '\\')
+                || (name[length-1] == '/')))
+        {
+                length--;
+        }
+
+        Node * retval = nodehash->get(name, length);
 
         if (retval == NULL)
         {
-                retval = newNode(name);
-                nodehash->add(strdup(name), retval);
+                retval = newNode(&nodehash->arena, name, length);
+                nodehash->add(retval->name, retval);
         }
 
         return retval;
 }
 
-GraphListNode * newGraphListNode (GraphListNode * next, Node * start)
+GraphListNode * newGraphListNode (Arena * arena, GraphListNode * next, Node * start)
 {
 	assert (start != NULL);
 
-	Graph * new_graph = (Graph *) malloc (sizeof(Graph));
+	Graph * new_graph = (Graph *) arena->alloc (sizeof(Graph), alignof(Graph));
 	new_graph->name = "";
 	new_graph->start = start;
 	new_graph->edges = NULL;
+	new_graph->n_edges = 0;
+	new_graph->max_edges = 0;
 
-	GraphListNode * retval = (GraphListNode *) malloc (sizeof(GraphListNode));
+	GraphListNode * retval = (GraphListNode *) arena->alloc (sizeof(GraphListNode), alignof(GraphListNode));
 	retval->next = next;
 	retval->graph = new_graph;
 
@@ -131,160 +171,121 @@ GraphListNode * newGraphListNode (GraphListNode * next, Node * start)
 	return retval;
 }
 
-/* 
- * merges the strings in order to get a unique key identifying
- * this pair, using which the binary tree will be sorted.
- *
- * would be better to alternate characters from str1 and str2
- * instead of just concatenating the strings 
- */
-int MergeStrings (const char * str1, const char * str2)
-{
-        int retval = 0;
-        while (*str1 != '\0')
-                retval += *str1++;
-        while (*str2 != '\0')
-                retval += *str2++;
-        return retval;
-}
-
-Edge * newEdge (Node * from, Node * to, Edge * next = NULL)
+void addEdge (Arena * arena, Graph * g, Node * from, Node * to)
 {
-	Edge * retval = (Edge *) malloc (sizeof(Edge));
-
 	assert (from->name != NULL);
 	assert (to->name != NULL);
 
-	retval->from = from;
-	retval->to = to;
-	retval->next = next;
-	retval->key = MergeStrings(from->name, to->name);
-
-	return retval;
-}
-
-void addEdge (Graph * g, Node * from, Node * to)
-{
-	Edge * current_edge = g->edges;
-
-	if (current_edge == NULL)
-	{
-		g->edges = newEdge(from, to);
-		return;
-	}
-
-	while (current_edge->next != NULL)
+	if (g->n_edges == g->max_edges)
 	{
-		current_edge = current_edge->next;
+		int max_edges = (g->max_edges == 0) ? 8 : g->max_edges * 2;
+		g->edges = (Edge *) arena->grow (g->edges,
+				sizeof(Edge) * g->n_edges,
+				sizeof(Edge) * max_edges,
+				alignof(Edge));
+		g->max_edges = max_edges;
 	}
 
-	current_edge->next = newEdge(from, to);
-}
-
-AnnotatedEdge * newAnnotatedEdge (Edge * e, AnnotatedEdge * next = NULL)
-{
-	AnnotatedEdge * retval = (AnnotatedEdge *) malloc (sizeof(AnnotatedEdge));
-	retval->from = e->from;
-	retval->to = e->to;
-	retval->next = next;
-	retval->n_taken = 1;
-
-	return retval;
+	Edge * edge = &g->edges[g->n_edges++];
+	edge->from = from;
+	edge->to = to;
 }
 
-// Returns 0 if equal names
-bool CompareNodes (Node * a, Node * b)
+static inline unsigned int HashEdge (Node * from, Node * to)
 {
-	assert (a->name != NULL);
-	assert (b->name != NULL);
-	return strcmp (a->name, b->name);
+        unsigned long long key = ((unsigned long long) (unsigned int) from->id << 32) | (unsigned int) to->id;
+        key *= 0x9E3779B97F4A7C15ull;
+        return (unsigned int) (key >> 32);
 }
 
-// Returns 0 if equal
-bool CompareEdges (Edge * a, AnnotatedEdge * b)
+EdgeHashTbl::EdgeHashTbl(int n_size)
 {
-	return (CompareNodes (a->from, b->from) 
-			|| CompareNodes (a->to, b->to));
+        size = 16;
+        while (size < n_size)
+        {
+                size *= 2;
+        }
+        count = 0;
+        index = (int *) calloc (size, sizeof(int));
+        edges = (AnnotatedEdge *) malloc (sizeof(AnnotatedEdge) * size);
 }
 
-/* 
- * Looks for the AnnotatedEdge in the tree corresponding
- * to the Edge provided 
- */
-AnnotatedEdge * GetEdgeFromTree(BinaryTree * root, Edge * edge)
+void EdgeHashTbl::grow()
 {
-        AnnotatedEdge * temp;
-        if (! (temp = (AnnotatedEdge*)(root->get ((void*)&(edge->key)))))
+        size *= 2;
+        free (index);
+        index = (int *) calloc (size, sizeof(int));
+        for (int i=0; i<count; i++)
         {
-                return NULL;
-        }
-        while (temp != NULL)
-        {
-                if (CompareEdges(edge, temp) == 0)
-                        return temp;
-                temp = temp->next;
+                unsigned int slot = HashEdge (edges[i].from, edges[i].to) & (size - 1);
+                while (index[slot] != 0)
+                {
+                        slot = (slot + 1) & (size - 1);
+                }
+                index[slot] = i + 1;
         }
-        return NULL;
+        edges = (AnnotatedEdge *) realloc (edges, sizeof(AnnotatedEdge) * size);
 }
 
-/*
- * convert an Edge to an AnnotatedEdge and
- * insert it in the tree
- */     
-void InsertEdgeInTree(BinaryTree * tree, Edge * edge)
+AnnotatedEdge * EdgeHashTbl::get(Node * from, Node * to)
 {
-#ifdef DEBUG
-        assert (GetEdgeFromTree(tree, edge) == NULL);
-#endif  
-        void * key = &(edge->key);
-        AnnotatedEdge * list;
-
-        if (list = (AnnotatedEdge*)tree->get(key))
+        unsigned int slot = HashEdge (from, to) & (size - 1);
+        while (index[slot] != 0)
         {
-                list->next = newAnnotatedEdge(edge, list->next);
+                AnnotatedEdge * edge = &edges[index[slot] - 1];
+                if ((edge->from == from) && (edge->to == to))
+                {
+                        return edge;
+                }
+                slot = (slot + 1) & (size - 1);
         }
-        else
+
+        if ((count + 1) * 2 > size)
         {
-                tree->put(key, (void *)newAnnotatedEdge(edge));
+                grow();
+                return get(from, to);
         }
+
+        AnnotatedEdge * edge = &edges[count];
+        edge->from = from;
+        edge->to = to;
+        edge->n_taken = 0;
+        index[slot] = ++count;
+        return edge;
 }
 
 void addAnnotatedEdge(AnnotatedGraph * g, Edge * edge)
 {
-	AnnotatedEdge * this_edge = NULL;
-	AnnotatedEdge * last_edge = NULL;
-	BinaryTree * tree = g->edgetree;
+        g->edgetable->get(edge->from, edge->to)->n_taken++;
+}
 
-        if (this_edge = GetEdgeFromTree(tree, edge))
-        {
-                this_edge->n_taken++;
-        }
-        else
-        {
-                InsertEdgeInTree(tree, edge);
-        }
+AnnotatedGraph * newAnnotatedGraph ()
+{
+	AnnotatedGraph * retval = (AnnotatedGraph *) malloc (sizeof(AnnotatedGraph));
+
+	retval->edgetable = new EdgeHashTbl(1024);
 
+	return retval;
 }
 
-int CompareKey(const void * leftp, const void * rightp)
+void addGraph (AnnotatedGraph * g, Graph * graph)
 {
-        int left  = *(int*)leftp;
-        int right = *(int*)rightp;
-
-        if (left < right)
-                return -1;
-        else if (left > right)
-                return 1;
-        else
-                return 0;
+	graph->start->start++;
+
+	Node * last_node = graph->start;
+
+	for (int i=0; i<graph->n_edges; i++)
+	{
+		last_node = graph->edges[i].to;
+		addAnnotatedEdge(g, &graph->edges[i]);
+	}
+
+	last_node->end++;
 }
 
 AnnotatedGraph * summarize (GraphList g, Config * config)
 {
-	AnnotatedGraph * retval = (AnnotatedGraph *) malloc (sizeof(AnnotatedGraph));
-	int count = 1;
-
-	retval->edgetree = new BinaryTree(CompareKey);
+	AnnotatedGraph * retval = newAnnotatedGraph();
 
 	GraphListNode * current_graphlistnode = g;
 
@@ -292,24 +293,7 @@ AnnotatedGraph * summarize (GraphList g, Config * config)
 	{
 		assert (current_graphlistnode->graph != NULL);
 
-		current_graphlistnode->graph->start->start++;
-
-		Edge * current_edge = current_graphlistnode->graph->edges;
-		Node * last_node = NULL;
-
-		if (current_edge == NULL)
-		{
-			last_node = current_graphlistnode->graph->start;
-		}
-
-		while (current_edge != NULL)
-		{
-			last_node = current_edge->to;
-			addAnnotatedEdge(retval, current_edge);
-			current_edge = current_edge->next;
-		}
-
-		last_node->end++;
+		addGraph(retval, current_graphlistnode->graph);
 
 		current_graphlistnode = current_graphlistnode->next;
 	}
@@ -3,13 +3,14 @@
 
 #include <stdio.h>
 #include "config.h"
-#include "binarytree.h"
+#include "arena.h"
 
 #define N_PAGES 50
 
 struct Node
 {
 	char * name;
+	int id; // order in which the node was added to its NodeHashTbl
 	int start;
 	int end;
 	int used;
@@ -21,22 +22,19 @@ struct NodeListNode
 	NodeListNode * next;
 };
 
-class HashNode
+struct NodeHashSlot
 {
-public:
-        HashNode (char* n_key, Node* n_node, HashNode* n_next)
-        {
-                key = n_key;
-                node = n_node;
-                next = n_next;
-        }
-	void walk (void (*func)(void *, void *), void *);
-
-        char * key;
-        Node * node;
-        HashNode * next;
+	unsigned int hash;
+	Node * node; // NULL if the slot is empty
 };
 
+/*
+ * Open addressing (linear probing) table of nodes, keyed on the node name.
+ * The table doubles when it gets 3/4 full, so lookups stay O(1) however many
+ * distinct pages the log has. Nodes and their names live in the table's arena:
+ * every name is stored once and Node::name is the interned copy.
+ * walk() visits nodes in the order they were added (nodes[id]).
+ */
 class NodeHashTbl
 {
 public:
@@ -44,15 +42,21 @@ public:
         ~NodeHashTbl ()
         {
                 free (table);
+                free (nodes);
         }
 
         void add (char * key, Node * content);
         Node * get (char * key);
-        int size;
-        HashNode ** table;
+        Node * get (const char * key, size_t length);
+        int size;  // number of slots, always a power of two
+        int count; // number of nodes
+        NodeHashSlot * table;
+        Node ** nodes;
+        Arena arena;
 	void walk (void (*func)(void *, void *), void *);
 private:
-        unsigned int HashString (const char * str);
+        unsigned int HashString (const char * str, size_t length);
+        void grow ();
         NodeHashTbl();
         NodeHashTbl(const NodeHashTbl &);
 };
@@ -61,29 +65,55 @@ struct Edge
 {
 	Node * from;
 	Node * to;
-	Edge * next;
-
-	int key;
 };
 
 struct AnnotatedEdge 
 {
 	Node * from;
 	Node * to;
-	AnnotatedEdge * next;
 	int n_taken;
 };
 
+/*
+ * Annotated edges keyed on (from->id, to->id). The edges themselves are kept
+ * in a dense array in order of first occurrence; an open addressing index
+ * maps a key to its position there.
+ */
+class EdgeHashTbl
+{
+public:
+        EdgeHashTbl (int n_size);
+        ~EdgeHashTbl ()
+        {
+                free (index);
+                free (edges);
+        }
+
+        /* returns the edge from -> to, adding it with n_taken 0 if it's new */
+        AnnotatedEdge * get (Node * from, Node * to);
+        int count; // number of edges
+        AnnotatedEdge * edges;
+private:
+        void grow ();
+        int size;    // number of slots in index, always a power of two
+        int * index; // position in edges + 1, 0 if the slot is empty
+        EdgeHashTbl();
+        EdgeHashTbl(const EdgeHashTbl &);
+};
+
+/* the edges of a graph, in the order they were taken */
 struct Graph
 {
 	char * name;
 	Node * start;
 	Edge * edges;
+	int n_edges;
+	int max_edges;
 };
 
 struct AnnotatedGraph 
 {
-	BinaryTree * edgetree;
+	EdgeHashTbl * edgetable;
 };
 
 struct GraphListNode
@@ -102,11 +132,17 @@ typedef struct NodeListNode * NodeList;
 Node * getNode (char * name, NodeHashTbl * nodehash);
 
 /*
- * Creates a GraphListNode with an empty graph
+ * Same, for a name that is not NUL-terminated and must not be modified
+ * (e.g. in a memory-mapped file); trailing '\\' and '/' are skipped.
+ */
+Node * getNode (const char * name, size_t length, NodeHashTbl * nodehash);
+
+/*
+ * Creates a GraphListNode with an empty graph, allocated from arena
  */
-GraphListNode * newGraphListNode (GraphListNode * next, Node * start);
+GraphListNode * newGraphListNode (Arena * arena, GraphListNode * next, Node * start);
 
-void addEdge (Graph * graph, Node * from, Node * to);
+void addEdge (Arena * arena, Graph * graph, Node * from, Node * to);
 
 /*
  * adds an edge to an annotated graph, at the same time
@@ -115,6 +151,14 @@ void addEdge (Graph * graph, Node * from, Node * to);
  */
 void addAnnotatedEdge(AnnotatedGraph * g, Edge * edge);
 
+AnnotatedGraph * newAnnotatedGraph ();
+
+/*
+ * folds one session into the annotated graph: counts its edges and the
+ * nodes it starts and ends at. The graph isn't referenced afterwards.
+ */
+void addGraph (AnnotatedGraph * g, Graph * graph);
+
 AnnotatedGraph * summarize (GraphList g, Config * config);
 
 #endif
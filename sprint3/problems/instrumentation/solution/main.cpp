@@ -2,22 +2,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <thread>
 #include "graph.h"
 #include "readfile.h"
+#include "parallelread.h"
 #include "dotgen.h"
 #include "config.h"
 
 void printUsage()
 {
-	fprintf(stderr, "events2dot <eventsfile>\n");
+	fprintf(stderr, "events2dot [-j threads] [-s] <eventsfile>\n");
+	fprintf(stderr, "  -j threads  parse with this many threads (default: one per core)\n");
+	fprintf(stderr, "  -s          streaming: summarize each session as it ends, in bounded memory\n");
+	fprintf(stderr, "  eventsfile may be gzip-compressed, - reads stdin\n");
 }
 
 int main (int argc, char ** argv)
 {
 	NodeHashTbl * nodehash = new NodeHashTbl (255);
+	Arena * arena = new Arena ();
 	GraphList g;
 
+	// by default, parse with one thread per core; -j 1 uses the plain serial reader
+	int n_threads = std::thread::hardware_concurrency();
+	if (n_threads < 1)
+		n_threads = 1;
+	bool streaming = false;
+	while (argc > 2)
+	{
+		if ((argc > 3) && (strcmp(argv[1], "-j") == 0))
+		{
+			n_threads = atoi(argv[2]);
+			argv += 2;
+			argc -= 2;
+		}
+		else if (strcmp(argv[1], "-s") == 0)
+		{
+			streaming = true;
+			argv++;
+			argc--;
+		}
+		else
+		{
+			break;
+		}
+	}
+
 	if ((argc != 2) 
+		|| (n_threads < 1)
 		|| (strcmp(argv[1], "--help") == 0)
 		|| (strcmp(argv[1], "-help") == 0)
 		|| (strcmp(argv[1], "-?") == 0)
@@ -30,9 +62,22 @@ int main (int argc, char ** argv)
 	Config * config;
 	config = ReadConfig ("pathalizer.conf");
 
-	g = getGraphFromFile(argv[1], nodehash, config);
+	AnnotatedGraph * ag;
+
+	// streaming reads serially: sessions have to be folded in one pass, in file order
+	if (streaming)
+	{
+		ag = summarizeFile(argv[1], nodehash, config);
+	}
+	else
+	{
+		if (n_threads == 1)
+			g = getGraphFromFile(argv[1], nodehash, arena, config);
+		else
+			g = getGraphFromFileParallel(argv[1], nodehash, arena, config, n_threads);
 
-	AnnotatedGraph * ag = summarize(g, config);
+		ag = summarize(g, config);
+	}
 
 	GenerateDot (stdout, ag, nodehash, config);
 
@@ -0,0 +1,289 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "parallelread.h"
+#include "readfile.h"
+
+/* fgets (buffer, BUFSIZE, in) returns at most BUFSIZE-1 chars, longer lines become several records */
+#define RECORDSIZE (BUFSIZE - 1)
+
+/* chunks smaller than this aren't worth a thread */
+#ifndef MIN_CHUNKSIZE
+#define MIN_CHUNKSIZE (1 << 20)
+#endif
+
+struct Field
+{
+	const char * begin;
+	size_t length;
+};
+
+struct ChunkResult
+{
+	NodeHashTbl * nodehash;
+	Arena * arena;
+	GraphListNode * graphs;
+};
+
+static inline bool IsSpace (char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r');
+}
+
+static inline bool SameField (Field a, Field b)
+{
+	return (a.length == b.length) && (memcmp(a.begin, b.begin, a.length) == 0);
+}
+
+/* start of the line after the one p is in, or end */
+static const char * NextLine (const char * p, const char * end)
+{
+	const char * newline = (const char *) memchr (p, '\n', end - p);
+	return newline ? newline + 1 : end;
+}
+
+/* end of the record starting at p, as fgets would read it */
+static const char * RecordEnd (const char * p, const char * end)
+{
+	const char * limit = (end - p > RECORDSIZE) ? p + RECORDSIZE : end;
+	const char * newline = (const char *) memchr (p, '\n', limit - p);
+	return newline ? newline + 1 : limit;
+}
+
+static bool ScanToken (const char ** p, const char * end, Field * field)
+{
+	const char * current = *p;
+	while ((current < end) && IsSpace(*current))
+		current++;
+	const char * begin = current;
+	while ((current < end) && !IsSpace(*current))
+		current++;
+	*p = current;
+	if (current == begin)
+		return false;
+	field->begin = begin;
+	field->length = current - begin;
+	return true;
+}
+
+static bool ScanInt (const char ** p, const char * end)
+{
+	const char * current = *p;
+	while ((current < end) && IsSpace(*current))
+		current++;
+	if ((current < end) && ((*current == '-') || (*current == '+')))
+		current++;
+	const char * digits = current;
+	while ((current < end) && (*current >= '0') && (*current <= '9'))
+		current++;
+	*p = current;
+	return current != digits;
+}
+
+/*
+ * Hand-written equivalent of sscanf(record, "%s\t%d\t%s\n", session, &timestamp, name):
+ * fields that can't be read keep their previous value, like the buffers of the serial
+ * reader do. Returns the number of fields read, -1 if there was none.
+ */
+static int ScanRecord (const char * p, const char * end, Field * session, Field * name)
+{
+	if (!ScanToken(&p, end, session))
+		return -1;
+	if (!ScanInt(&p, end))
+		return 1;
+	if (!ScanToken(&p, end, name))
+		return 2;
+	return 3;
+}
+
+/*
+ * A chunk may start at line if it and the line before it are single records with all
+ * fields, and their sessions differ: the serial reader starts a new graph there, and
+ * nothing read before the line matters for what follows.
+ */
+static bool IsSessionBoundary (const char * prev, const char * line, const char * end)
+{
+	Field prev_session, session, name;
+
+	if ((line - prev > RECORDSIZE) || (ScanRecord(prev, line, &prev_session, &name) != 3))
+		return false;
+	if (ScanRecord(line, RecordEnd(line, end), &session, &name) != 3)
+		return false;
+	return !SameField(prev_session, session);
+}
+
+static const char * FindBoundary (const char * from, const char * end)
+{
+	if (from >= end)
+		return end;
+
+	const char * prev = NextLine(from, end);
+	const char * line = NextLine(prev, end);
+	while ((line < end) && !IsSessionBoundary(prev, line, end))
+	{
+		prev = line;
+		line = NextLine(line, end);
+	}
+	return line;
+}
+
+/* the loop of getGraphFromFile, over a chunk of the mapped file */
+static void ParseChunk (const char * begin, const char * end, Config * config, ChunkResult * result)
+{
+	NodeHashTbl * nodehash = result->nodehash;
+	Arena * arena = result->arena;
+	GraphListNode * current_graphlistnode = NULL;
+
+	Field session = { "", 0 };
+	Field name = { "", 0 };
+	Field current_session = { "", 0 };
+	Node * last_node = NULL;
+	Node * current_node = NULL;
+
+	const char * p = begin;
+	while (p < end)
+	{
+		const char * record_end = RecordEnd(p, end);
+		ScanRecord(p, record_end, &session, &name);
+		p = record_end;
+
+		last_node = current_node;
+		current_node = getNode(name.begin, name.length, nodehash);
+
+		if (!SameField(session, current_session))
+		{
+			current_session = session;
+			current_graphlistnode = newGraphListNode(arena, current_graphlistnode, current_node);
+		}
+		else
+		{
+			if ((!config->ignore_refresh) // if false, just add the edge
+					|| (last_node != current_node)) // names are interned
+			{
+				addEdge(arena, current_graphlistnode->graph, last_node, current_node);
+			}
+		}
+	}
+
+	result->graphs = current_graphlistnode;
+}
+
+/*
+ * Moves a chunk's graphs over to the global nodes and arena. Chunks are merged
+ * in file order, so nodes get their ids in order of first appearance, as in the
+ * serial reader. Returns the new head of the list (the last graph read first).
+ */
+static GraphList MergeChunk (ChunkResult * chunk, GraphList merged, NodeHashTbl * nodehash, Arena * arena)
+{
+	NodeHashTbl * local = chunk->nodehash;
+	Node ** global = (Node **) malloc (sizeof(Node *) * (local->count + 1));
+	for (int id=0; id<local->count; id++)
+	{
+		Node * node = local->nodes[id];
+		global[id] = getNode(node->name, strlen(node->name), nodehash);
+	}
+
+	GraphListNode * last = NULL;
+	for (GraphListNode * current = chunk->graphs; current != NULL; current = current->next)
+	{
+		Graph * graph = current->graph;
+		graph->start = global[graph->start->id];
+		for (int i=0; i<graph->n_edges; i++)
+		{
+			graph->edges[i].from = global[graph->edges[i].from->id];
+			graph->edges[i].to = global[graph->edges[i].to->id];
+		}
+		last = current;
+	}
+
+	free (global);
+	arena->adopt (chunk->arena);
+	delete chunk->arena;
+	delete local;
+
+	if (last == NULL)
+		return merged;
+	last->next = merged;
+	return chunk->graphs;
+}
+
+GraphList getGraphFromFileParallel (char * file, NodeHashTbl * nodehash, Arena * arena, Config * config, int n_threads)
+{
+	if (strcmp(file, "-") == 0)
+		return getGraphFromFile (file, nodehash, arena, config);
+
+	int fd = open (file, O_RDONLY);
+	struct stat st;
+	if ((fd < 0) || (fstat(fd, &st) != 0) || !S_ISREG(st.st_mode))
+	{
+		if (fd >= 0)
+			close (fd);
+		return getGraphFromFile (file, nodehash, arena, config);
+	}
+	if (st.st_size == 0)
+	{
+		close (fd);
+		return NULL;
+	}
+
+	size_t size = st.st_size;
+	void * mapping = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+	if (mapping == MAP_FAILED)
+	{
+		return getGraphFromFile (file, nodehash, arena, config);
+	}
+	madvise (mapping, size, MADV_SEQUENTIAL);
+
+	const char * begin = (const char *) mapping;
+	const char * end = begin + size;
+
+	/* gzip magic: only the serial reader can decompress */
+	if ((size >= 2) && ((unsigned char) begin[0] == 0x1f) && ((unsigned char) begin[1] == 0x8b))
+	{
+		munmap (mapping, size);
+		return getGraphFromFile (file, nodehash, arena, config);
+	}
+
+	if ((size_t) n_threads > size / MIN_CHUNKSIZE)
+		n_threads = size / MIN_CHUNKSIZE;
+	if (n_threads < 1)
+		n_threads = 1;
+
+	std::vector<const char *> bounds;
+	bounds.push_back(begin);
+	for (int i=1; i<n_threads; i++)
+	{
+		const char * target = begin + size / n_threads * i;
+		if (target < bounds.back())
+			target = bounds.back();
+		bounds.push_back(FindBoundary(target, end));
+	}
+	bounds.push_back(end);
+
+	std::vector<ChunkResult> chunks (n_threads);
+	std::vector<std::thread> threads;
+	for (int i=0; i<n_threads; i++)
+	{
+		chunks[i].nodehash = new NodeHashTbl (255);
+		chunks[i].arena = new Arena ();
+		chunks[i].graphs = NULL;
+		threads.emplace_back(ParseChunk, bounds[i], bounds[i + 1], config, &chunks[i]);
+	}
+
+	GraphList merged = NULL;
+	for (int i=0; i<n_threads; i++)
+	{
+		threads[i].join();
+		merged = MergeChunk (&chunks[i], merged, nodehash, arena);
+	}
+
+	munmap (mapping, size);
+	return merged;
+}
@@ -0,0 +1,18 @@
+#ifndef PARALLELREAD_H
+#define PARALLELREAD_H
+
+#include "graph.h"
+#include "config.h"
+
+/*
+ * Same result as getGraphFromFile, but the file is memory-mapped, cut into
+ * n_threads chunks at session boundaries and parsed by n_threads threads.
+ * Each thread builds its own nodes and graphs, which are then merged into
+ * nodehash and arena; the merged list equals the one built serially (same
+ * graph order, nodes added in order of first appearance).
+ * Falls back to getGraphFromFile if the file can't be mapped (e.g. stdin)
+ * or is gzip-compressed.
+ */
+GraphList getGraphFromFileParallel (char * file, NodeHashTbl * nodehash, Arena * arena, Config * config, int n_threads);
+
+#endif
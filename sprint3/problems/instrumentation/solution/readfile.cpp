@@ -1,13 +1,18 @@
+#include <unistd.h>
+#include <zlib.h>
 #include "readfile.h"
 
 #undef DEBUG
 
-GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Config * config)
+/* the events file, gzip-compressed or not; "-" is stdin */
+static gzFile OpenEvents (char * file)
 {
-	FILE * in;
-	GraphListNode * current_graphlistnode = NULL;
+	gzFile in;
 
-	in = fopen (file, "r");
+	if (strcmp(file, "-") == 0)
+		in = gzdopen (dup(fileno(stdin)), "rb");
+	else
+		in = gzopen (file, "rb");
 
 	if (in == NULL)
 	{
@@ -18,12 +23,37 @@ GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Config * config
 		exit(0);
 	};
 
+	gzbuffer (in, 1 << 16);
+	return in;
+}
+
+static void CloseEvents (gzFile in, char * file)
+{
+	int errnum;
+	const char * error = gzerror (in, &errnum);
+	if (errnum != Z_OK)
+	{
+		fprintf(stderr, "Error reading file with events ('%s'): %s\n", file, error);
+	}
+	gzclose (in);
+}
+
+/*
+ * Without summary, every session's graph is kept and the list of them returned.
+ * With summary, a session is folded into it as soon as the next one starts and
+ * arena is then reset, so only the current session is held in memory.
+ */
+static GraphList ReadEvents (char * file, NodeHashTbl * nodehash, Arena * arena, Config * config, AnnotatedGraph * summary)
+{
+	gzFile in = OpenEvents (file);
+	GraphListNode * current_graphlistnode = NULL;
+
 	char buffer[BUFSIZE];
 	char session[BUFSIZE];
 	int timestamp;
 	char name[BUFSIZE];
 
-	char * current_session = (char *) malloc (1); // so we can free it
+	char current_session[BUFSIZE] = "";
 	Node * last_node = NULL;
 	Node * current_node = NULL;
 
@@ -32,7 +62,7 @@ GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Config * config
 #endif
 
 	// while (fscanf(in, "%s\t%d\t%s\n", &session, &timestamp, &name) > 0)
-	while (fgets (buffer, BUFSIZE, in))
+	while (gzgets (in, buffer, BUFSIZE))
 	{
 		if (!sscanf(buffer, "%s\t%d\t%s\n", &session, &timestamp, &name))
 			break;
@@ -46,20 +76,50 @@ GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Config * config
 
 		if (strcmp(session, current_session) != 0)
 		{
-			free (current_session);
-			current_session = strdup(session);
+			strcpy (current_session, session);
+			if ((summary != NULL) && (current_graphlistnode != NULL))
+			{
+				addGraph(summary, current_graphlistnode->graph);
+				arena->reset();
+				current_graphlistnode = NULL;
+			}
 			// TODO maybe check for graphs without edges?
-			current_graphlistnode = newGraphListNode(current_graphlistnode, current_node);
+			current_graphlistnode = newGraphListNode(arena, current_graphlistnode, current_node);
 		}
 		else
 		{
 			if ((!config->ignore_refresh) // if false, just add the edge
-					|| (strcmp(last_node->name, current_node->name) != 0))
+					|| (last_node != current_node)) // names are interned
 			{
-				addEdge(current_graphlistnode->graph, last_node, current_node);
+				addEdge(arena, current_graphlistnode->graph, last_node, current_node);
 			}
 		}
 	}
 
+	CloseEvents (in, file);
+
+	if ((summary != NULL) && (current_graphlistnode != NULL))
+	{
+		addGraph(summary, current_graphlistnode->graph);
+		arena->reset();
+		current_graphlistnode = NULL;
+	}
+
 	return current_graphlistnode;
 }
+
+GraphList getGraphFromFile (char * file, NodeHashTbl * nodehash, Arena * arena, Config * config)
+{
+	return ReadEvents (file, nodehash, arena, config, NULL);
+}
+
+AnnotatedGraph * summarizeFile (char * file, NodeHashTbl * nodehash, Config * config)
+{
+	AnnotatedGraph * retval = newAnnotatedGraph();
+	Arena * arena = new Arena ();
+
+	ReadEvents (file, nodehash, arena, config, retval);
+
+	delete arena;
+	return retval;
+}
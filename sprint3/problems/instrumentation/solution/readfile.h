@@ -7,4 +7,17 @@
 
 #define BUFSIZE 255
 
-GraphList getGraphFromFile (char * file, NodeHashTbl * nodelist, Config * config);
+/*
+ * Reads the events file into a list of graphs, one per session. Nodes go to
+ * nodelist, graphs and their edges are allocated from arena.
+ * The file may be gzip-compressed; "-" reads stdin.
+ */
+GraphList getGraphFromFile (char * file, NodeHashTbl * nodelist, Arena * arena, Config * config);
+
+/*
+ * Same as summarize(getGraphFromFile(...)), but each session is summarized
+ * when it ends and then freed: memory depends on the number of distinct
+ * nodes and edges and the longest session, not on the length of the log.
+ * Edges come out in order of first appearance instead of newest session first.
+ */
+AnnotatedGraph * summarizeFile (char * file, NodeHashTbl * nodelist, Config * config);
@@ -1,25 +1,40 @@
 #include "urldecode.h"
 
-#include <charconv>
-#include <stdexcept>
-#include <sstream>
+#include <array>
+#include <cstdint>
 
-std::string UrlDecode(std::string encoded) {
-	std::ostringstream decoded;
-	for (size_t i = 0; i < encoded.length(); ++i) {
-		if (encoded[i] == '%' && i + 2 < encoded.length()) {
-			std::istringstream hex_stream(encoded.substr(i + 1, 2));
-			int hex;
-			hex_stream >> std::hex >> hex;
-			decoded << static_cast<char>(hex);
-			i += 2;
+namespace {
+	// Значение шестнадцатеричной цифры или -1
+	constexpr auto HEX_VALUES = [] {
+		std::array<int8_t, 256> values{};
+		values.fill(-1);
+		for (int i = 0; i < 10; ++i) {
+			values['0' + i] = static_cast<int8_t>(i);
 		}
-		else if (encoded[i] == '+') {
-			decoded << ' ';
+		for (int i = 0; i < 6; ++i) {
+			values['a' + i] = values['A' + i] = static_cast<int8_t>(10 + i);
 		}
-		else {
-			decoded << encoded[i];
+		return values;
+	}();
+}
+
+std::string UrlDecode(std::string encoded) {
+	// Результат не длиннее исходной строки, поэтому раскодируем прямо в ней
+	size_t write = 0;
+	for (size_t read = 0; read < encoded.length(); ++read) {
+		const char c = encoded[read];
+		if (c == '%' && read + 2 < encoded.length()) {
+			const int high = HEX_VALUES[static_cast<unsigned char>(encoded[read + 1])];
+			const int low = HEX_VALUES[static_cast<unsigned char>(encoded[read + 2])];
+			// Неверная последовательность остаётся как есть
+			if (high >= 0 && low >= 0) {
+				encoded[write++] = static_cast<char>(high << 4 | low);
+				read += 2;
+				continue;
+			}
 		}
+		encoded[write++] = c == '+' ? ' ' : c;
 	}
-	return decoded.str();
+	encoded.resize(write);
+	return encoded;
 }
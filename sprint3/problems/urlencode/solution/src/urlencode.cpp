@@ -1,18 +1,36 @@
 #include "urlencode.h"
 
+#include <array>
+
+namespace {
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    // Буквы, цифры и -._~ не кодируются
+    constexpr auto IS_UNRESERVED = [] {
+        std::array<bool, 256> unreserved{};
+        for (int c = 0; c < 256; ++c) {
+            unreserved[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || c == '-' || c == '.' || c == '_' || c == '~';
+        }
+        return unreserved;
+    }();
+}
+
 std::string UrlEncode(std::string_view str) {
-    std::ostringstream encoded;
-    encoded.fill('0');
-    encoded << std::hex;
+    std::string encoded;
+    encoded.reserve(str.size());
 
     for (char c : str) {
-        if (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.' || c == '~') {
-            encoded << c;
+        const auto byte = static_cast<unsigned char>(c);
+        if (IS_UNRESERVED[byte]) {
+            encoded += c;
         }
         else {
-            encoded << '%' << std::setw(2) << static_cast<int>(static_cast<unsigned char>(c));
+            encoded += '%';
+            encoded += HEX_DIGITS[byte >> 4];
+            encoded += HEX_DIGITS[byte & 0xF];
         }
     }
 
-    return encoded.str();
+    return encoded;
 }
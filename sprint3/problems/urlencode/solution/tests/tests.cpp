@@ -8,10 +8,6 @@ TEST(UrlEncodeTestSuite, OrdinaryCharsAreNotEncoded) {
     EXPECT_EQ(UrlEncode("hello"sv), "hello"s);
 }
 
-TEST(UrlEncodeTestSuite, OrdinaryCharsAreNotEncoded) {
-    EXPECT_EQ(UrlEncode("hello"sv), "hello"s);
-}
-
 TEST(UrlEncodeTestSuite, SpaceIsEncoded) {
     EXPECT_EQ(UrlEncode("hello world"sv), "hello%20world"s);
 }
@@ -36,4 +32,13 @@ TEST(UrlEncodeTestSuite, NonAsciiChars) {
     EXPECT_EQ(UrlEncode("こんにちは"sv), "%E3%81%93%E3%82%93%E3%81%AB%E3%81%A1%E3%81%AF"s);
 }
 
+TEST(UrlEncodeTestSuite, EmptyStringIsEmpty) {
+    EXPECT_EQ(UrlEncode(""sv), ""s);
+}
+
+TEST(UrlEncodeTestSuite, ControlAndBoundaryBytesAreEncodedInUpperCase) {
+    EXPECT_EQ(UrlEncode("\x00\x1F\x7F\xFF"sv), "%00%1F%7F%FF"s);
+    EXPECT_EQ(UrlEncode("a\nb"sv), "a%0Ab"s);
+}
+
 /* Напишите остальные тесты самостоятельно */
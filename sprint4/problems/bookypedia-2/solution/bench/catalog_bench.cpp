@@ -0,0 +1,229 @@
+#include <benchmark/benchmark.h>
+
+#include <pqxx/pqxx>
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "../src/postgres/postgres.h"
+
+using namespace std::literals;
+using pqxx::operator"" _zv;
+
+namespace {
+
+// База для замеров очищается перед заполнением, поэтому задаётся отдельно от BOOKYPEDIA_DB_URL
+constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_BENCH_DB_URL"};
+constexpr int MAX_AUTHORS = 1000;
+constexpr int TAGS_PER_BOOK = 3;
+constexpr size_t POOL_SIZE = 16;
+
+std::optional<std::string> GetDbUrl() {
+    if (const auto* url = std::getenv(DB_URL_ENV_NAME)) {
+        return url;
+    }
+    return std::nullopt;
+}
+
+// Каталог из book_count книг с TAGS_PER_BOOK тегами; id детерминированы, чтобы прогоны были сравнимы
+void SeedCatalog(pqxx::connection& connection, int book_count) {
+    const int author_count = std::min(book_count, MAX_AUTHORS);
+
+    pqxx::work work{ connection };
+    work.exec("TRUNCATE book_tags, books, authors"_zv);
+    work.exec_params(R"(
+INSERT INTO authors (id, name)
+SELECT md5('author' || i)::uuid, 'Author ' || i FROM generate_series(1, $1) AS i;
+)"_zv, author_count);
+    work.exec_params(R"(
+INSERT INTO books (id, author_id, title, publication_year)
+SELECT md5('book' || i)::uuid, md5('author' || (i % $2 + 1))::uuid, 'Book ' || i, 1900 + i % 120
+FROM generate_series(1, $1) AS i;
+)"_zv, book_count, author_count);
+    work.exec_params(R"(
+INSERT INTO book_tags (book_id, tag)
+SELECT md5('book' || i)::uuid, 'tag ' || ((i + k) % 50) FROM generate_series(1, $1) AS i, generate_series(1, $2) AS k;
+)"_zv, book_count, TAGS_PER_BOOK);
+    work.commit();
+
+    pqxx::nontransaction{ connection }.exec("ANALYZE"_zv);
+}
+
+// Общая для всех потоков замера база; nullptr, если адрес не задан
+postgres::Database* GetDatabase() {
+    static const auto db = [] {
+        auto url = GetDbUrl();
+        return url ? std::make_unique<postgres::Database>(*url, POOL_SIZE) : nullptr;
+    }();
+    return db.get();
+}
+
+// Потоки одного замера вызывают одновременно: заполняет первый, остальные ждут
+bool PrepareCatalog(benchmark::State& state) {
+    static std::mutex mutex;
+    static int64_t seeded_books = -1;
+
+    auto* db = GetDatabase();
+    if (!db) {
+        state.SkipWithError("BOOKYPEDIA_BENCH_DB_URL is not set");
+        return false;
+    }
+
+    std::lock_guard lock{ mutex };
+    if (seeded_books != state.range(0)) {
+        pqxx::connection connection{ *GetDbUrl() };
+        SeedCatalog(connection, static_cast<int>(state.range(0)));
+        seeded_books = state.range(0);
+    }
+    return true;
+}
+
+domain::AuthorId GetAuthorId(int64_t index) {
+    // Тот же id, что выдаёт md5('author' || i)::uuid при заполнении
+    pqxx::connection connection{ *GetDbUrl() };
+    pqxx::read_transaction read{ connection };
+    auto id = read.exec_params("SELECT md5('author' || $1)::uuid"_zv, index % MAX_AUTHORS + 1)[0][0].as<std::string>();
+    return domain::AuthorId::FromString(id);
+}
+
+std::vector<domain::BookId> GetBookIds(int64_t count) {
+    pqxx::connection connection{ *GetDbUrl() };
+    pqxx::read_transaction read{ connection };
+    std::vector<domain::BookId> ids;
+    for (const auto& row : read.exec_params("SELECT md5('book' || i)::uuid FROM generate_series(1, $1) AS i"_zv, count)) {
+        ids.push_back(domain::BookId::FromString(row[0].as<std::string>()));
+    }
+    return ids;
+}
+
+std::vector<std::string> MakeTags(int64_t count) {
+    std::vector<std::string> tags;
+    for (int64_t i = 0; i < count; ++i) {
+        tags.push_back("tag "s + std::to_string(i));
+    }
+    return tags;
+}
+
+void GetAll(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    for (auto _ : state) {
+        auto books = GetDatabase()->GetBooks().GetAll();
+        benchmark::DoNotOptimize(books);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(GetAll)->Arg(1'000)->Arg(10'000)->Arg(50'000)->Unit(benchmark::kMillisecond);
+
+// Прежняя схема для сравнения: список книг, затем отдельный запрос тегов на каждую
+void GetAllTagQueryPerBook(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    pqxx::connection connection{ *GetDbUrl() };
+    for (auto _ : state) {
+        pqxx::work txn{ connection, "serializable" };
+        auto result = txn.exec(R"(
+SELECT b.id FROM books b JOIN authors a ON b.author_id = a.id ORDER BY b.title, a.name, b.publication_year
+)"_zv);
+
+        size_t tag_count = 0;
+        for (const auto& row : result) {
+            auto tags = txn.exec_params("SELECT tag FROM book_tags WHERE book_id = $1 ORDER BY tag"_zv, row["id"].as<std::string>());
+            tag_count += tags.size();
+        }
+        benchmark::DoNotOptimize(tag_count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(GetAllTagQueryPerBook)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+
+// Короткие чтения из нескольких потоков: пул и подготовленные запросы; ops/s - items_per_second
+void GetAuthorBooks(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    const auto author_id = GetAuthorId(state.thread_index());
+    for (auto _ : state) {
+        auto books = GetDatabase()->GetBooks().GetAuthorBooks(author_id);
+        benchmark::DoNotOptimize(books);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GetAuthorBooks)->Arg(50'000)->ThreadRange(1, 16)->UseRealTime();
+
+// То же, как было до пула: одно соединение, текст запроса на каждый вызов, serializable
+void GetAuthorBooksUnprepared(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    const auto author_id = GetAuthorId(0).ToString();
+    pqxx::connection connection{ *GetDbUrl() };
+    for (auto _ : state) {
+        pqxx::work txn{ connection, "serializable" };
+        auto books = txn.exec_params(
+            "SELECT id, title, author_id, publication_year FROM books WHERE author_id = $1 ORDER BY publication_year, title"_zv, author_id);
+        benchmark::DoNotOptimize(books);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GetAuthorBooksUnprepared)->Arg(50'000)->UseRealTime();
+
+// Правка книги с range(1) тегами - один запрос при любом их числе
+void EditBookManyTags(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    const auto book_id = GetBookIds(1).front();
+    const auto tags = MakeTags(state.range(1));
+    int year = 0;
+    for (auto _ : state) {
+        GetDatabase()->GetBooks().EditBook(book_id, std::nullopt, 1900 + year++ % 120, tags);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(EditBookManyTags)->Args({ 10'000, 1 })->Args({ 10'000, 10 })->Args({ 10'000, 100 })->UseRealTime();
+
+// range(1) правок одной транзакцией через конвейер
+void EditBooksPipeline(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    std::vector<domain::BookEdit> edits;
+    for (auto& book_id : GetBookIds(state.range(1))) {
+        edits.push_back(domain::BookEdit{ std::move(book_id), std::nullopt, 2000, MakeTags(3) });
+    }
+    for (auto _ : state) {
+        GetDatabase()->GetBooks().EditBooks(edits);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(EditBooksPipeline)->Args({ 10'000, 10 })->Args({ 10'000, 100 })->Args({ 10'000, 1'000 })->UseRealTime();
+
+// Поиск книги по названию, как в ShowBook/EditBook: точное совпадение и похожие по триграммам
+void SearchBooks(benchmark::State& state) {
+    if (!PrepareCatalog(state)) {
+        return;
+    }
+
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto books = GetDatabase()->GetBooks().SearchBooks("Book "s + std::to_string(i++ % state.range(0) + 1), 10);
+        benchmark::DoNotOptimize(books);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SearchBooks)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
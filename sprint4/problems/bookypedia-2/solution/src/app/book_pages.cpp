@@ -0,0 +1,30 @@
+#include "book_pages.h"
+
+#include <cassert>
+
+namespace app {
+
+BookPages::BookPages(PageLoader loader, size_t page_size)
+    : loader_{ std::move(loader) }
+    , page_size_{ page_size } {
+    assert(page_size_ != 0);
+}
+
+std::vector<BookListItem> BookPages::NextPage() {
+    if (is_finished_) {
+        return {};
+    }
+
+    auto page = loader_(cursor_, page_size_);
+    // Неполная страница - последняя, лишний запрос за пустой не нужен
+    if (page.size() < page_size_) {
+        is_finished_ = true;
+    }
+    if (!page.empty()) {
+        const auto& [book, author_name] = page.back();
+        cursor_ = domain::BookCursor{ book.GetTitle(), author_name, book.GetPublicationYear(), book.GetBookId() };
+    }
+    return page;
+}
+
+}  // namespace app
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../domain/book.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+// Книга из списка и имя её автора (пустое в списке книг одного автора)
+using BookListItem = std::pair<domain::Book, std::string>;
+
+/*
+ * Список книг, читаемый страницами по page_size: каждая следующая страница запрашивается
+ * от ключа последней выданной книги, так что в памяти не больше одной страницы.
+ */
+class BookPages {
+public:
+    using PageLoader = std::function<std::vector<BookListItem>(const std::optional<domain::BookCursor>& after, size_t limit)>;
+
+    BookPages(PageLoader loader, size_t page_size);
+
+    // Пустая страница - список закончился
+    std::vector<BookListItem> NextPage();
+
+private:
+    PageLoader loader_;
+    size_t page_size_;
+    std::optional<domain::BookCursor> cursor_;
+    bool is_finished_ = false;
+};
+
+}  // namespace app
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <functional>
+#include <iosfwd>
 #include <vector>
 #include <string>
 #include <optional>
 #include "../domain/book.h"
+#include "book_pages.h"
 
 namespace app {
 
 class UseCases {
 public:
+    // Получает число книг, обработанных с начала импорта или экспорта
+    using ProgressHandler = std::function<void(size_t rows)>;
+
     virtual void AddAuthor(const std::string& name) = 0;
     virtual void DeleteAuthor(const std::string& author_id) = 0;
     virtual void EditAuthorName(const std::string& author_id, const std::string& new_name) = 0;
@@ -19,6 +25,14 @@ public:
     virtual std::vector<domain::Author> GetAuthorsList() = 0;
     virtual std::vector<std::pair<domain::Book, std::string>> GetBooksList() = 0;
     virtual std::vector<domain::Book> GetAuthorBooks(const std::string& author_id) = 0;
+    // Те же списки постранично, для вывода по мере чтения
+    virtual BookPages GetBookPages(size_t page_size) = 0;
+    virtual BookPages GetAuthorBookPages(const std::string& author_id, size_t page_size) = 0;
+    // Книги с названием, совпадающим с query, начинающимся с него или похожим; лучшие первыми
+    virtual std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) = 0;
+    // Каталог в формате JSON Lines: {"title": ..., "author": ..., "publication_year": ..., "tags": [...]} на строку
+    virtual size_t ImportCatalog(std::istream& input, const ProgressHandler& progress) = 0;
+    virtual size_t ExportCatalog(std::ostream& output, const ProgressHandler& progress) = 0;
 protected:
     ~UseCases() = default;
 };
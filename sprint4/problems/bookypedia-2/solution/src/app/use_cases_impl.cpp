@@ -2,11 +2,85 @@
 
 #include "../domain/book.h"
 
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/json.hpp>
+
+#include <istream>
+#include <ostream>
+#include <set>
+#include <unordered_map>
+
 namespace app {
 using namespace domain;
+using namespace std::literals;
+namespace json = boost::json;
+
+namespace {
+
+struct CatalogEntry {
+    std::string title;
+    std::string author;
+    int publication_year = 0;
+    std::vector<std::string> tags;
+};
+
+std::string GetTrimmedString(const json::object& object, std::string_view key) {
+    auto value = json::value_to<std::string>(object.at(key));
+    boost::algorithm::trim(value);
+    return value;
+}
+
+CatalogEntry ParseCatalogLine(std::string_view line, size_t line_number) {
+    CatalogEntry entry;
+    try {
+        const auto value = json::parse(line);
+        const auto& object = value.as_object();
+
+        entry.title = GetTrimmedString(object, "title"sv);
+        entry.author = GetTrimmedString(object, "author"sv);
+        entry.publication_year = json::value_to<int>(object.at("publication_year"sv));
+
+        // Теги как при вводе в меню: без пробелов по краям, без пустых и повторов, по алфавиту
+        std::set<std::string> tags;
+        if (const auto* tags_value = object.if_contains("tags"sv)) {
+            for (const auto& tag_value : tags_value->as_array()) {
+                auto tag = json::value_to<std::string>(tag_value);
+                boost::algorithm::trim(tag);
+                if (!tag.empty()) {
+                    tags.insert(std::move(tag));
+                }
+            }
+        }
+        entry.tags.assign(tags.begin(), tags.end());
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("line "s + std::to_string(line_number) + ": "s + e.what());
+    }
 
-UseCasesImpl::UseCasesImpl(domain::AuthorRepository& authors, domain::BookRepository& books)
-    : authors_{ authors }, books_{ books } {
+    if (entry.title.empty() || entry.author.empty()) {
+        throw std::runtime_error("line "s + std::to_string(line_number) + ": empty title or author"s);
+    }
+    return entry;
+}
+
+std::string FormatCatalogLine(const Book& book, const std::string& author_name) {
+    json::array tags;
+    for (const auto& tag : book.GetTags()) {
+        tags.emplace_back(tag);
+    }
+
+    return json::serialize(json::object{
+        {"title", book.GetTitle()},
+        {"author", author_name},
+        {"publication_year", book.GetPublicationYear()},
+        {"tags", std::move(tags)}
+    });
+}
+
+}  // namespace
+
+UseCasesImpl::UseCasesImpl(domain::AuthorRepository& authors, domain::BookRepository& books, size_t catalog_batch_size)
+    : authors_{ authors }, books_{ books }, catalog_batch_size_{ catalog_batch_size } {
 }
 
 void UseCasesImpl::AddAuthor(const std::string& name) {
@@ -47,4 +121,91 @@ std::vector<domain::Book> UseCasesImpl::GetAuthorBooks(const std::string& author
     return books_.GetAuthorBooks(domain::AuthorId::FromString(author_id));
 }
 
+BookPages UseCasesImpl::GetBookPages(size_t page_size) {
+    return { [&books = books_](const std::optional<BookCursor>& after, size_t limit) {
+        return books.GetPage(after, limit);
+    }, page_size };
+}
+
+BookPages UseCasesImpl::GetAuthorBookPages(const std::string& author_id, size_t page_size) {
+    return { [&books = books_, id = domain::AuthorId::FromString(author_id)](const std::optional<BookCursor>& after, size_t limit) {
+        std::vector<BookListItem> page;
+        for (auto& book : books.GetAuthorBooksPage(id, after, limit)) {
+            page.emplace_back(std::move(book), std::string{});
+        }
+        return page;
+    }, page_size };
+}
+
+std::vector<std::pair<domain::Book, std::string>> UseCasesImpl::SearchBooks(const std::string& query, size_t limit) {
+    return books_.SearchBooks(query, limit);
+}
+
+size_t UseCasesImpl::ImportCatalog(std::istream& input, const ProgressHandler& progress) {
+    // Имя автора -> id: известные загружаются один раз, новые добавляются по мере появления в файле
+    std::unordered_map<std::string, AuthorId> author_ids;
+    for (const auto& author : authors_.GetAll()) {
+        author_ids.emplace(author.GetName(), author.GetId());
+    }
+
+    std::vector<Author> new_authors;
+    std::vector<Book> books;
+    books.reserve(catalog_batch_size_);
+    size_t imported = 0;
+
+    auto save_batch = [&] {
+        if (books.empty()) {
+            return;
+        }
+        books_.SaveBatch(new_authors, books);
+        imported += books.size();
+        new_authors.clear();
+        books.clear();
+        if (progress) {
+            progress(imported);
+        }
+    };
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r"sv) == std::string::npos) {
+            continue;
+        }
+
+        auto entry = ParseCatalogLine(line, line_number);
+
+        auto [author, is_new] = author_ids.try_emplace(entry.author);
+        if (is_new) {
+            author->second = AuthorId::New();
+            new_authors.emplace_back(author->second, entry.author);
+        }
+
+        books.emplace_back(BookId::New(), author->second, std::move(entry.title), entry.publication_year, std::move(entry.tags));
+        if (books.size() == catalog_batch_size_) {
+            save_batch();
+        }
+    }
+    save_batch();
+
+    return imported;
+}
+
+size_t UseCasesImpl::ExportCatalog(std::ostream& output, const ProgressHandler& progress) {
+    size_t exported = 0;
+    books_.ForEachBook([&](const Book& book, const std::string& author_name) {
+        output << FormatCatalogLine(book, author_name) << '\n';
+        if (++exported % catalog_batch_size_ == 0 && progress) {
+            progress(exported);
+        }
+    });
+    output.flush();
+
+    if (progress && exported % catalog_batch_size_ != 0) {
+        progress(exported);
+    }
+    return exported;
+}
+
 }  // namespace app
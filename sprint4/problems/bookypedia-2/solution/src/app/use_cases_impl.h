@@ -10,7 +10,10 @@ namespace app {
 
 class UseCasesImpl : public UseCases {
 public:
-    explicit UseCasesImpl(domain::AuthorRepository& authors, domain::BookRepository& books);
+    static constexpr size_t DEFAULT_CATALOG_BATCH_SIZE = 10'000;
+
+    explicit UseCasesImpl(domain::AuthorRepository& authors, domain::BookRepository& books,
+        size_t catalog_batch_size = DEFAULT_CATALOG_BATCH_SIZE);
 
     void AddAuthor(const std::string& name) override;
 
@@ -31,9 +34,21 @@ public:
 
     std::vector<domain::Book> GetAuthorBooks(const std::string& author_id) override;
 
+    BookPages GetBookPages(size_t page_size) override;
+
+    BookPages GetAuthorBookPages(const std::string& author_id, size_t page_size) override;
+
+    std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) override;
+
+    // Файл читается пачками по catalog_batch_size книг, так что память не зависит от его размера
+    size_t ImportCatalog(std::istream& input, const ProgressHandler& progress) override;
+
+    size_t ExportCatalog(std::ostream& output, const ProgressHandler& progress) override;
+
 private:
     domain::AuthorRepository& authors_;
     domain::BookRepository& books_;
+    size_t catalog_batch_size_;
 };
 
 }  // namespace app
@@ -11,7 +11,13 @@ namespace bookypedia {
 using namespace std::literals;
 
 Application::Application(const AppConfig& config)
-    : db_{pqxx::connection{config.db_url}} {
+    : db_{config.db_url}
+    , page_size_{config.page_size} {
+    if (config.listen_changes) {
+        change_listener_.emplace(config.db_url, [this] {
+            catalog_version_.Invalidate();
+        });
+    }
 }
 
 void Application::Run() {
@@ -25,7 +31,7 @@ void Application::Run() {
     menu.AddAction("Exit"s, {}, "Exit program"s, [&menu](std::istream&) {
         return false;
     });
-    ui::View view{menu, use_cases_, std::cin, std::cout};
+    ui::View view{menu, use_cases_, std::cin, std::cout, page_size_};
     menu.Run();
 }
 
@@ -2,13 +2,22 @@
 //#include <pqxx/pqxx>
 
 #include "app/use_cases_impl.h"
+#include "cache/catalog_cache.h"
+#include "postgres/change_listener.h"
 #include "postgres/postgres.h"
+#include "ui/view.h"
+
+#include <optional>
 
 
 namespace bookypedia {
 
 struct AppConfig {
     std::string db_url;
+    // Сколько книг читается из БД за раз при выводе списков
+    size_t page_size = ui::View::DEFAULT_PAGE_SIZE;
+    // Сбрасывать кэш каталога, когда его меняют другие процессы (LISTEN/NOTIFY)
+    bool listen_changes = false;
 };
 
 class Application {
@@ -20,7 +29,13 @@ public:
 private:
     
     postgres::Database db_;
-    app::UseCasesImpl use_cases_{db_.GetAuthors(), db_.GetBooks()};
+    size_t page_size_;
+    // Меню перечитывает списки авторов и книг почти на каждой команде - они берутся из кэша
+    cache::CatalogVersion catalog_version_;
+    cache::CachingAuthorRepository authors_{db_.GetAuthors(), catalog_version_};
+    cache::CachingBookRepository books_{db_.GetBooks(), catalog_version_};
+    app::UseCasesImpl use_cases_{authors_, books_};
+    std::optional<postgres::ChangeListener> change_listener_;
 };
 
 }  // namespace bookypedia
@@ -0,0 +1,92 @@
+#include "catalog_cache.h"
+
+namespace cache {
+
+void CachingAuthorRepository::Save(const domain::Author& author) {
+    authors_.Save(author);
+    version_.Invalidate();
+}
+
+std::vector<domain::Author> CachingAuthorRepository::GetAll() {
+    return all_.Get(version_, [this] {
+        return authors_.GetAll();
+    });
+}
+
+void CachingAuthorRepository::Delete(const domain::AuthorId& author_id) {
+    authors_.Delete(author_id);
+    version_.Invalidate();
+}
+
+void CachingAuthorRepository::EditName(const domain::AuthorId& author_id, const std::string& new_name) {
+    authors_.EditName(author_id, new_name);
+    version_.Invalidate();
+}
+
+void CachingBookRepository::Save(const domain::Book& book) {
+    books_.Save(book);
+    version_.Invalidate();
+}
+
+void CachingBookRepository::Delete(const domain::BookId& book_id) {
+    books_.Delete(book_id);
+    version_.Invalidate();
+}
+
+std::vector<std::pair<domain::Book, std::string>> CachingBookRepository::GetAll() {
+    return all_.Get(version_, [this] {
+        return books_.GetAll();
+    });
+}
+
+std::vector<domain::Book> CachingBookRepository::GetAuthorBooks(const domain::AuthorId& author_id) {
+    std::lock_guard lock{ author_books_mutex_ };
+    const auto current = version_.Get();
+    if (author_books_version_ != current) {
+        author_books_.clear();
+        author_books_version_ = current;
+    }
+
+    auto key = author_id.ToString();
+    auto it = author_books_.find(key);
+    if (it == author_books_.end()) {
+        it = author_books_.emplace(std::move(key), books_.GetAuthorBooks(author_id)).first;
+    }
+    return it->second;
+}
+
+std::vector<std::pair<domain::Book, std::string>> CachingBookRepository::GetPage(const std::optional<domain::BookCursor>& after,
+    size_t limit) {
+    return books_.GetPage(after, limit);
+}
+
+std::vector<domain::Book> CachingBookRepository::GetAuthorBooksPage(const domain::AuthorId& author_id,
+    const std::optional<domain::BookCursor>& after, size_t limit) {
+    return books_.GetAuthorBooksPage(author_id, after, limit);
+}
+
+std::vector<std::pair<domain::Book, std::string>> CachingBookRepository::SearchBooks(const std::string& query, size_t limit) {
+    return books_.SearchBooks(query, limit);
+}
+
+void CachingBookRepository::EditBook(const domain::BookId& book_id, const std::optional<std::string>& new_title,
+    const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) {
+    books_.EditBook(book_id, new_title, new_pub_year, new_tags);
+    version_.Invalidate();
+}
+
+void CachingBookRepository::EditBooks(const std::vector<domain::BookEdit>& edits) {
+    books_.EditBooks(edits);
+    version_.Invalidate();
+}
+
+void CachingBookRepository::SaveBatch(const std::vector<domain::Author>& new_authors, const std::vector<domain::Book>& books) {
+    books_.SaveBatch(new_authors, books);
+    version_.Invalidate();
+}
+
+void CachingBookRepository::ForEachBook(const std::function<void(const domain::Book& book, const std::string& author_name)>& consumer) {
+    books_.ForEachBook(consumer);
+}
+
+}  // namespace cache
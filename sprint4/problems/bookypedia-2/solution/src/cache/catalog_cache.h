@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace cache {
+
+// Номер версии каталога, общий для кэшей авторов и книг: в списках книг есть имена авторов
+class CatalogVersion {
+public:
+    uint64_t Get() const noexcept {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    // Снимки, прочитанные до вызова, устаревают; можно вызывать из любого потока
+    void Invalidate() noexcept {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<uint64_t> version_{ 0 };
+};
+
+/*
+ * Снимок хранится вместе с версией, при которой начиналось чтение. Если каталог изменился во время
+ * чтения, снимок сразу устаревает и будет перечитан при следующем обращении.
+ */
+template <typename Value>
+class Snapshot {
+public:
+    template <typename Loader>
+    Value Get(const CatalogVersion& version, Loader&& loader) {
+        std::lock_guard lock{ mutex_ };
+        const auto current = version.Get();
+        if (!value_ || loaded_version_ != current) {
+            value_ = loader();
+            loaded_version_ = current;
+        }
+        return *value_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::optional<Value> value_;
+    uint64_t loaded_version_ = 0;
+};
+
+// Кэширует список авторов; любая запись через этот репозиторий сбрасывает версию каталога
+class CachingAuthorRepository : public domain::AuthorRepository {
+public:
+    CachingAuthorRepository(domain::AuthorRepository& authors, CatalogVersion& version)
+        : authors_{ authors }
+        , version_{ version } {
+    }
+
+    void Save(const domain::Author& author) override;
+
+    std::vector<domain::Author> GetAll() override;
+
+    void Delete(const domain::AuthorId& author_id) override;
+
+    void EditName(const domain::AuthorId& author_id, const std::string& new_name) override;
+
+private:
+    domain::AuthorRepository& authors_;
+    CatalogVersion& version_;
+    Snapshot<std::vector<domain::Author>> all_;
+};
+
+// Кэширует полный список книг и книги авторов; страницы, поиск и экспорт читаются из БД
+class CachingBookRepository : public domain::BookRepository {
+public:
+    CachingBookRepository(domain::BookRepository& books, CatalogVersion& version)
+        : books_{ books }
+        , version_{ version } {
+    }
+
+    void Save(const domain::Book& book) override;
+
+    void Delete(const domain::BookId& book_id) override;
+
+    std::vector<std::pair<domain::Book, std::string>> GetAll() override;
+
+    std::vector<domain::Book> GetAuthorBooks(const domain::AuthorId& author_id) override;
+
+    std::vector<std::pair<domain::Book, std::string>> GetPage(const std::optional<domain::BookCursor>& after, size_t limit) override;
+
+    std::vector<domain::Book> GetAuthorBooksPage(const domain::AuthorId& author_id, const std::optional<domain::BookCursor>& after,
+        size_t limit) override;
+
+    std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) override;
+
+    void EditBook(const domain::BookId& book_id, const std::optional<std::string>& new_title,
+        const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) override;
+
+    void EditBooks(const std::vector<domain::BookEdit>& edits) override;
+
+    void SaveBatch(const std::vector<domain::Author>& new_authors, const std::vector<domain::Book>& books) override;
+
+    void ForEachBook(const std::function<void(const domain::Book& book, const std::string& author_name)>& consumer) override;
+
+private:
+    domain::BookRepository& books_;
+    CatalogVersion& version_;
+    Snapshot<std::vector<std::pair<domain::Book, std::string>>> all_;
+    // Книги авторов, к которым уже обращались; очищается, когда версия каталога меняется
+    std::mutex author_books_mutex_;
+    uint64_t author_books_version_ = 0;
+    std::unordered_map<std::string, std::vector<domain::Book>> author_books_;
+};
+
+}  // namespace cache
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -52,6 +54,21 @@ private:
     std::vector<std::string> tags_;
 };
 
+// Ключ сортировки последней выданной книги: следующая страница начинается сразу после него
+struct BookCursor {
+    std::string title;
+    std::string author_name;
+    int publication_year = 0;
+    BookId book_id;
+};
+
+struct BookEdit {
+    BookId book_id;
+    std::optional<std::string> new_title;
+    std::optional<int> new_pub_year;
+    std::vector<std::string> new_tags;
+};
+
 class BookRepository {
 public:
     virtual void Save(const Book& book) = 0;
@@ -62,8 +79,26 @@ public:
 
     virtual std::vector<Book> GetAuthorBooks(const AuthorId& author_id) = 0;
 
+    // Не больше limit книг после after в порядке (название, автор, год, id)
+    virtual std::vector<std::pair<domain::Book, std::string>> GetPage(const std::optional<BookCursor>& after, size_t limit) = 0;
+
+    // Не больше limit книг автора после after в порядке (год, название, id)
+    virtual std::vector<Book> GetAuthorBooksPage(const AuthorId& author_id, const std::optional<BookCursor>& after, size_t limit) = 0;
+
+    // Не больше limit книг по названию: точное совпадение, затем по началу названия, затем похожие
+    virtual std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) = 0;
+
     virtual void EditBook(const BookId& book_id, const std::optional<std::string>& new_title,
         const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) = 0;
+
+    // Все правки в одной транзакции
+    virtual void EditBooks(const std::vector<BookEdit>& edits) = 0;
+
+    // Пачка импорта: новые авторы и книги с тегами в одной транзакции
+    virtual void SaveBatch(const std::vector<Author>& new_authors, const std::vector<Book>& books) = 0;
+
+    // Передаёт книги с именами авторов по одной, не загружая каталог в память целиком
+    virtual void ForEachBook(const std::function<void(const Book& book, const std::string& author_name)>& consumer) = 0;
 protected:
     ~BookRepository() = default;
 };
@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string_view>
 
 #include "bookypedia.h"
 
@@ -20,11 +21,30 @@ bookypedia::AppConfig GetConfigFromEnv() {
     return config;
 }
 
+// Параметры командной строки: --page-size N, --listen-changes
+void ParseCommandLine(int argc, const char* argv[], bookypedia::AppConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--listen-changes"sv) {
+            config.listen_changes = true;
+        } else if (argv[i] == "--page-size"sv && i + 1 < argc) {
+            const auto page_size = std::stoul(argv[++i]);
+            if (page_size == 0) {
+                throw std::runtime_error("--page-size must be positive");
+            }
+            config.page_size = page_size;
+        } else {
+            throw std::runtime_error("Usage: bookypedia [--page-size N] [--listen-changes]");
+        }
+    }
+}
+
 }  // namespace
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] const char* argv[]) {
+int main(int argc, const char* argv[]) {
     try {
-        bookypedia::Application app{GetConfigFromEnv()};
+        auto config = GetConfigFromEnv();
+        ParseCommandLine(argc, argv, config);
+        bookypedia::Application app{config};
         app.Run();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
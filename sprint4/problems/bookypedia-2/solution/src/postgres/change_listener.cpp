@@ -0,0 +1,69 @@
+#include "change_listener.h"
+
+#include <pqxx/connection>
+#include <pqxx/notification>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+class Receiver : public pqxx::notification_receiver {
+public:
+    Receiver(pqxx::connection& connection, const std::function<void()>& on_change)
+        : pqxx::notification_receiver{ connection, CATALOG_CHANGES_CHANNEL }
+        , on_change_{ on_change } {
+    }
+
+    void operator()(const std::string& /*payload*/, int /*backend_pid*/) override {
+        on_change_();
+    }
+
+private:
+    const std::function<void()>& on_change_;
+};
+
+// Как часто проверяется запрос на остановку и как долго ждать перед переподключением
+constexpr auto POLL_INTERVAL = 500ms;
+constexpr auto RECONNECT_DELAY = 1s;
+
+}  // namespace
+
+ChangeListener::ChangeListener(std::string db_url, std::function<void()> on_change)
+    : db_url_{ std::move(db_url) }
+    , on_change_{ std::move(on_change) }
+    , thread_{ [this](std::stop_token stop) {
+        Run(stop);
+    } } {
+}
+
+void ChangeListener::Run(std::stop_token stop) {
+    const auto poll_us = std::chrono::duration_cast<std::chrono::microseconds>(POLL_INTERVAL).count();
+    while (!stop.stop_requested()) {
+        try {
+            pqxx::connection connection{ db_url_ };
+            Receiver receiver{ connection, on_change_ };
+            on_change_();
+
+            while (!stop.stop_requested()) {
+                connection.await_notification(0, poll_us);
+            }
+        }
+        catch (const std::exception&) {
+            // БД недоступна - кэш живёт до ближайшей своей записи, пробуем позже
+            std::mutex mutex;
+            std::condition_variable_any stop_waiter;
+            std::unique_lock lock{ mutex };
+            stop_waiter.wait_for(lock, stop, RECONNECT_DELAY, [] {
+                return false;
+            });
+        }
+    }
+}
+
+}  // namespace postgres
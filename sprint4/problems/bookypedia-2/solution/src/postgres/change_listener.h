@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace postgres {
+
+// Канал, в который триггеры схемы (см. Database) сообщают о любой записи в таблицы каталога
+constexpr std::string_view CATALOG_CHANGES_CHANNEL = "catalog_changes";
+
+/*
+ * Слушает CATALOG_CHANGES_CHANNEL на отдельном соединении и вызывает on_change из своего потока,
+ * когда каталог меняет любой процесс. После обрыва соединения переподключается и тоже вызывает
+ * on_change: уведомления за время разрыва потеряны.
+ */
+class ChangeListener {
+public:
+    ChangeListener(std::string db_url, std::function<void()> on_change);
+
+    ChangeListener(const ChangeListener&) = delete;
+    ChangeListener& operator=(const ChangeListener&) = delete;
+
+private:
+    void Run(std::stop_token stop);
+
+    std::string db_url_;
+    std::function<void()> on_change_;
+    // Последним, чтобы поток запускался после инициализации остальных полей и останавливался первым
+    std::jthread thread_;
+};
+
+}  // namespace postgres
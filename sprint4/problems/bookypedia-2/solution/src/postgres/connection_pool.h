@@ -0,0 +1,80 @@
+#pragma once
+
+#include <pqxx/connection>
+
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace postgres {
+
+/*
+ * Пул соединений: GetConnection ждёт свободное соединение, обёртка возвращает его в пул в деструкторе.
+ * Соединения открываются по мере надобности, не больше capacity; закрытое после сбоя БД пересоздаётся.
+ */
+class ConnectionPool {
+    using ConnectionPtr = std::shared_ptr<pqxx::connection>;
+public:
+    using ConnectionFactory = std::function<ConnectionPtr()>;
+
+    class ConnectionWrapper {
+    public:
+        ConnectionWrapper(ConnectionPtr&& connection, ConnectionPool& pool) noexcept
+            : connection_{ std::move(connection) }
+            , pool_{ &pool } {
+        }
+
+        ConnectionWrapper(const ConnectionWrapper&) = delete;
+        ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
+
+        ConnectionWrapper(ConnectionWrapper&&) = default;
+
+        // Соединение, которое держала обёртка, возвращается в пул, иначе его слот пропал бы навсегда
+        ConnectionWrapper& operator=(ConnectionWrapper&& other) noexcept {
+            if (this != &other) {
+                if (connection_) {
+                    pool_->ReturnConnection(std::move(connection_));
+                }
+                connection_ = std::move(other.connection_);
+                pool_ = other.pool_;
+            }
+            return *this;
+        }
+
+        pqxx::connection& operator*() const& noexcept {
+            return *connection_;
+        }
+        pqxx::connection& operator*() const&& = delete;
+
+        pqxx::connection* operator->() const& noexcept {
+            return connection_.get();
+        }
+
+        ~ConnectionWrapper() {
+            if (connection_) {
+                pool_->ReturnConnection(std::move(connection_));
+            }
+        }
+    private:
+        ConnectionPtr connection_;
+        ConnectionPool* pool_;
+    };
+
+    ConnectionPool(size_t capacity, ConnectionFactory connection_factory);
+
+    ConnectionWrapper GetConnection();
+private:
+    void ReturnConnection(ConnectionPtr&& connection);
+
+    ConnectionFactory connection_factory_;
+    std::mutex mutex_;
+    std::condition_variable cond_var_;
+    // Свободные соединения в начале; пустой слот - соединение ещё не открыто
+    std::vector<ConnectionPtr> pool_;
+    size_t used_connections_ = 0;
+};
+
+}  // namespace postgres
@@ -1,46 +1,304 @@
 #include "postgres.h"
 
+#include <pqxx/array>
+#include <pqxx/pipeline>
+#include <pqxx/stream_to>
 #include <pqxx/zview.hxx>
 
+#include <tuple>
+
 namespace postgres {
 using namespace std::literals;
 using pqxx::operator"" _zv;
 
-void AuthorRepositoryImpl::Save(const domain::Author& author) {
-    pqxx::work work{connection_, "serializable" };
-    work.exec_params(
-        R"(
+namespace {
+
+// Чтение одного согласованного снимка без блокировок записи
+using ReadTransaction = pqxx::transaction<pqxx::isolation_level::repeatable_read, pqxx::write_policy::read_only>;
+
+// Имена подготовленных запросов; регистрируются на каждом соединении пула в PrepareStatements
+namespace statements {
+constexpr auto SAVE_AUTHOR = "save_author"_zv;
+constexpr auto DELETE_AUTHOR_TAGS = "delete_author_tags"_zv;
+constexpr auto DELETE_AUTHOR_BOOKS = "delete_author_books"_zv;
+constexpr auto DELETE_AUTHOR = "delete_author"_zv;
+constexpr auto EDIT_AUTHOR_NAME = "edit_author_name"_zv;
+constexpr auto GET_AUTHORS = "get_authors"_zv;
+
+constexpr auto SAVE_BOOK = "save_book"_zv;
+constexpr auto GET_BOOKS = "get_books"_zv;
+constexpr auto GET_AUTHOR_BOOKS = "get_author_books"_zv;
+constexpr auto GET_BOOKS_PAGE = "get_books_page"_zv;
+constexpr auto GET_BOOKS_PAGE_AFTER = "get_books_page_after"_zv;
+constexpr auto GET_AUTHOR_BOOKS_PAGE = "get_author_books_page"_zv;
+constexpr auto GET_AUTHOR_BOOKS_PAGE_AFTER = "get_author_books_page_after"_zv;
+constexpr auto SEARCH_BOOKS = "search_books"_zv;
+constexpr auto EDIT_BOOK = "edit_book"_zv;
+constexpr auto DELETE_BOOK_TAGS = "delete_book_tags"_zv;
+constexpr auto DELETE_BOOK = "delete_book"_zv;
+}  // namespace statements
+
+// Пустое название при редактировании означает "не менять"
+std::optional<std::string> GetNewTitle(const std::optional<std::string>& new_title) {
+    if (new_title.has_value() && !new_title->empty()) {
+        return new_title;
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string> ParseTags(pqxx::array_parser parser) {
+    std::vector<std::string> tags;
+    for (auto [juncture, value] = parser.get_next(); juncture != pqxx::array_parser::juncture::done; std::tie(juncture, value) = parser.get_next()) {
+        if (juncture == pqxx::array_parser::juncture::string_value) {
+            tags.push_back(std::move(value));
+        }
+    }
+    return tags;
+}
+
+std::vector<std::string> ParseTags(const pqxx::field& field) {
+    return ParseTags(field.as_array());
+}
+
+std::vector<std::pair<domain::Book, std::string>> ReadBooksWithAuthors(const pqxx::result& result) {
+    std::vector<std::pair<domain::Book, std::string>> books;
+    books.reserve(result.size());
+    for (const auto& row : result) {
+        books.emplace_back(
+            domain::Book{
+                domain::BookId::FromString(row["id"].as<std::string>()),
+                domain::AuthorId::FromString(row["author_id"].as<std::string>()),
+                row["title"].as<std::string>(),
+                row["publication_year"].as<int>(),
+                ParseTags(row["tags"])
+            },
+            row["author_name"].as<std::string>()
+        );
+    }
+    return books;
+}
+
+// Шаблон ILIKE для названий, начинающихся с prefix; символы шаблона в нём ищутся буквально
+std::string MakePrefixPattern(std::string_view prefix) {
+    std::string pattern;
+    pattern.reserve(prefix.size() + 1);
+    for (char c : prefix) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    pattern += '%';
+    return pattern;
+}
+
+std::vector<domain::Book> ReadBooks(const pqxx::result& result) {
+    std::vector<domain::Book> books;
+    books.reserve(result.size());
+    for (const auto& row : result) {
+        books.push_back({
+            domain::BookId::FromString(row["id"].as<std::string>()),
+            domain::AuthorId::FromString(row["author_id"].as<std::string>()),
+            row["title"].as<std::string>(),
+            row["publication_year"].as<int>(), {}
+            });
+    }
+    return books;
+}
+
+void CreateSchema(pqxx::connection& connection) {
+    pqxx::work work{connection};
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS authors (
+    id UUID PRIMARY KEY,
+    name VARCHAR(100) UNIQUE NOT NULL
+);
+)"_zv);
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS books (
+    id UUID PRIMARY KEY,
+    author_id UUID NOT NULL,
+    title VARCHAR(100) NOT NULL,
+    publication_year INT NOT NULL,
+    FOREIGN KEY (author_id) REFERENCES authors (id)
+);
+)"_zv);
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS book_tags (
+    book_id UUID NOT NULL,
+    tag VARCHAR(30) NOT NULL,
+    FOREIGN KEY (book_id) REFERENCES books (id)
+);
+)"_zv);
+    // Для постраничного чтения: страница - короткий проход по индексу от курсора, а не сортировка всей таблицы
+    work.exec("CREATE INDEX IF NOT EXISTS books_title_idx ON books (title);"_zv);
+    work.exec("CREATE INDEX IF NOT EXISTS books_author_year_title_idx ON books (author_id, publication_year, title, id);"_zv);
+    work.exec("CREATE INDEX IF NOT EXISTS book_tags_book_id_idx ON book_tags (book_id, tag);"_zv);
+    // Уведомления в канал CATALOG_CHANGES_CHANNEL для кэшей других процессов; по одному на оператор, а не на строку
+    work.exec(R"(
+CREATE OR REPLACE FUNCTION notify_catalog_changes() RETURNS trigger AS $$
+BEGIN
+    PERFORM pg_notify('catalog_changes', TG_TABLE_NAME);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+)"_zv);
+    work.exec(R"(
+DO $$
+DECLARE
+    table_name text;
+BEGIN
+    FOREACH table_name IN ARRAY ARRAY['authors', 'books', 'book_tags'] LOOP
+        IF NOT EXISTS (SELECT 1 FROM pg_trigger WHERE tgname = table_name || '_notify_changes') THEN
+            EXECUTE format('CREATE TRIGGER %I AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON %I '
+                'FOR EACH STATEMENT EXECUTE FUNCTION notify_catalog_changes()', table_name || '_notify_changes', table_name);
+        END IF;
+    END LOOP;
+END
+$$;
+)"_zv);
+    work.commit();
+}
+
+// Поиск по названию: триграммный индекс обслуживает и ILIKE по началу, и похожесть %.
+// pg_trgm может не быть на сервере или прав на CREATE EXTENSION - тогда поиск обходится без похожих названий.
+// Отдельная транзакция, чтобы сбой здесь не откатил остальную схему
+bool CreateTrigramIndex(pqxx::connection& connection) {
+    try {
+        pqxx::work work{connection};
+        work.exec("CREATE EXTENSION IF NOT EXISTS pg_trgm;"_zv);
+        work.exec("CREATE INDEX IF NOT EXISTS books_title_trgm_idx ON books USING gin (title gin_trgm_ops);"_zv);
+        work.commit();
+        return true;
+    } catch (const pqxx::sql_error&) {
+        return false;
+    }
+}
+
+void PrepareStatements(pqxx::connection& connection, bool has_trigram_search) {
+    using namespace statements;
+
+    connection.prepare(SAVE_AUTHOR, R"(
 INSERT INTO authors (id, name) VALUES ($1, $2)
 ON CONFLICT (id) DO UPDATE SET name=$2;
-)"_zv,
-        author.GetId().ToString(), author.GetName());
+)"_zv);
+    connection.prepare(DELETE_AUTHOR_TAGS, R"(
+DELETE FROM book_tags
+WHERE book_id IN (
+    SELECT id FROM books WHERE author_id = $1
+);
+)"_zv);
+    connection.prepare(DELETE_AUTHOR_BOOKS, "DELETE FROM books WHERE author_id = $1"_zv);
+    connection.prepare(DELETE_AUTHOR, "DELETE FROM authors WHERE id = $1"_zv);
+    connection.prepare(EDIT_AUTHOR_NAME, "UPDATE authors SET name = $2 WHERE id = $1"_zv);
+    connection.prepare(GET_AUTHORS, "SELECT id, name FROM authors ORDER BY name"_zv);
+
+    // Книга и все её теги - одним запросом, сколько бы тегов ни было
+    connection.prepare(SAVE_BOOK, R"(
+WITH book AS (
+    INSERT INTO books (id, title, author_id, publication_year) VALUES ($1, $2, $3, $4)
+    RETURNING id
+)
+INSERT INTO book_tags (book_id, tag) SELECT id, unnest($5::varchar[]) FROM book;
+)"_zv);
+    // Теги собираются в массив тем же запросом, а не отдельным SELECT на каждую книгу
+    connection.prepare(GET_BOOKS, R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name,
+    COALESCE(array_agg(t.tag ORDER BY t.tag) FILTER (WHERE t.tag IS NOT NULL), '{}') as tags
+FROM books b
+JOIN authors a ON b.author_id = a.id
+LEFT JOIN book_tags t ON t.book_id = b.id
+GROUP BY b.id, a.id
+ORDER BY b.title, a.name, b.publication_year
+)"_zv);
+    connection.prepare(GET_AUTHOR_BOOKS,
+        "SELECT id, title, author_id, publication_year FROM books WHERE author_id = $1 ORDER BY publication_year, title"_zv);
+    // Теги - подзапросом по индексу только для книг страницы
+    connection.prepare(GET_BOOKS_PAGE, R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name,
+    ARRAY(SELECT t.tag FROM book_tags t WHERE t.book_id = b.id ORDER BY t.tag) as tags
+FROM books b
+JOIN authors a ON b.author_id = a.id
+ORDER BY b.title, a.name, b.publication_year, b.id
+LIMIT $1
+)"_zv);
+    // Первое условие дублирует начало второго, чтобы страница читалась по books_title_idx
+    connection.prepare(GET_BOOKS_PAGE_AFTER, R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name,
+    ARRAY(SELECT t.tag FROM book_tags t WHERE t.book_id = b.id ORDER BY t.tag) as tags
+FROM books b
+JOIN authors a ON b.author_id = a.id
+WHERE b.title >= $1 AND (b.title, a.name, b.publication_year, b.id) > ($1, $2, $3, $4)
+ORDER BY b.title, a.name, b.publication_year, b.id
+LIMIT $5
+)"_zv);
+    connection.prepare(GET_AUTHOR_BOOKS_PAGE, R"(
+SELECT id, title, author_id, publication_year FROM books
+WHERE author_id = $1
+ORDER BY publication_year, title, id
+LIMIT $2
+)"_zv);
+    connection.prepare(GET_AUTHOR_BOOKS_PAGE_AFTER, R"(
+SELECT id, title, author_id, publication_year FROM books
+WHERE author_id = $1 AND (publication_year, title, id) > ($2, $3, $4)
+ORDER BY publication_year, title, id
+LIMIT $5
+)"_zv);
+    // $1 - запрос, $2 - он же как шаблон ILIKE для поиска по началу названия
+    if (has_trigram_search) {
+        connection.prepare(SEARCH_BOOKS, R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name,
+    ARRAY(SELECT t.tag FROM book_tags t WHERE t.book_id = b.id ORDER BY t.tag) as tags
+FROM books b
+JOIN authors a ON b.author_id = a.id
+WHERE b.title = $1 OR b.title ILIKE $2 OR b.title % $1
+ORDER BY b.title = $1 DESC, b.title ILIKE $2 DESC, similarity(b.title, $1) DESC, b.title, a.name, b.publication_year, b.id
+LIMIT $3
+)"_zv);
+    } else {
+        connection.prepare(SEARCH_BOOKS, R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name,
+    ARRAY(SELECT t.tag FROM book_tags t WHERE t.book_id = b.id ORDER BY t.tag) as tags
+FROM books b
+JOIN authors a ON b.author_id = a.id
+WHERE b.title = $1 OR b.title ILIKE $2
+ORDER BY b.title = $1 DESC, b.title, a.name, b.publication_year, b.id
+LIMIT $3
+)"_zv);
+    }
+    // NULL в $2 или $3 оставляет поле как есть; теги заменяются целиком
+    connection.prepare(EDIT_BOOK, R"(
+WITH book AS (
+    UPDATE books SET title = COALESCE($2, title), publication_year = COALESCE($3, publication_year)
+    WHERE id = $1
+    RETURNING id
+), old_tags AS (
+    DELETE FROM book_tags WHERE book_id IN (SELECT id FROM book)
+)
+INSERT INTO book_tags (book_id, tag) SELECT id, unnest($4::varchar[]) FROM book;
+)"_zv);
+    connection.prepare(DELETE_BOOK_TAGS, "DELETE FROM book_tags WHERE book_id = $1"_zv);
+    connection.prepare(DELETE_BOOK, "DELETE FROM books WHERE id = $1"_zv);
+}
+
+}  // namespace
+
+void AuthorRepositoryImpl::Save(const domain::Author& author) {
+    auto connection = pool_.GetConnection();
+    pqxx::work work{*connection, "serializable" };
+    work.exec_prepared(statements::SAVE_AUTHOR, author.GetId().ToString(), author.GetName());
     work.commit();
 }
 
 void AuthorRepositoryImpl::Delete(const domain::AuthorId& author_id) {
-    pqxx::work txn{ connection_ , "serializable" };
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection , "serializable" };
 
     try {
-        txn.exec_params(
-            R"(
-            DELETE FROM book_tags
-            WHERE book_id IN (
-                SELECT id FROM books WHERE author_id = $1
-            );
-            )", author_id.ToString()
-        );
+        txn.exec_prepared(statements::DELETE_AUTHOR_TAGS, author_id.ToString());
+        txn.exec_prepared(statements::DELETE_AUTHOR_BOOKS, author_id.ToString());
 
-        txn.exec_params(
-            R"(
-            DELETE FROM books WHERE author_id = $1;
-            )", author_id.ToString()
-        );
-
-        auto result = txn.exec_params(
-            R"(
-            DELETE FROM authors WHERE id = $1;
-            )", author_id.ToString()
-        );
+        auto result = txn.exec_prepared(statements::DELETE_AUTHOR, author_id.ToString());
 
         if (result.affected_rows() == 0) {
             throw std::runtime_error("Author not found");
@@ -55,13 +313,11 @@ void AuthorRepositoryImpl::Delete(const domain::AuthorId& author_id) {
 }
 
 void AuthorRepositoryImpl::EditName(const domain::AuthorId& author_id, const std::string& new_name) {
-    pqxx::work txn{ connection_ , "serializable" };
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection , "serializable" };
 
     try {
-        auto result = txn.exec_params(
-            "UPDATE authors SET name = $2 WHERE id = $1",
-            author_id.ToString(), new_name
-        );
+        auto result = txn.exec_prepared(statements::EDIT_AUTHOR_NAME, author_id.ToString(), new_name);
 
         if (result.affected_rows() == 0) {
             throw std::runtime_error("Author not found");
@@ -76,12 +332,13 @@ void AuthorRepositoryImpl::EditName(const domain::AuthorId& author_id, const std
 }
 
 std::vector<domain::Author> AuthorRepositoryImpl::GetAll() {
-    pqxx::work txn{ connection_ , "serializable" };
-    auto result = txn.exec("SELECT id, name FROM authors ORDER BY name");
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
+    auto result = txn.exec_prepared(statements::GET_AUTHORS);
 
     std::vector<domain::Author> authors;
-    for (size_t i = 0; i < result.size(); ++i) {
-        const auto& row = result[i];
+    authors.reserve(result.size());
+    for (const auto& row : result) {
         authors.push_back({
             domain::AuthorId::FromString(row["id"].as<std::string>()),
             row["name"].as<std::string>()
@@ -92,129 +349,160 @@ std::vector<domain::Author> AuthorRepositoryImpl::GetAll() {
 }
 
 void BookRepositoryImpl::Save(const domain::Book& book) {
-    pqxx::work work{ connection_ , "serializable" };
+    auto connection = pool_.GetConnection();
+    pqxx::work work{ *connection , "serializable" };
     try {
-        work.exec_params(
-            "INSERT INTO books (id, title, author_id, publication_year) VALUES ($1, $2, $3, $4)",
-            book.GetBookId().ToString(), book.GetTitle(), book.GetAuthorId().ToString(), book.GetPublicationYear());
-
-        auto tags = book.GetTags();
-
-        if (!tags.empty()) {
-            for (const auto& tag : tags) {
-                work.exec_params(
-                    "INSERT INTO book_tags (book_id, tag) VALUES ($1, $2)",
-                    book.GetBookId().ToString(), tag);
-            }
-        }
-        
+        work.exec_prepared(statements::SAVE_BOOK,
+            book.GetBookId().ToString(), book.GetTitle(), book.GetAuthorId().ToString(), book.GetPublicationYear(), book.GetTags());
         work.commit();
     }
     catch (const std::exception& e) {
         work.abort();
         throw std::runtime_error("Failed to add book sql: " + std::string{ e.what() });
-        throw;
     }
 }
 
 std::vector<std::pair<domain::Book, std::string>> BookRepositoryImpl::GetAll() {
-    pqxx::work txn{ connection_ , "serializable" };
-    auto result = txn.exec(
-        R"(
-        SELECT b.id, b.title, b.author_id, b.publication_year, a.name as author_name
-        FROM books b
-        JOIN authors a ON b.author_id = a.id
-        ORDER BY b.title, a.name, b.publication_year
-        )"
-    );
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
+    return ReadBooksWithAuthors(txn.exec_prepared(statements::GET_BOOKS));
+}
 
-    std::vector<std::pair<domain::Book, std::string>> books;
-    for (size_t i = 0; i < result.size(); ++i) {
-        const auto& row = result[i];
+std::vector<std::pair<domain::Book, std::string>> BookRepositoryImpl::GetPage(const std::optional<domain::BookCursor>& after, size_t limit) {
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
 
-        domain::BookId book_id = domain::BookId::FromString(row["id"].as<std::string>());
+    if (!after) {
+        return ReadBooksWithAuthors(txn.exec_prepared(statements::GET_BOOKS_PAGE, limit));
+    }
+    return ReadBooksWithAuthors(txn.exec_prepared(statements::GET_BOOKS_PAGE_AFTER,
+        after->title, after->author_name, after->publication_year, after->book_id.ToString(), limit));
+}
 
-        auto tags_result = txn.exec_params(
-            R"(
-            SELECT tag FROM book_tags WHERE book_id = $1 ORDER BY tag
-            )", book_id.ToString()
-        );
+void BookRepositoryImpl::EditBook(const domain::BookId& book_id, const std::optional<std::string>& new_title,
+    const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) {
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection, "serializable" };
 
-        std::vector<std::string> tags;
-        for (size_t i = 0; i < tags_result.size(); ++i) {
-            tags.push_back(tags_result[i]["tag"].as<std::string>());
-        }
+    try {
+        txn.exec_prepared(statements::EDIT_BOOK, book_id.ToString(), GetNewTitle(new_title), new_pub_year, new_tags);
+        txn.commit();
+    }
+    catch (const std::exception& e) {
+        txn.abort();
+        throw std::runtime_error("Failed to edit book: " + std::string{ e.what() });
+    }
+}
 
-        books.emplace_back(
-            domain::Book{
-                book_id,
-                domain::AuthorId::FromString(row["author_id"].as<std::string>()),
-                row["title"].as<std::string>(),
-                row["publication_year"].as<int>(),
-                std::move(tags)
-            },
-            row["author_name"].as<std::string>()
-        );
+void BookRepositoryImpl::EditBooks(const std::vector<domain::BookEdit>& edits) {
+    if (edits.empty()) {
+        return;
     }
 
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection, "serializable" };
 
-    return books;
+    try {
+        // Конвейер отправляет правки пачкой, не дожидаясь ответа на каждую
+        pqxx::pipeline pipeline{ txn };
+        pipeline.retain(static_cast<int>(edits.size()));
+
+        for (const auto& edit : edits) {
+            pipeline.insert("EXECUTE "s + std::string{ statements::EDIT_BOOK } + "("s
+                + txn.quote(edit.book_id.ToString()) + ", "s + txn.quote(GetNewTitle(edit.new_title)) + ", "s
+                + txn.quote(edit.new_pub_year) + ", "s + txn.quote(edit.new_tags) + ")"s);
+        }
+
+        // Ошибка любой правки выбрасывается при получении её результата
+        while (!pipeline.empty()) {
+            pipeline.retrieve();
+        }
+        pipeline.complete();
+
+        txn.commit();
+    }
+    catch (const std::exception& e) {
+        txn.abort();
+        throw std::runtime_error("Failed to edit books: " + std::string{ e.what() });
+    }
 }
 
-void BookRepositoryImpl::EditBook(const domain::BookId& book_id, const std::optional<std::string>& new_title,
-    const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) {
-    pqxx::work txn{ connection_, "serializable" };
+void BookRepositoryImpl::SaveBatch(const std::vector<domain::Author>& new_authors, const std::vector<domain::Book>& books) {
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection, "serializable" };
 
     try {
-        if (new_title.has_value() && !new_title.value().empty()) {
-            txn.exec_params(
-                "UPDATE books SET title = $2 WHERE id = $1",
-                book_id.ToString(), new_title.value()
-            );
+        // COPY вместо INSERT на строку; таблицы по очереди - соединение ведёт один COPY за раз
+        if (!new_authors.empty()) {
+            auto stream = pqxx::stream_to::table(txn, { "authors"sv }, { "id"sv, "name"sv });
+            for (const auto& author : new_authors) {
+                stream.write_values(author.GetId().ToString(), author.GetName());
+            }
+            stream.complete();
         }
 
-        if (new_pub_year.has_value()) {
-            txn.exec_params(
-                "UPDATE books SET publication_year = $2 WHERE id = $1",
-                book_id.ToString(), new_pub_year.value()
-            );
+        {
+            auto stream = pqxx::stream_to::table(txn, { "books"sv }, { "id"sv, "title"sv, "author_id"sv, "publication_year"sv });
+            for (const auto& book : books) {
+                stream.write_values(book.GetBookId().ToString(), book.GetTitle(), book.GetAuthorId().ToString(), book.GetPublicationYear());
+            }
+            stream.complete();
         }
 
-        txn.exec_params(
-            "DELETE FROM book_tags WHERE book_id = $1",
-            book_id.ToString()
-        );
-
-        if (!new_tags.empty()) {
-            for (const auto& tag : new_tags) {
-                txn.exec_params(
-                    "INSERT INTO book_tags (book_id, tag) VALUES ($1, $2)",
-                    book_id.ToString(), tag
-                );
+        {
+            auto stream = pqxx::stream_to::table(txn, { "book_tags"sv }, { "book_id"sv, "tag"sv });
+            for (const auto& book : books) {
+                const auto book_id = book.GetBookId().ToString();
+                for (const auto& tag : book.GetTags()) {
+                    stream.write_values(book_id, tag);
+                }
             }
+            stream.complete();
         }
 
         txn.commit();
     }
     catch (const std::exception& e) {
         txn.abort();
-        throw std::runtime_error("Failed to edit book: " + std::string{ e.what() });
+        throw std::runtime_error("Failed to import books: " + std::string{ e.what() });
+    }
+}
+
+void BookRepositoryImpl::ForEachBook(const std::function<void(const domain::Book& book, const std::string& author_name)>& consumer) {
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
+
+    // Строки приходят через COPY по мере чтения, результат целиком в памяти не собирается
+    auto stream = txn.stream<std::string_view, std::string_view, std::string_view, int, std::string_view, std::string_view>(R"(
+SELECT b.id, b.title, b.author_id, b.publication_year, a.name,
+    COALESCE(array_agg(t.tag ORDER BY t.tag) FILTER (WHERE t.tag IS NOT NULL), '{}')
+FROM books b
+JOIN authors a ON b.author_id = a.id
+LEFT JOIN book_tags t ON t.book_id = b.id
+GROUP BY b.id, a.id
+ORDER BY b.title, a.name, b.publication_year
+)"sv);
+
+    for (auto [id, title, author_id, publication_year, author_name, tags] : stream) {
+        consumer(
+            domain::Book{
+                domain::BookId::FromString(std::string{ id }),
+                domain::AuthorId::FromString(std::string{ author_id }),
+                std::string{ title },
+                publication_year,
+                ParseTags(pqxx::array_parser{ tags })
+            },
+            std::string{ author_name });
     }
 }
 
 void BookRepositoryImpl::Delete(const domain::BookId& book_id) {
-    pqxx::work txn{ connection_ , "serializable" };
+    auto connection = pool_.GetConnection();
+    pqxx::work txn{ *connection , "serializable" };
 
     try {
-        txn.exec_params(
-            "DELETE FROM book_tags WHERE book_id = $1",
-            book_id.ToString()
-        );
-
-        txn.exec_params(
-            "DELETE FROM books WHERE id = $1",
-            book_id.ToString()
-        );
+        txn.exec_prepared(statements::DELETE_BOOK_TAGS, book_id.ToString());
+        txn.exec_prepared(statements::DELETE_BOOK, book_id.ToString());
 
         txn.commit();
     }
@@ -225,50 +513,40 @@ void BookRepositoryImpl::Delete(const domain::BookId& book_id) {
 }
 
 std::vector<domain::Book> BookRepositoryImpl::GetAuthorBooks(const domain::AuthorId& author_id) {
-    pqxx::work txn{ connection_ , "serializable" };
-    auto result = txn.exec_params("SELECT id, title, author_id, publication_year FROM books WHERE author_id = $1 ORDER BY publication_year, title",
-        author_id.ToString());
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
+    return ReadBooks(txn.exec_prepared(statements::GET_AUTHOR_BOOKS, author_id.ToString()));
+}
 
-    std::vector<domain::Book> books;
-    for (size_t i = 0; i < result.size(); ++i) {
-        const auto& row = result[i];
-        books.push_back({
-            domain::BookId::FromString(row["id"].as<std::string>()),
-            domain::AuthorId::FromString(row["author_id"].as<std::string>()),
-            row["title"].as<std::string>(),
-            row["publication_year"].as<int>(), {}
-            });
-    }
+std::vector<std::pair<domain::Book, std::string>> BookRepositoryImpl::SearchBooks(const std::string& query, size_t limit) {
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
 
-    return books;
+    return ReadBooksWithAuthors(txn.exec_prepared(statements::SEARCH_BOOKS, query, MakePrefixPattern(query), limit));
 }
 
+std::vector<domain::Book> BookRepositoryImpl::GetAuthorBooksPage(const domain::AuthorId& author_id,
+    const std::optional<domain::BookCursor>& after, size_t limit) {
+    auto connection = pool_.GetConnection();
+    ReadTransaction txn{ *connection };
 
-Database::Database(pqxx::connection connection)
-    : connection_{std::move(connection)} {
-    pqxx::work work{connection_};
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS authors (
-    id UUID PRIMARY KEY,
-    name VARCHAR(100) UNIQUE NOT NULL
-);
-)"_zv);
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS books (
-    id UUID PRIMARY KEY,
-    author_id UUID NOT NULL,
-    title VARCHAR(100) NOT NULL,
-    publication_year INT NOT NULL,
-    FOREIGN KEY (author_id) REFERENCES authors (id)
-);
-)"_zv);
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS book_tags (
-    book_id UUID NOT NULL,
-    tag VARCHAR(30) NOT NULL,
-    FOREIGN KEY (book_id) REFERENCES books (id)
-);
-)"_zv);
-    work.commit();
+    if (!after) {
+        return ReadBooks(txn.exec_prepared(statements::GET_AUTHOR_BOOKS_PAGE, author_id.ToString(), limit));
+    }
+    return ReadBooks(txn.exec_prepared(statements::GET_AUTHOR_BOOKS_PAGE_AFTER,
+        author_id.ToString(), after->publication_year, after->title, after->book_id.ToString(), limit));
+}
+
+
+Database::Database(const std::string& db_url, size_t pool_size)
+    : pool_{ pool_size, [this, db_url] {
+        auto connection = std::make_shared<pqxx::connection>(db_url);
+        PrepareStatements(*connection, has_trigram_search_);
+        return connection;
+    } } {
+    // Запросы подготавливаются при открытии соединений пула, а PREPARE требует существующих таблиц
+    pqxx::connection connection{db_url};
+    CreateSchema(connection);
+    has_trigram_search_ = CreateTrigramIndex(connection);
 }
-}  // namespace postgres
\ No newline at end of file
+}  // namespace postgres
@@ -2,6 +2,7 @@
 #include <pqxx/connection>
 #include <pqxx/transaction>
 
+#include "connection_pool.h"
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../util/tagged_uuid.h"
@@ -10,8 +11,8 @@ namespace postgres {
 
 class AuthorRepositoryImpl : public domain::AuthorRepository {
 public:
-    explicit AuthorRepositoryImpl(pqxx::connection& connection)
-        : connection_{connection} {
+    explicit AuthorRepositoryImpl(ConnectionPool& pool)
+        : pool_{pool} {
     }
 
     void Save(const domain::Author& author) override;
@@ -22,13 +23,13 @@ public:
 
     void EditName(const domain::AuthorId& author_id, const std::string& new_name) override;
 private:
-    pqxx::connection& connection_;
+    ConnectionPool& pool_;
 };
 
 class BookRepositoryImpl : public domain::BookRepository {
 public:
-    explicit BookRepositoryImpl(pqxx::connection& connection)
-        : connection_{ connection } {
+    explicit BookRepositoryImpl(ConnectionPool& pool)
+        : pool_{ pool } {
     }
 
     void Save(const domain::Book& book) override;
@@ -37,17 +38,33 @@ public:
 
     std::vector<std::pair<domain::Book, std::string>> GetAll() override;
 
-    std::vector<domain::Book> GetAuthorBooks(const domain::AuthorId& author_id);
+    std::vector<domain::Book> GetAuthorBooks(const domain::AuthorId& author_id) override;
+
+    std::vector<std::pair<domain::Book, std::string>> GetPage(const std::optional<domain::BookCursor>& after, size_t limit) override;
+
+    std::vector<domain::Book> GetAuthorBooksPage(const domain::AuthorId& author_id, const std::optional<domain::BookCursor>& after,
+        size_t limit) override;
+
+    std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) override;
 
     void EditBook(const domain::BookId& book_id, const std::optional<std::string>& new_title,
         const std::optional<int>& new_pub_year, const std::vector<std::string>& new_tags) override;
+
+    void EditBooks(const std::vector<domain::BookEdit>& edits) override;
+
+    void SaveBatch(const std::vector<domain::Author>& new_authors, const std::vector<domain::Book>& books) override;
+
+    void ForEachBook(const std::function<void(const domain::Book& book, const std::string& author_name)>& consumer) override;
 private:
-    pqxx::connection& connection_;
+    ConnectionPool& pool_;
 };
 
+// Репозитории берут соединение из пула на время операции, поэтому ими можно пользоваться из нескольких потоков
 class Database {
 public:
-    explicit Database(pqxx::connection connection);
+    static constexpr size_t DEFAULT_POOL_SIZE = 8;
+
+    explicit Database(const std::string& db_url, size_t pool_size = DEFAULT_POOL_SIZE);
 
     AuthorRepositoryImpl& GetAuthors() & {
         return authors_;
@@ -58,9 +75,11 @@ public:
     }
 
 private:
-    pqxx::connection connection_;
-    AuthorRepositoryImpl authors_{connection_};
-    BookRepositoryImpl books_{ connection_ };
+    // Есть ли pg_trgm: без него поиск по названию находит только точные совпадения и совпадения по началу
+    bool has_trigram_search_ = false;
+    ConnectionPool pool_;
+    AuthorRepositoryImpl authors_{pool_};
+    BookRepositoryImpl books_{ pool_ };
 };
 
 }  // namespace postgres
\ No newline at end of file
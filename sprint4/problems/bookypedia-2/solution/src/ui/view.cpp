@@ -3,6 +3,8 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string.hpp>
 #include <cassert>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 
 #include "../app/use_cases.h"
@@ -26,6 +28,27 @@ std::ostream& operator<<(std::ostream& out, const BookInfo& book) {
 
 }  // namespace detail
 
+namespace {
+
+//     ,       
+void PrintProgress(std::ostream& out, size_t rows, std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto rate = elapsed.count() > 0 ? static_cast<size_t>(rows / elapsed.count()) : rows;
+    out << rows << " books, "sv << rate << " rows/s"sv << std::endl;
+}
+
+//      ,  
+void PrintPages(std::ostream& out, app::BookPages pages) {
+    int i = 1;
+    for (auto page = pages.NextPage(); !page.empty(); page = pages.NextPage()) {
+        for (const auto& [book, author_name] : page) {
+            out << i++ << " " << detail::BookInfo{ book.GetTitle(), book.GetBookId().ToString(), author_name, book.GetPublicationYear() } << std::endl;
+        }
+    }
+}
+
+}  // namespace
+
 template <typename T>
 void PrintVector(std::ostream& out, const std::vector<T>& vector) {
     int i = 1;
@@ -34,11 +57,12 @@ void PrintVector(std::ostream& out, const std::vector<T>& vector) {
     }
 }
 
-View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output)
+View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output, size_t page_size)
     : menu_{menu}
     , use_cases_{use_cases}
     , input_{input}
-    , output_{output} {
+    , output_{output}
+    , page_size_{page_size} {
     menu_.AddAction(  //
         "AddAuthor"s, "name"s, "Adds author"s, std::bind(&View::AddAuthor, this, ph::_1)
         // 
@@ -46,13 +70,15 @@ View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std:
     );
     menu_.AddAction("AddBook"s, "<pub year> <title>"s, "Adds book"s, std::bind(&View::AddBook, this, ph::_1));
     menu_.AddAction("ShowAuthors"s, {}, "Show authors"s, std::bind(&View::ShowAuthors, this));
-    menu_.AddAction("ShowBooks"s, {}, "Show books"s, std::bind(&View::ShowBooks, this));
-    menu_.AddAction("ShowAuthorBooks"s, {}, "Show author books"s, std::bind(&View::ShowAuthorBooks, this));
+    menu_.AddAction("ShowBooks"s, "[--page-size N]"s, "Show books"s, std::bind(&View::ShowBooks, this, ph::_1));
+    menu_.AddAction("ShowAuthorBooks"s, "[--page-size N]"s, "Show author books"s, std::bind(&View::ShowAuthorBooks, this, ph::_1));
     menu_.AddAction("DeleteAuthor"s, "name"s, "Delete author and all his books"s, std::bind(&View::DeleteAuthor, this, ph::_1));
     menu_.AddAction("EditAuthor"s, "name"s, "Edit author name"s, std::bind(&View::EditAuthor, this, ph::_1));
     menu_.AddAction("ShowBook"s, "title"s, "Show book information"s, std::bind(&View::ShowBook, this, ph::_1));
     menu_.AddAction("DeleteBook"s, "title"s, "Delete book"s, std::bind(&View::DeleteBook, this, ph::_1));
     menu.AddAction("EditBook"s, "title"s, "Edit book's information"s, std::bind(&View::EditBook, this, ph::_1));
+    menu_.AddAction("ImportCatalog"s, "file"s, "Import books from JSON Lines file"s, std::bind(&View::ImportCatalog, this, ph::_1));
+    menu_.AddAction("ExportCatalog"s, "file"s, "Export all books to JSON Lines file"s, std::bind(&View::ExportCatalog, this, ph::_1));
 }
 
 bool View::AddAuthor(std::istream& cmd_input) const {
@@ -95,10 +121,10 @@ bool View::DeleteBook(std::istream& cmd_input) const {
         boost::algorithm::trim(title);
 
         std::string deleted_book_id;
-        auto books = GetBooks();
         std::optional<int> book_idx;
 
         if (title.empty()) {
+            auto books = GetBooks();
             book_idx = SelectBook(books);
 
             if (!book_idx.has_value()) {
@@ -108,11 +134,7 @@ bool View::DeleteBook(std::istream& cmd_input) const {
             deleted_book_id = books[book_idx.value()].uid;
         }
         else {
-            std::vector<detail::BookInfo> finding_books;
-
-            std::copy_if(books.begin(), books.end(), std::back_inserter(finding_books), [&title](const detail::BookInfo& book) {
-                return book.title == title;
-                });
+            auto finding_books = FindBooksByTitle(title);
 
             if (finding_books.size() == 0) {
                 output_ << "Book not found" << std::endl;
@@ -149,10 +171,10 @@ bool View::EditBook(std::istream& cmd_input) const {
         boost::algorithm::trim(title);
 
         detail::BookInfo book;
-        auto books = GetBooks();
         std::optional<int> book_idx;
 
         if (title.empty()) {
+            auto books = GetBooks();
             book_idx = SelectBook(books);
 
             if (!book_idx.has_value()) {
@@ -162,11 +184,7 @@ bool View::EditBook(std::istream& cmd_input) const {
             book = books[book_idx.value()];
         }
         else {
-            std::vector<detail::BookInfo> finding_books;
-
-            std::copy_if(books.begin(), books.end(), std::back_inserter(finding_books), [&title](const detail::BookInfo& book) {
-                return book.title == title;
-                });
+            auto finding_books = FindBooksByTitle(title);
 
             if (finding_books.size() == 0) {
                 throw std::runtime_error("Book not found");
@@ -263,19 +281,31 @@ bool View::ShowAuthors() const {
     return true;
 }
 
-bool View::ShowBooks() const {
-    PrintVector(output_, GetBooks());
+bool View::ShowBooks(std::istream& cmd_input) const {
+    auto page_size = GetPageSize(cmd_input);
+    if (!page_size) {
+        output_ << "Usage: ShowBooks [--page-size N]" << std::endl;
+        return true;
+    }
+
+    PrintPages(output_, use_cases_.GetBookPages(*page_size));
     return true;
 }
 
-bool View::ShowAuthorBooks() const {
+bool View::ShowAuthorBooks(std::istream& cmd_input) const {
+    auto page_size = GetPageSize(cmd_input);
+    if (!page_size) {
+        output_ << "Usage: ShowAuthorBooks [--page-size N]" << std::endl;
+        return true;
+    }
+
     try {
         if (auto author_id = SelectAuthor()) {
             if (!author_id.has_value()) {
                 return false;
             }
 
-            PrintVector(output_, GetAuthorBooks(*author_id));
+            PrintPages(output_, use_cases_.GetAuthorBookPages(*author_id, *page_size));
         }
     } catch (const std::exception&) {
         throw std::runtime_error("Failed to Show Books");
@@ -353,9 +383,9 @@ bool View::ShowBook(std::istream& cmd_input) const {
         std::getline(cmd_input, title);
         boost::algorithm::trim(title);
 
-        auto books = GetBooks();
         detail::BookInfo book;
         if (title.empty()) {
+            auto books = GetBooks();
             auto book_idx = SelectBook(books);
 
             if (!book_idx.has_value()) {
@@ -365,11 +395,7 @@ bool View::ShowBook(std::istream& cmd_input) const {
             book = books[book_idx.value()];
         }
         else {
-            std::vector<detail::BookInfo> finding_books;
-
-            std::copy_if(books.begin(), books.end(), std::back_inserter(finding_books), [&title](const detail::BookInfo& book){
-                return book.title == title;
-                });
+            auto finding_books = FindBooksByTitle(title);
 
             if (finding_books.size() != 0) {
                 if (finding_books.size() > 1) {
@@ -418,6 +444,57 @@ bool View::ShowBook(std::istream& cmd_input) const {
     return true;
 }
 
+bool View::ImportCatalog(std::istream& cmd_input) const {
+    try {
+        std::string file_name;
+        std::getline(cmd_input, file_name);
+        boost::algorithm::trim(file_name);
+
+        std::ifstream file{ file_name };
+        if (!file) {
+            throw std::runtime_error("Cannot open " + file_name);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto imported = use_cases_.ImportCatalog(file, [this, start](size_t rows) {
+            PrintProgress(output_, rows, start);
+        });
+        output_ << "Imported " << imported << " books" << std::endl;
+    }
+    catch (const std::exception& e) {
+        output_ << "Failed to import catalog: " << e.what() << std::endl;
+    }
+
+    return true;
+}
+
+bool View::ExportCatalog(std::istream& cmd_input) const {
+    try {
+        std::string file_name;
+        std::getline(cmd_input, file_name);
+        boost::algorithm::trim(file_name);
+
+        std::ofstream file{ file_name };
+        if (!file) {
+            throw std::runtime_error("Cannot open " + file_name);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto exported = use_cases_.ExportCatalog(file, [this, start](size_t rows) {
+            PrintProgress(output_, rows, start);
+        });
+        if (!file) {
+            throw std::runtime_error("Cannot write " + file_name);
+        }
+        output_ << "Exported " << exported << " books" << std::endl;
+    }
+    catch (const std::exception& e) {
+        output_ << "Failed to export catalog: " << e.what() << std::endl;
+    }
+
+    return true;
+}
+
 std::optional<std::string> View::GetAuthorIdByName(const std::string& author_name) const {
     auto authors = GetAuthors();
     return GetAuthorIdByName(author_name, authors);
@@ -564,6 +641,39 @@ std::optional<std::string> View::SelectAuthor(std::vector<detail::AuthorInfo>& a
     return authors[author_idx].id;
 }
 
+std::vector<detail::BookInfo> View::FindBooksByTitle(const std::string& title) const {
+    std::vector<detail::BookInfo> books;
+
+    //     ,    .
+    //     limit ,   :      limit
+    for (size_t limit = TITLE_SEARCH_BATCH;; limit *= 2) {
+        books.clear();
+        for (auto& [book, author_name] : use_cases_.SearchBooks(title, limit)) {
+            if (book.GetTitle() != title) {
+                break;
+            }
+            books.emplace_back(detail::BookInfo{ book.GetTitle(), book.GetBookId().ToString(), author_name, book.GetPublicationYear(), book.GetTags() });
+        }
+
+        if (books.size() < limit) {
+            return books;
+        }
+    }
+}
+
+std::optional<size_t> View::GetPageSize(std::istream& cmd_input) const {
+    std::string option;
+    if (!(cmd_input >> option)) {
+        return page_size_;
+    }
+
+    size_t page_size = 0;
+    if (option != "--page-size"sv || !(cmd_input >> page_size) || page_size == 0) {
+        return std::nullopt;
+    }
+    return page_size;
+}
+
 std::vector<detail::AuthorInfo> View::GetAuthors() const {
     std::vector<detail::AuthorInfo> dst_authors;
 
@@ -584,14 +694,4 @@ std::vector<detail::BookInfo> View::GetBooks() const {
     return books;
 }
 
-std::vector<detail::BookInfo> View::GetAuthorBooks(const std::string& author_id) const {
-    std::vector<detail::BookInfo> books;
-    
-    for (auto& book : use_cases_.GetAuthorBooks(author_id)) {
-        books.emplace_back(detail::BookInfo{ book.GetTitle(),"","", book.GetPublicationYear()});
-    }
-
-    return books;
-}
-
 }  // namespace ui
@@ -41,35 +41,46 @@ struct BookInfo {
 
 class View {
 public:
-    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output);
+    static constexpr size_t DEFAULT_PAGE_SIZE = 100;
+    // Сколько результатов поиска по названию запрашивается сначала; книги с одинаковым названием предлагаются все
+    static constexpr size_t TITLE_SEARCH_BATCH = 100;
+
+    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output,
+        size_t page_size = DEFAULT_PAGE_SIZE);
 
 private:
     bool AddAuthor(std::istream& cmd_input) const;
     bool ShowAuthors() const;
-    bool ShowAuthorBooks() const;
+    bool ShowAuthorBooks(std::istream& cmd_input) const;
     bool DeleteAuthor(std::istream& cmd_input) const;
     bool EditAuthor(std::istream& cmd_input) const;
 
     bool AddBook(std::istream& cmd_input) const;
     bool DeleteBook(std::istream& cmd_input) const;
-    bool ShowBooks() const;
+    bool ShowBooks(std::istream& cmd_input) const;
     bool ShowBook(std::istream& cmd_input) const;
     bool EditBook(std::istream& cmd_input) const;
 
+    bool ImportCatalog(std::istream& cmd_input) const;
+    bool ExportCatalog(std::istream& cmd_input) const;
+
     std::optional<detail::AddBookParams> GetBookParams(std::istream& cmd_input) const;
     std::optional<int> SelectBook(std::vector<detail::BookInfo>& authors_info) const;
     std::optional<std::string> SelectAuthor() const;
     std::optional<std::string> SelectAuthor(std::vector<detail::AuthorInfo>& authors_info) const;
     std::optional<std::string> GetAuthorIdByName(const std::string& author_name) const;
     std::optional<std::string> GetAuthorIdByName(const std::string& author_name, std::vector<detail::AuthorInfo>& authors_info) const;
+    // Размер страницы из "--page-size N", без параметра - заданный при запуске; nullopt при ошибке
+    std::optional<size_t> GetPageSize(std::istream& cmd_input) const;
     std::vector<detail::AuthorInfo> GetAuthors() const;
     std::vector<detail::BookInfo> GetBooks() const;
-    std::vector<detail::BookInfo> GetAuthorBooks(const std::string& author_id) const;
+    std::vector<detail::BookInfo> FindBooksByTitle(const std::string& title) const;
 
     menu::Menu& menu_;
     app::UseCases& use_cases_;
     std::istream& input_;
     std::ostream& output_;
+    size_t page_size_;
 };
 
 }  // namespace ui
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "title_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+namespace util {
+
+namespace {
+
+std::string ToLower(std::string_view str) {
+    std::string result(str);
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return result;
+}
+
+// Байты не-ASCII символов считаются буквами, чтобы кириллица не рвала слова
+bool IsWordChar(unsigned char c) {
+    return c >= 0x80 || std::isalnum(c);
+}
+
+// Как в pg_trgm: слова в нижнем регистре дополняются двумя пробелами слева и одним справа
+std::vector<std::string> MakeTrigrams(std::string_view lower) {
+    std::vector<std::string> trigrams;
+    for (size_t i = 0; i < lower.size();) {
+        if (!IsWordChar(lower[i])) {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while (end < lower.size() && IsWordChar(lower[end])) {
+            ++end;
+        }
+        const std::string word = "  " + std::string(lower.substr(i, end - i)) + " ";
+        for (size_t j = 0; j + 3 <= word.size(); ++j) {
+            trigrams.push_back(word.substr(j, 3));
+        }
+        i = end;
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+}  // namespace
+
+void TitleIndex::Add(const std::string& id, const std::string& title) {
+    Remove(id);
+
+    // Слоты удалённых записей занимаются заново, поэтому правки не растят entries_
+    size_t slot = entries_.size();
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        entries_.emplace_back();
+    }
+
+    auto lower_title = ToLower(title);
+    auto trigrams = MakeTrigrams(lower_title);
+    for (const auto& trigram : trigrams) {
+        postings_[trigram].push_back(slot);
+    }
+    by_lower_title_.emplace(lower_title, slot);
+    slots_.emplace(id, slot);
+    entries_[slot] = { id, title, std::move(lower_title), std::move(trigrams) };
+}
+
+void TitleIndex::Remove(const std::string& id) {
+    const auto slot_it = slots_.find(id);
+    if (slot_it == slots_.end()) {
+        return;
+    }
+    const size_t slot = slot_it->second;
+    slots_.erase(slot_it);
+
+    auto& entry = entries_[slot];
+    for (const auto& trigram : entry.trigrams) {
+        auto posting = postings_.find(trigram);
+        auto& slots = posting->second;
+        slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+        if (slots.empty()) {
+            postings_.erase(posting);
+        }
+    }
+    auto [first, last] = by_lower_title_.equal_range(entry.lower_title);
+    for (auto it = first; it != last; ++it) {
+        if (it->second == slot) {
+            by_lower_title_.erase(it);
+            break;
+        }
+    }
+    entry = {};
+    free_slots_.push_back(slot);
+}
+
+std::vector<std::string> TitleIndex::Search(std::string_view query, size_t limit) const {
+    const auto lower_query = ToLower(query);
+    const auto query_trigrams = MakeTrigrams(lower_query);
+
+    // Слот -> число общих с запросом триграмм
+    std::unordered_map<size_t, size_t> shared;
+    for (const auto& trigram : query_trigrams) {
+        if (auto posting = postings_.find(trigram); posting != postings_.end()) {
+            for (size_t slot : posting->second) {
+                ++shared[slot];
+            }
+        }
+    }
+    if (!lower_query.empty()) {
+        for (auto it = by_lower_title_.lower_bound(lower_query);
+            it != by_lower_title_.end() && it->first.compare(0, lower_query.size(), lower_query) == 0; ++it) {
+            shared.try_emplace(it->second, 0);
+        }
+    }
+
+    struct Match {
+        int tier;
+        double similarity;
+        const Entry* entry;
+    };
+    std::vector<Match> matches;
+    for (const auto& [slot, count] : shared) {
+        const auto& entry = entries_[slot];
+        const size_t total = query_trigrams.size() + entry.trigrams.size() - count;
+        const double similarity = total == 0 ? 0. : static_cast<double>(count) / total;
+
+        int tier = 2;
+        if (entry.title == query) {
+            tier = 0;
+        } else if (!lower_query.empty() && entry.lower_title.compare(0, lower_query.size(), lower_query) == 0) {
+            tier = 1;
+        } else if (similarity < SIMILARITY_THRESHOLD) {
+            continue;
+        }
+        matches.push_back({ tier, similarity, &entry });
+    }
+
+    const auto middle = matches.begin() + std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), middle, matches.end(), [](const Match& lhs, const Match& rhs) {
+        // Похожесть по убыванию, при равенстве - по названию, как ORDER BY в БД
+        return std::tie(lhs.tier, rhs.similarity, lhs.entry->title, lhs.entry->id)
+            < std::tie(rhs.tier, lhs.similarity, rhs.entry->title, rhs.entry->id);
+    });
+
+    std::vector<std::string> ids;
+    ids.reserve(middle - matches.begin());
+    for (auto it = matches.begin(); it != middle; ++it) {
+        ids.push_back(it->entry->id);
+    }
+    return ids;
+}
+
+}  // namespace util
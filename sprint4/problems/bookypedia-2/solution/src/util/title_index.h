@@ -0,0 +1,53 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace util {
+
+/*
+ * Поиск по названиям в памяти с тем же ранжированием, что у поиска в БД через pg_trgm:
+ * сначала точное совпадение, затем названия с таким началом (без учёта регистра),
+ * затем похожие по триграммам не меньше чем на SIMILARITY_THRESHOLD.
+ * Кандидаты берутся из индексов, а не перебором всех названий.
+ */
+class TitleIndex {
+public:
+    // Порог по умолчанию у оператора % в pg_trgm
+    static constexpr double SIMILARITY_THRESHOLD = 0.3;
+
+    void Add(const std::string& id, const std::string& title);
+    void Remove(const std::string& id);
+
+    // id не больше чем limit лучших совпадений, лучшие первыми
+    std::vector<std::string> Search(std::string_view query, size_t limit) const;
+
+    size_t Size() const noexcept {
+        return slots_.size();
+    }
+
+    // Занятые и свободные слоты: не больше наибольшего числа записей, когда-либо бывших в индексе одновременно
+    size_t SlotCount() const noexcept {
+        return entries_.size();
+    }
+
+private:
+    struct Entry {
+        std::string id;
+        std::string title;
+        std::string lower_title;
+        std::vector<std::string> trigrams;
+    };
+
+    std::vector<Entry> entries_;
+    // Слоты entries_, освобождённые Remove
+    std::vector<size_t> free_slots_;
+    std::unordered_map<std::string, size_t> slots_;
+    std::unordered_map<std::string, std::vector<size_t>> postings_;
+    std::multimap<std::string, size_t> by_lower_title_;
+};
+
+}  // namespace util
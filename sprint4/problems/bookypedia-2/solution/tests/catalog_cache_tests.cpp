@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/cache/catalog_cache.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Считает чтения, чтобы видеть, когда кэш обращается к исходному репозиторию
+struct CountingAuthorRepository : domain::AuthorRepository {
+    std::vector<domain::Author> authors;
+    int reads = 0;
+
+    void Save(const domain::Author& author) override {
+        authors.push_back(author);
+    }
+
+    std::vector<domain::Author> GetAll() override {
+        ++reads;
+        return authors;
+    }
+
+    void Delete(const domain::AuthorId&) override {
+    }
+
+    void EditName(const domain::AuthorId&, const std::string&) override {
+    }
+};
+
+struct CountingBookRepository : domain::BookRepository {
+    std::vector<domain::Book> books;
+    int reads = 0;
+
+    void Save(const domain::Book& book) override {
+        books.push_back(book);
+    }
+
+    void Delete(const domain::BookId&) override {
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> GetAll() override {
+        return {};
+    }
+
+    std::vector<domain::Book> GetAuthorBooks(const domain::AuthorId& author_id) override {
+        ++reads;
+        std::vector<domain::Book> result;
+        for (const auto& book : books) {
+            if (book.GetAuthorId() == author_id) {
+                result.push_back(book);
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> GetPage(const std::optional<domain::BookCursor>&, size_t) override {
+        return {};
+    }
+
+    std::vector<domain::Book> GetAuthorBooksPage(const domain::AuthorId&, const std::optional<domain::BookCursor>&, size_t) override {
+        return {};
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string&, size_t) override {
+        return {};
+    }
+
+    void EditBook(const domain::BookId&, const std::optional<std::string>&, const std::optional<int>&, const std::vector<std::string>&) override {
+    }
+
+    void EditBooks(const std::vector<domain::BookEdit>&) override {
+    }
+
+    void SaveBatch(const std::vector<domain::Author>&, const std::vector<domain::Book>&) override {
+    }
+
+    void ForEachBook(const std::function<void(const domain::Book&, const std::string&)>&) override {
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Author list is read once until the catalog changes") {
+    CountingAuthorRepository source;
+    cache::CatalogVersion version;
+    cache::CachingAuthorRepository authors{ source, version };
+
+    authors.Save(domain::Author{ domain::AuthorId::New(), "Pushkin"s });
+    CHECK(authors.GetAll().size() == 1);
+    CHECK(authors.GetAll().size() == 1);
+    CHECK(source.reads == 1);
+
+    authors.Save(domain::Author{ domain::AuthorId::New(), "Gogol"s });
+    CHECK(authors.GetAll().size() == 2);
+    CHECK(source.reads == 2);
+
+    // Запись другим процессом: кэш узнаёт о ней только через версию
+    source.Save(domain::Author{ domain::AuthorId::New(), "Tolstoy"s });
+    CHECK(authors.GetAll().size() == 2);
+    version.Invalidate();
+    CHECK(authors.GetAll().size() == 3);
+    CHECK(source.reads == 3);
+}
+
+TEST_CASE("Author books are cached per author and dropped by any write") {
+    CountingAuthorRepository author_source;
+    CountingBookRepository book_source;
+    cache::CatalogVersion version;
+    cache::CachingAuthorRepository authors{ author_source, version };
+    cache::CachingBookRepository books{ book_source, version };
+
+    const auto pushkin = domain::AuthorId::New();
+    const auto gogol = domain::AuthorId::New();
+    books.Save(domain::Book{ domain::BookId::New(), pushkin, "Onegin"s, 1833, {} });
+
+    CHECK(books.GetAuthorBooks(pushkin).size() == 1);
+    CHECK(books.GetAuthorBooks(gogol).empty());
+    CHECK(books.GetAuthorBooks(pushkin).size() == 1);
+    CHECK(book_source.reads == 2);
+
+    // Книги показываются с именами авторов, поэтому правка автора тоже сбрасывает кэш книг
+    authors.EditName(pushkin, "A. Pushkin"s);
+    CHECK(books.GetAuthorBooks(pushkin).size() == 1);
+    CHECK(book_source.reads == 3);
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/util/title_index.h"
+
+using namespace std::literals;
+using util::TitleIndex;
+
+namespace {
+
+TitleIndex MakeIndex() {
+    TitleIndex index;
+    index.Add("1", "War and Peace");
+    index.Add("2", "war");
+    index.Add("3", "War");
+    index.Add("4", "Anna Karenina");
+    index.Add("5", "Warlock");
+    return index;
+}
+
+}  // namespace
+
+TEST_CASE("Exact match goes first, then prefix matches") {
+    auto index = MakeIndex();
+    CHECK(index.Search("War", 10) == std::vector{ "3"s, "2"s, "5"s, "1"s });
+    CHECK(index.Search("War", 2) == std::vector{ "3"s, "2"s });
+}
+
+TEST_CASE("Misspelled title is found by trigram similarity") {
+    auto index = MakeIndex();
+    CHECK(index.Search("Ana Karenina", 10) == std::vector{ "4"s });
+    CHECK(index.Search("Karenina", 10) == std::vector{ "4"s });
+    CHECK(index.Search("Dead Souls", 10).empty());
+}
+
+TEST_CASE("Removed and replaced titles") {
+    auto index = MakeIndex();
+    index.Remove("3");
+    index.Add("5", "Anna");
+    CHECK(index.Size() == 4);
+    CHECK(index.Search("War", 10) == std::vector{ "2"s, "1"s });
+    CHECK(index.Search("Anna", 10) == std::vector{ "5"s, "4"s });
+}
+
+TEST_CASE("Freed slots are reused by later titles") {
+    auto index = MakeIndex();
+    for (int i = 0; i < 100; ++i) {
+        index.Add("1", i % 2 == 0 ? "Dead Souls" : "War and Peace");
+        index.Remove("2");
+        index.Add("2", "war");
+    }
+    CHECK(index.SlotCount() == 5);
+    CHECK(index.Search("War", 10) == std::vector{ "3"s, "2"s, "5"s, "1"s });
+    CHECK(index.Search("Dead Souls", 10).empty());
+}
@@ -0,0 +1,274 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/author.h"
+#include "../src/domain/book.h"
+#include "../src/util/title_index.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct MockAuthorRepository : domain::AuthorRepository {
+    std::vector<domain::Author> saved_authors;
+
+    void Save(const domain::Author& author) override {
+        saved_authors.emplace_back(author);
+    }
+
+    std::vector<domain::Author> GetAll() override {
+        return saved_authors;
+    }
+
+    void Delete(const domain::AuthorId&) override {
+    }
+
+    void EditName(const domain::AuthorId&, const std::string&) override {
+    }
+};
+
+// Пачки импорта пишут и авторов, и книги - как общие таблицы в БД
+struct MockBookRepository : domain::BookRepository {
+    explicit MockBookRepository(MockAuthorRepository& authors)
+        : authors{ authors } {
+    }
+
+    MockAuthorRepository& authors;
+    std::vector<domain::Book> saved_books;
+    std::vector<size_t> batch_sizes;
+    std::vector<size_t> page_limits;
+    util::TitleIndex titles;
+
+    void Save(const domain::Book& book) override {
+        saved_books.emplace_back(book);
+        titles.Add(book.GetBookId().ToString(), book.GetTitle());
+    }
+
+    void Delete(const domain::BookId&) override {
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> GetAll() override {
+        return {};
+    }
+
+    std::vector<domain::Book> GetAuthorBooks(const domain::AuthorId&) override {
+        return {};
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> GetPage(const std::optional<domain::BookCursor>& after, size_t limit) override {
+        page_limits.push_back(limit);
+
+        // Тот же порядок и то же условие, что у запроса к БД
+        auto key = [](const domain::BookCursor& cursor) {
+            return std::make_tuple(cursor.title, cursor.author_name, cursor.publication_year, cursor.book_id.ToString());
+        };
+        std::vector<std::pair<domain::BookCursor, std::pair<domain::Book, std::string>>> books;
+        for (const auto& book : saved_books) {
+            const auto& author_name = GetAuthorName(book);
+            domain::BookCursor cursor{ book.GetTitle(), author_name, book.GetPublicationYear(), book.GetBookId() };
+            if (!after || key(*after) < key(cursor)) {
+                books.emplace_back(std::move(cursor), std::pair{ book, author_name });
+            }
+        }
+        std::sort(books.begin(), books.end(), [&key](const auto& lhs, const auto& rhs) {
+            return key(lhs.first) < key(rhs.first);
+        });
+
+        std::vector<std::pair<domain::Book, std::string>> page;
+        for (size_t i = 0; i < books.size() && i < limit; ++i) {
+            page.push_back(std::move(books[i].second));
+        }
+        return page;
+    }
+
+    std::vector<domain::Book> GetAuthorBooksPage(const domain::AuthorId&, const std::optional<domain::BookCursor>&, size_t) override {
+        return {};
+    }
+
+    std::vector<std::pair<domain::Book, std::string>> SearchBooks(const std::string& query, size_t limit) override {
+        std::vector<std::pair<domain::Book, std::string>> found;
+        for (const auto& id : titles.Search(query, limit)) {
+            auto book = std::find_if(saved_books.begin(), saved_books.end(), [&id](const domain::Book& book) {
+                return book.GetBookId().ToString() == id;
+            });
+            found.emplace_back(*book, GetAuthorName(*book));
+        }
+        return found;
+    }
+
+    void EditBook(const domain::BookId&, const std::optional<std::string>&, const std::optional<int>&, const std::vector<std::string>&) override {
+    }
+
+    void EditBooks(const std::vector<domain::BookEdit>&) override {
+    }
+
+    void SaveBatch(const std::vector<domain::Author>& new_authors, const std::vector<domain::Book>& books) override {
+        for (const auto& author : new_authors) {
+            authors.Save(author);
+        }
+        for (const auto& book : books) {
+            Save(book);
+        }
+        batch_sizes.push_back(books.size());
+    }
+
+    void ForEachBook(const std::function<void(const domain::Book& book, const std::string& author_name)>& consumer) override {
+        for (const auto& book : saved_books) {
+            consumer(book, GetAuthorName(book));
+        }
+    }
+
+    const std::string& GetAuthorName(const domain::Book& book) const {
+        auto author = std::find_if(authors.saved_authors.begin(), authors.saved_authors.end(), [&book](const domain::Author& author) {
+            return author.GetId() == book.GetAuthorId();
+        });
+        return author->GetName();
+    }
+};
+
+struct Fixture {
+    MockAuthorRepository authors;
+    MockBookRepository books{ authors };
+};
+
+}  // namespace
+
+SCENARIO_METHOD(Fixture, "Catalog import") {
+    GIVEN("Use cases with an existing author") {
+        app::UseCasesImpl use_cases{ authors, books, 2 };
+        use_cases.AddAuthor("Pushkin");
+        const auto pushkin_id = authors.saved_authors.front().GetId();
+
+        WHEN("a catalog is imported") {
+            std::istringstream input{
+                R"({"title": "Onegin", "author": "Pushkin", "publication_year": 1833, "tags": ["novel", " poem ", "novel", ""]})" "\n"
+                "\n"
+                R"({"title": "Dead Souls", "author": "Gogol", "publication_year": 1842})" "\n"
+                R"({"title": "The Nose", "author": "Gogol", "publication_year": 1836, "tags": []})" "\n"
+            };
+            std::vector<size_t> progress;
+            auto imported = use_cases.ImportCatalog(input, [&progress](size_t rows) {
+                progress.push_back(rows);
+            });
+
+            THEN("books are saved in batches and progress is reported per batch") {
+                CHECK(imported == 3);
+                CHECK(books.batch_sizes == std::vector<size_t>{ 2, 1 });
+                CHECK(progress == std::vector<size_t>{ 2, 3 });
+            }
+
+            THEN("known authors are reused and each new author is added once") {
+                REQUIRE(authors.saved_authors.size() == 2);
+                CHECK(authors.saved_authors[1].GetName() == "Gogol");
+                CHECK(books.saved_books[0].GetAuthorId() == pushkin_id);
+                CHECK(books.saved_books[1].GetAuthorId() == authors.saved_authors[1].GetId());
+                CHECK(books.saved_books[2].GetAuthorId() == authors.saved_authors[1].GetId());
+            }
+
+            THEN("tags are trimmed, deduplicated and sorted") {
+                CHECK(books.saved_books[0].GetTags() == std::vector{ "novel"s, "poem"s });
+                CHECK(books.saved_books[1].GetTags().empty());
+            }
+
+            AND_WHEN("the catalog is exported") {
+                std::ostringstream output;
+                auto exported = use_cases.ExportCatalog(output, {});
+
+                THEN("importing the export into an empty catalog gives the same books") {
+                    CHECK(exported == 3);
+
+                    Fixture copy;
+                    app::UseCasesImpl copy_use_cases{ copy.authors, copy.books };
+                    std::istringstream exported_input{ output.str() };
+                    CHECK(copy_use_cases.ImportCatalog(exported_input, {}) == 3);
+
+                    REQUIRE(copy.books.saved_books.size() == 3);
+                    for (size_t i = 0; i < 3; ++i) {
+                        CHECK(copy.books.saved_books[i].GetTitle() == books.saved_books[i].GetTitle());
+                        CHECK(copy.books.saved_books[i].GetPublicationYear() == books.saved_books[i].GetPublicationYear());
+                        CHECK(copy.books.saved_books[i].GetTags() == books.saved_books[i].GetTags());
+                    }
+                    CHECK(copy.authors.saved_authors.size() == 2);
+                }
+            }
+        }
+
+        WHEN("a line is malformed") {
+            std::istringstream input{
+                R"({"title": "Onegin", "author": "Pushkin", "publication_year": 1833})" "\n"
+                R"({"title": "", "author": "Gogol", "publication_year": 1842})" "\n"
+            };
+
+            THEN("import stops with the line number") {
+                CHECK_THROWS_WITH(use_cases.ImportCatalog(input, {}), "line 2: empty title or author");
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Book list pages") {
+    GIVEN("A catalog with books sharing titles and authors") {
+        app::UseCasesImpl use_cases{ authors, books };
+        use_cases.AddAuthor("Pushkin");
+        use_cases.AddAuthor("Gogol");
+        const auto pushkin_id = authors.saved_authors[0].GetId().ToString();
+        const auto gogol_id = authors.saved_authors[1].GetId().ToString();
+        for (int i = 0; i < 3; ++i) {
+            use_cases.AddBook(pushkin_id, "Tales", 1830 + i, {});
+            use_cases.AddBook(gogol_id, "Tales", 1830, {});
+        }
+        use_cases.AddBook(gogol_id, "Dead Souls", 1842, {});
+
+        WHEN("the list is read by pages") {
+            auto pages = use_cases.GetBookPages(3);
+            std::vector<std::vector<std::pair<domain::Book, std::string>>> read_pages;
+            for (auto page = pages.NextPage(); !page.empty(); page = pages.NextPage()) {
+                read_pages.push_back(std::move(page));
+            }
+
+            THEN("pages together give the whole list in order without repeats") {
+                std::vector<std::pair<std::string, std::string>> read;
+                for (const auto& page : read_pages) {
+                    for (const auto& [book, author_name] : page) {
+                        read.emplace_back(book.GetTitle(), author_name);
+                    }
+                }
+                CHECK(read == std::vector<std::pair<std::string, std::string>>{
+                    { "Dead Souls"s, "Gogol"s }, { "Tales"s, "Gogol"s }, { "Tales"s, "Gogol"s },
+                    { "Tales"s, "Gogol"s }, { "Tales"s, "Pushkin"s }, { "Tales"s, "Pushkin"s }, { "Tales"s, "Pushkin"s } });
+                CHECK(read_pages.size() == 3);
+            }
+
+            THEN("repository is not asked again after a short page") {
+                CHECK(books.page_limits == std::vector<size_t>{ 3, 3, 3 });
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(Fixture, "Book search") {
+    GIVEN("A catalog") {
+        app::UseCasesImpl use_cases{ authors, books };
+        use_cases.AddAuthor("Tolstoy");
+        const auto tolstoy_id = authors.saved_authors[0].GetId().ToString();
+        use_cases.AddBook(tolstoy_id, "War and Peace", 1869, { "novel" });
+        use_cases.AddBook(tolstoy_id, "War", 1900, {});
+        use_cases.AddBook(tolstoy_id, "Anna Karenina", 1878, {});
+
+        WHEN("books are searched by title") {
+            auto found = use_cases.SearchBooks("War", 10);
+
+            THEN("exact match goes first, then titles starting with the query") {
+                REQUIRE(found.size() == 2);
+                CHECK(found[0].first.GetTitle() == "War");
+                CHECK(found[1].first.GetTitle() == "War and Peace");
+                CHECK(found[1].first.GetTags() == std::vector{ "novel"s });
+                CHECK(found[1].second == "Tolstoy");
+            }
+        }
+    }
+}
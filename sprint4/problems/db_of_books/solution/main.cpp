@@ -1,11 +1,21 @@
 #include "boost/json.hpp"
 #include <pqxx/pqxx>
 
+#include <optional>
 #include <stdexcept>
 #include <iostream>
+#include <string_view>
+#include <vector>
 
 namespace json = boost::json;
 
+struct BookData {
+    std::string title;
+    std::string author;
+    int year = 0;
+    std::string isbn;
+};
+
 class DBManager {
 public:
     DBManager(const std::string& connection_str) {
@@ -53,81 +63,184 @@ public:
         }
     }
 
-    std::vector<std::tuple<int, std::string, std::string, int, std::string>> getAllBooks() {
-        pqxx::work W(*conn);
+    //     -   addBook,         .
+    //  ISBN (     )    ;   
+    //       ,     .
+    // ISBN   varchar:    char(13)    ,
+    //        ,  addBook.
+    std::vector<bool> addBooks(const std::vector<BookData>& books) {
+        std::vector<std::string> titles, authors;
+        std::vector<int> years;
+        std::vector<std::optional<std::string>> isbns;
+        for (const auto& book : books) {
+            titles.push_back(book.title);
+            authors.push_back(book.author);
+            years.push_back(book.year);
+            isbns.push_back(book.isbn.empty() ? std::nullopt : std::optional{ book.isbn });
+        }
 
-        pqxx::result R = W.exec("SELECT id, title, author, year, ISBN FROM books "
-            "ORDER BY year DESC, title ASC, author ASC, ISBN ASC");
-        W.commit();
+        try {
+            pqxx::work W(*conn);
+            auto R = W.exec_params(R"(
+WITH input AS (
+    SELECT * FROM unnest($1::varchar[], $2::varchar[], $3::int[], $4::varchar[])
+        WITH ORDINALITY AS t(title, author, year, isbn, n)
+), ranked AS (
+    SELECT *, row_number() OVER (PARTITION BY isbn ORDER BY n) AS isbn_rank FROM input
+), accepted AS (
+    SELECT * FROM ranked r
+    WHERE r.isbn IS NULL OR (r.isbn_rank = 1 AND NOT EXISTS (SELECT 1 FROM books b WHERE b.ISBN = r.isbn))
+), inserted AS (
+    INSERT INTO books (title, author, year, ISBN)
+    SELECT title, author, year, isbn FROM accepted ORDER BY n
+)
+SELECT n FROM accepted
+)", titles, authors, years, isbns);
+            W.commit();
 
-        std::vector<std::tuple<int, std::string, std::string, int, std::string>> books;
+            std::vector<bool> results(books.size(), false);
+            for (const auto& row : R) {
+                results[row[0].as<size_t>() - 1] = true;
+            }
+            return results;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Batch failed, adding books one by one: " << e.what() << std::endl;
+        }
+
+        std::vector<bool> results;
+        for (const auto& book : books) {
+            results.push_back(addBook(book.title, book.author, book.year, book.isbn));
+        }
+        return results;
+    }
+
+    //    COPY   out,      
+    void printAllBooks(std::ostream& out) {
+        pqxx::work W(*conn);
 
-        for (const auto& row : R) {
-            books.emplace_back(
-                row[0].as<int>(),
-                row[1].as<std::string>(),
-                row[2].as<std::string>(),
-                row[3].as<int>(),
-                row[4].is_null() ? "" : row[4].as<std::string>() //   NULL
-            );
+        out << '[';
+        bool is_first = true;
+        for (auto [id, title, author, year, isbn] : W.stream<int, std::string_view, std::string_view, int, std::optional<std::string>>(
+            "SELECT id, title, author, year, ISBN FROM books "
+            "ORDER BY year DESC, title ASC, author ASC, ISBN ASC")) {
+            if (!is_first) {
+                out << ',';
+            }
+            is_first = false;
+
+            json::object book{
+                {"id", id},
+                {"title", title},
+                {"author", author},
+                {"year", year},
+                {"ISBN", isbn ? json::value(*isbn) : json::value()} //   NULL
+            };
+            out << json::serialize(book);
         }
+        out << ']' << std::endl;
 
-        return books;
+        W.commit();
     }
 private:
     pqxx::connection* conn;
 };
 
-void processRequest(DBManager& db, const std::string& request) {
-    auto req = json::parse(request).as_object();
-    std::string action = json::value_to<std::string>(req["action"]);
-    auto payload = req["payload"].as_object();
-
-    if (action == "add_book") {
-        std::string title = json::value_to<std::string>(payload["title"]);
-        std::string author = json::value_to<std::string>(payload["author"]);
-        int year = json::value_to<int>(payload["year"]);
-        std::string isbn = payload["ISBN"].is_null() ? "" : json::value_to<std::string>(payload["ISBN"]);
+BookData parseBook(json::object& payload) {
+    BookData book;
+    book.title = json::value_to<std::string>(payload["title"]);
+    book.author = json::value_to<std::string>(payload["author"]);
+    book.year = json::value_to<int>(payload["year"]);
+    book.isbn = payload["ISBN"].is_null() ? "" : json::value_to<std::string>(payload["ISBN"]);
+    return book;
+}
 
-        bool result = db.addBook(title, author, year, isbn);
-        json::object response = { {"result", result} };
-        std::cout << json::serialize(response) << std::endl;
+void printResult(bool result) {
+    json::object response = { {"result", result} };
+    std::cout << json::serialize(response) << '\n';
+}
 
+//   add_book   batch_size    .
+//    :           ,
+//              .
+class RequestProcessor {
+public:
+    RequestProcessor(DBManager& db, size_t batch_size)
+        : db(db)
+        , batch_size(batch_size) {
     }
-    else if (action == "all_books") {
-        auto books = db.getAllBooks();
-        json::array response;
 
-        for (const auto& book : books) {
-            response.push_back({
-                {"id", std::get<0>(book)},
-                {"title", std::get<1>(book)},
-                {"author", std::get<2>(book)},
-                {"year", std::get<3>(book)},
-                {"ISBN", std::get<4>(book).empty() ? json::value() : json::value(std::get<4>(book))}
-                });
+    void process(const std::string& request) {
+        auto req = json::parse(request).as_object();
+        std::string action = json::value_to<std::string>(req["action"]);
+        auto payload = req["payload"].as_object();
+
+        if (action == "add_book") {
+            auto book = parseBook(payload);
+            if (batch_size <= 1) {
+                printResult(db.addBook(book.title, book.author, book.year, book.isbn));
+                std::cout.flush();
+                return;
+            }
+            pending.push_back(std::move(book));
+            if (pending.size() >= batch_size) {
+                flush();
+            }
+            return;
         }
-        std::cout << json::serialize(response) << std::endl;
 
+        flush();
+        if (action == "all_books") {
+            db.printAllBooks(std::cout);
+        }
+        else if (action == "exit") {
+            exit(0);
+        }
     }
-    else if (action == "exit") {
-        exit(0);
+
+    void flush() {
+        if (pending.empty()) {
+            return;
+        }
+        for (bool result : db.addBooks(pending)) {
+            printResult(result);
+        }
+        std::cout.flush();
+        pending.clear();
     }
-}
+
+private:
+    DBManager& db;
+    size_t batch_size;
+    std::vector<BookData> pending;
+};
 
 int main(int argc, char* argv[]) {
+    //  in_avail   ,     ;    -
+    std::ios::sync_with_stdio(false);
+
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <connection_string>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <connection_string> [--batch-size N]" << std::endl;
         return 1;
     }
 
     std::string connection_str = argv[1];
+    size_t batch_size = 1;
+    if (argc >= 4 && argv[2] == std::string_view("--batch-size")) {
+        batch_size = std::stoul(argv[3]);
+    }
+
     DBManager db(connection_str);
+    RequestProcessor processor(db, batch_size);
 
     std::string request;
     while (std::getline(std::cin, request)) {
-        processRequest(db, request);
+        processor.process(request);
+        if (std::cin.rdbuf()->in_avail() <= 0) {
+            processor.flush();
+        }
     }
+    processor.flush();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,26 @@
+#!/bin/bash
+# Сравнивает режимы --threading-mode под одной и той же нагрузкой load_generator
+# (sprint3/problems/flamegraph/solution). Запуск из каталога сборки:
+#   ../bench/compare_threading_modes.sh [rate] [duration]
+set -e
+
+RATE=${1:-20000}
+DURATION=${2:-20}
+SERVER=${SERVER:-bin/game_server}
+CONFIG=${CONFIG:-../data/config.json}
+WWW_ROOT=${WWW_ROOT:-../static}
+LOAD_GENERATOR=${LOAD_GENERATOR:-../../../../sprint3/problems/flamegraph/solution/build/bin/load_generator}
+SCENARIO=${SCENARIO:-../../../../sprint3/problems/flamegraph/solution/scenarios/game.txt}
+THREADS=${THREADS:-$(( $(nproc) / 2 > 0 ? $(nproc) / 2 : 1 ))}
+
+for mode in "shared" "per-core" "per-core --pin-threads"; do
+    $SERVER --config-file "$CONFIG" --www-root "$WWW_ROOT" --tick-period 50 --threading-mode $mode > /dev/null &
+    server_pid=$!
+
+    echo "=== --threading-mode $mode"
+    $LOAD_GENERATOR --scenario "$SCENARIO" --rate "$RATE" --duration "$DURATION" --threads "$THREADS" \
+        --wait-for-server 5000 | grep -E "^Throughput|^Latency|^  min" | head -3
+
+    kill $server_pid
+    wait $server_pid || true
+done
@@ -0,0 +1,265 @@
+#include "synthetic_maps.h"
+#include "serialization.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace application::game;
+
+namespace {
+    constexpr double TICK_SECONDS = 0.05;
+    constexpr int TICK_MS = 50;
+    constexpr unsigned SEED = 42;
+
+    struct SessionFixture {
+        SessionFixture(int grid_cells, size_t players, size_t loots)
+            : map(bench::MakeGridMap(grid_cells))
+            , session(std::make_unique<GameSession>(map, true, bench::MakeLootGenerator()))
+            , target_loots(loots) {
+            bench::PopulateSession(*session, players, loots);
+            this->players = session->GetPlayersVector();
+        }
+
+        // Собранные трофеи убираются с карты: подсыпаем, чтобы плотность не падала от итерации к итерации
+        void RestockLoot() {
+            const auto& session_map = *session->GetMap();
+            for (size_t i = session->GetLoots().size(); i < target_loots; ++i) {
+                session->AddLoot(loot::Loot(session_map.GetRandomPosition(), utils::GetRandomInteger(session_map.GetLootTypesCount() - 1)));
+            }
+        }
+
+        bool IsLootDepleted() const {
+            return session->GetLoots().size() < target_loots / 2;
+        }
+
+        map::Map map;
+        std::unique_ptr<GameSession> session;
+        std::vector<player::Player*> players;
+        size_t target_loots;
+    };
+
+    std::unique_ptr<Game> MakeGame(const map::Map& map, size_t players, size_t loots) {
+        auto game = std::make_unique<Game>(true, bench::MakeLootGenerator());
+        game->AddMap(map);
+
+        const auto* game_map = game->GetMap(map.GetId());
+        for (size_t i = 0; i < players; ++i) {
+            std::string name = "dog" + std::to_string(i);
+            game->AddPlayer(game_map, name);
+        }
+
+        auto& session = game->GetSessions().at(map.GetId()).front();
+        for (size_t i = 0; i < loots; ++i) {
+            session.AddLoot(loot::Loot(game_map->GetRandomPosition(), utils::GetRandomInteger(game_map->GetLootTypesCount() - 1)));
+        }
+
+        return game;
+    }
+}
+
+static void BM_PlayerMove(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    SessionFixture fixture(static_cast<int>(state.range(0)), state.range(1), 0);
+
+    for (auto _ : state) {
+        bench::KeepPlayersMoving(fixture.players);
+        for (auto* player : fixture.players) {
+            benchmark::DoNotOptimize(player->Move(TICK_SECONDS));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * fixture.players.size());
+}
+BENCHMARK(BM_PlayerMove)->ArgNames({ "grid", "players" })->ArgsProduct({ { 10, 100 }, { 10, 100, 1000 } });
+
+static void BM_GameSessionProcessTick(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    SessionFixture fixture(50, state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        if (fixture.IsLootDepleted()) {
+            state.PauseTiming();
+            fixture.RestockLoot();
+            state.ResumeTiming();
+        }
+
+        bench::KeepPlayersMoving(fixture.players);
+        fixture.session->ProcessTick(TICK_MS);
+    }
+
+    state.SetItemsProcessed(state.iterations() * fixture.players.size());
+}
+BENCHMARK(BM_GameSessionProcessTick)->ArgNames({ "players", "loots" })->ArgsProduct({ { 10, 100, 1000 }, { 10, 100, 1000 } });
+
+static void BM_GameSessionCollectEvents(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    SessionFixture fixture(50, state.range(0), state.range(1));
+    size_t events = 0;
+
+    for (auto _ : state) {
+        bench::KeepPlayersMoving(fixture.players);
+        auto collected = fixture.session->CollectEvents(TICK_SECONDS);
+        events += collected.size();
+        benchmark::DoNotOptimize(collected.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * fixture.players.size());
+    state.counters["events"] = benchmark::Counter(static_cast<double>(events), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GameSessionCollectEvents)->ArgNames({ "players", "loots" })->ArgsProduct({ { 10, 100, 1000 }, { 10, 100, 1000, 10000 } });
+
+static void BM_GameSessionProcessEvents(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    SessionFixture fixture(50, state.range(0), state.range(1));
+    std::vector<InteractionEvent> events;
+
+    for (auto _ : state) {
+        // События строятся напрямую, а не через CollectEvents: иначе подготовка в сотни раз дороже замера
+        state.PauseTiming();
+        fixture.RestockLoot();
+        events.clear();
+        auto loot_it = fixture.session->GetLoots().begin();
+        for (auto* player : fixture.players) {
+            events.push_back(InteractionEvent{ .event = GatheringEvent{ .loot_id = loot_it->first }, .player = player, .time = 0.5 });
+            events.push_back(InteractionEvent{ .event = BaseEvent{}, .player = player, .time = 1.0 });
+            ++loot_it;
+        }
+        state.ResumeTiming();
+
+        fixture.session->ProcessEvents(events);
+    }
+
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+// Трофеев не меньше, чем игроков: каждому игроку достаётся свой
+BENCHMARK(BM_GameSessionProcessEvents)->ArgNames({ "players", "loots" })->ArgsProduct({ { 100, 1000 }, { 1000, 10000 } });
+
+static void BM_GameSessionCollectVisible(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    SessionFixture fixture(100, state.range(0), state.range(0));
+    const AreaOfInterest area{ .radius = static_cast<double>(state.range(1)), .hysteresis = 5.0 };
+    std::vector<const player::Player*> players;
+    std::vector<const loot::Loot*> loots;
+    size_t visible = 0;
+
+    for (auto _ : state) {
+        // Все клиенты сессии запрашивают состояние один раз за тик
+        for (const auto* viewer : fixture.players) {
+            players.clear();
+            loots.clear();
+            fixture.session->CollectVisible(*viewer, area, players, loots);
+            visible += players.size() + loots.size();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * fixture.players.size());
+    state.counters["visible"] = benchmark::Counter(static_cast<double>(visible) / fixture.players.size(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GameSessionCollectVisible)->ArgNames({ "players", "radius" })->ArgsProduct({ { 100, 1000 }, { 20, 100 } });
+
+static void BM_GameProcessTimeMovement(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    auto game = std::make_unique<Game>(true, bench::MakeLootGenerator());
+    game->SetSessionPolicy(SessionPolicy{ .max_players = static_cast<size_t>(state.range(1)), .placement = SessionPlacement::LEAST_LOADED });
+    game->AddMap(bench::MakeGridMap(50));
+
+    const auto* game_map = game->GetMaps().data();
+    std::vector<player::Player*> players;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        std::string name = "dog" + std::to_string(i);
+        auto [token, id] = game->AddPlayer(game_map, name);
+        players.push_back(game->GetPlayer(token));
+    }
+
+    for (auto _ : state) {
+        bench::KeepPlayersMoving(players);
+        game->ProcessTimeMovement(TICK_MS);
+    }
+
+    state.SetItemsProcessed(state.iterations() * players.size());
+    state.counters["sessions"] = static_cast<double>(game->GetSessions().begin()->second.size());
+}
+// Один и тот же наплыв игроков на одну карту: одна сессия без лимита против нескольких ограниченных
+BENCHMARK(BM_GameProcessTimeMovement)->ArgNames({ "players", "max_players" })->ArgsProduct({ { 1000, 4000 }, { 0, 250 } })->UseRealTime();
+
+static void BM_LootGeneratorGenerate(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    auto generator = bench::MakeLootGenerator();
+    const auto looters = static_cast<unsigned>(state.range(0));
+    unsigned loot_count = 0;
+
+    for (auto _ : state) {
+        loot_count = (loot_count + generator.Generate(std::chrono::milliseconds(TICK_MS), loot_count, looters)) % (looters + 1);
+        benchmark::DoNotOptimize(loot_count);
+    }
+}
+BENCHMARK(BM_LootGeneratorGenerate)->ArgName("looters")->Arg(1)->Arg(100)->Arg(10000);
+
+static void BM_MapGetRandomPosition(benchmark::State& state) {
+    auto map = bench::MakeGridMap(static_cast<int>(state.range(0)));
+    utils::RandomEngine engine(SEED);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.GetRandomPosition(engine));
+    }
+}
+BENCHMARK(BM_MapGetRandomPosition)->ArgName("grid")->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_PlayerTokenGenerate(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player::PlayerToken::GenerateToken());
+    }
+}
+BENCHMARK(BM_PlayerTokenGenerate);
+
+static void BM_PlayerTokenToString(benchmark::State& state) {
+    auto token = player::PlayerToken::GenerateToken();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(token.ToString());
+    }
+}
+BENCHMARK(BM_PlayerTokenToString);
+
+static void BM_PlayerTokenFromString(benchmark::State& state) {
+    auto token_string = player::PlayerToken::GenerateToken().ToString();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player::PlayerToken::FromString(token_string));
+    }
+}
+BENCHMARK(BM_PlayerTokenFromString);
+
+static void BM_GameSerializationFromGame(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    auto game = MakeGame(bench::MakeGridMap(50), state.range(0), state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(application::serialization::GameSerialization::FromGame(*game));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameSerializationFromGame)->ArgName("players")->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_GameSerializationToGame(benchmark::State& state) {
+    utils::SetRandomSeed(SEED);
+    auto map = bench::MakeGridMap(50);
+    auto source = MakeGame(map, state.range(0), state.range(0));
+    auto game_ser = application::serialization::GameSerialization::FromGame(*source);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto game = std::make_unique<Game>(true, bench::MakeLootGenerator());
+        game->AddMap(map);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(game_ser.ToGame(*game));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GameSerializationToGame)->ArgName("players")->Arg(10)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+#include "percent_codec.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+    constexpr unsigned SEED = 42;
+
+    // Путь длиной length, где примерно каждый escape_every-й символ требует кодирования
+    std::string MakePath(size_t length, size_t escape_every) {
+        std::mt19937 random(SEED);
+        std::string path;
+        for (size_t i = 0; i < length; ++i) {
+            if (escape_every != 0 && random() % escape_every == 0) {
+                path += random() % 2 == 0 ? ' ' : static_cast<char>(0x80 + random() % 0x80);
+            }
+            else {
+                path += static_cast<char>('a' + random() % 26);
+            }
+        }
+        return path;
+    }
+
+    // Прежняя реализация UrlDecode из static_request_handler для сравнения
+    std::string StreamUrlDecode(const std::string& encoded) {
+        std::ostringstream decoded;
+        for (size_t i = 0; i < encoded.length(); ++i) {
+            if (encoded[i] == '%' && i + 2 < encoded.length()) {
+                std::istringstream hex_stream(encoded.substr(i + 1, 2));
+                int hex;
+                hex_stream >> std::hex >> hex;
+                decoded << static_cast<char>(hex);
+                i += 2;
+            }
+            else if (encoded[i] == '+') {
+                decoded << ' ';
+            }
+            else {
+                decoded << encoded[i];
+            }
+        }
+        return decoded.str();
+    }
+
+    // range(0) - длина пути, range(1) - каждый какой символ кодируется (0 - ни один)
+    void Decode(benchmark::State& state) {
+        const auto encoded = percent_codec::Encode(MakePath(state.range(0), state.range(1)));
+        for (auto _ : state) {
+            auto decoded = percent_codec::Decode(encoded);
+            benchmark::DoNotOptimize(decoded);
+        }
+        state.SetBytesProcessed(state.iterations() * encoded.size());
+    }
+    BENCHMARK(Decode)->Args({ 64, 0 })->Args({ 64, 8 })->Args({ 4096, 0 })->Args({ 4096, 8 })->Args({ 4096, 2 });
+
+    void DecodeInPlace(benchmark::State& state) {
+        const auto encoded = percent_codec::Encode(MakePath(state.range(0), state.range(1)));
+        std::string buffer;
+        for (auto _ : state) {
+            buffer = encoded;
+            percent_codec::DecodeInPlace(buffer);
+            benchmark::DoNotOptimize(buffer);
+        }
+        state.SetBytesProcessed(state.iterations() * encoded.size());
+    }
+    BENCHMARK(DecodeInPlace)->Args({ 64, 8 })->Args({ 4096, 0 })->Args({ 4096, 8 });
+
+    void DecodeStream(benchmark::State& state) {
+        const auto encoded = percent_codec::Encode(MakePath(state.range(0), state.range(1)));
+        for (auto _ : state) {
+            auto decoded = StreamUrlDecode(encoded);
+            benchmark::DoNotOptimize(decoded);
+        }
+        state.SetBytesProcessed(state.iterations() * encoded.size());
+    }
+    BENCHMARK(DecodeStream)->Args({ 64, 0 })->Args({ 64, 8 })->Args({ 4096, 0 })->Args({ 4096, 8 })->Args({ 4096, 2 });
+
+    void Encode(benchmark::State& state) {
+        const auto path = MakePath(state.range(0), state.range(1));
+        for (auto _ : state) {
+            auto encoded = percent_codec::Encode(path);
+            benchmark::DoNotOptimize(encoded);
+        }
+        state.SetBytesProcessed(state.iterations() * path.size());
+    }
+    BENCHMARK(Encode)->Args({ 64, 0 })->Args({ 64, 8 })->Args({ 4096, 0 })->Args({ 4096, 8 })->Args({ 4096, 2 });
+}
+
+BENCHMARK_MAIN();
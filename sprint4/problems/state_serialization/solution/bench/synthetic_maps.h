@@ -0,0 +1,72 @@
+#pragma once
+
+#include "game.h"
+
+#include <string>
+#include <vector>
+
+namespace bench {
+    using namespace application::game;
+
+    // Квадратная сетка из (cells + 1) горизонтальных и (cells + 1) вертикальных дорог с шагом spacing
+    // и офисами в offices случайных перекрёстках. Офисы ставятся детерминированно, без RNG модели
+    inline map::Map MakeGridMap(int cells, int spacing = 10, int offices = 4, double dog_speed = 3.0, size_t bag_capacity = 3) {
+        std::string id = "grid" + std::to_string(cells);
+        std::vector<size_t> loot_values{ 10, 20, 30 };
+
+        auto map = map::MapBuilder()
+            .SetId(id)
+            .SetName("Grid " + std::to_string(cells))
+            .SetDogSpeed(dog_speed)
+            .SetTypesValue(loot_values)
+            .SetBagCapacity(bag_capacity)
+            .Build();
+
+        const int size = cells * spacing;
+        for (int i = 0; i <= cells; ++i) {
+            map.AddRoad(map::Road(map::Road::HORIZONTAL, { 0, i * spacing }, size));
+            map.AddRoad(map::Road(map::Road::VERTICAL, { i * spacing, 0 }, size));
+        }
+
+        for (int i = 0; i < offices; ++i) {
+            // Простое LCG-смещение: офисы разбросаны по сетке, но одинаковы между запусками
+            int x = (i * 7919 + 13) % (cells + 1);
+            int y = (i * 104729 + 7) % (cells + 1);
+            map.AddOffice(map::Office("office" + std::to_string(i), { x * spacing, y * spacing }, { 0, 0 }));
+        }
+
+        return map;
+    }
+
+    inline loot_gen::LootGenerator MakeLootGenerator(double probability = 0.5) {
+        return loot_gen::LootGenerator(std::chrono::milliseconds(1000), probability, [] {
+            return utils::GetRandomReal(1.0);
+        });
+    }
+
+    // Сессия со случайно расставленными игроками, которые уже куда-то идут, и разбросанными трофеями
+    inline void PopulateSession(GameSession& session, size_t players, size_t loots) {
+        const auto& map = *session.GetMap();
+
+        for (size_t i = 0; i < players; ++i) {
+            std::string name = "dog" + std::to_string(i);
+            auto [token, id] = session.AddPlayer(name);
+            session.GetPlayer(token)->SetDirection(static_cast<Direction>(utils::GetRandomInteger(3)));
+        }
+
+        for (size_t i = 0; i < loots; ++i) {
+            session.AddLoot(loot::Loot(map.GetRandomPosition(), utils::GetRandomInteger(map.GetLootTypesCount() - 1)));
+        }
+    }
+
+    // Упёршиеся в край дороги игроки получают новое направление, иначе через пару секунд
+    // игрового времени все стоят и замер вырождается
+    inline void KeepPlayersMoving(const std::vector<player::Player*>& players) {
+        for (auto* player : players) {
+            auto speed = player->GetSpeed();
+            if (speed.x == 0 && speed.y == 0) {
+                player->SetDirection(static_cast<Direction>(utils::GetRandomInteger(3)));
+            }
+        }
+    }
+} // namespace bench
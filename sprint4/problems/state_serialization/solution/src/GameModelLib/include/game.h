@@ -18,6 +18,8 @@
 #include "map.h"
 #include "player.h"
 #include "loot.h"
+#include "spatial_index.h"
+#include "timing_wheel.h"
 
 namespace application {
     namespace game {
@@ -41,8 +43,43 @@ namespace application {
             double time;
         };
 
+        // Область интереса клиента: в ответ на запрос состояния попадают только объекты рядом с его псом
+        struct AreaOfInterest {
+            // 0 - фильтрация выключена, клиент получает всю сессию
+            double radius = 0.0;
+            // Попавший в область объект пропадает из неё только дальше radius + hysteresis,
+            // чтобы объекты на границе не мерцали
+            double hysteresis = 0.0;
+
+            bool IsEnabled() const {
+                return radius > 0.0;
+            }
+        };
+
+        // Итог игры ушедшего игрока
+        struct PlayerRecord {
+            std::string name;
+            size_t score = 0;
+            std::chrono::milliseconds play_time{ 0 };
+        };
+
+        // Куда отдаются итоги ушедших игроков (таблица рекордов, БД).
+        // Вызывается из потока тика раз в тик, поэтому не должен подолгу блокироваться
+        class PlayerRecordSink {
+        public:
+            virtual ~PlayerRecordSink() = default;
+
+            virtual void Publish(std::vector<PlayerRecord> records) = 0;
+        };
+
         class GameSession {
         public:
+            struct RetiredPlayer {
+                PlayerToken token;
+                size_t player_id;
+                PlayerRecord record;
+            };
+
             GameSession(const Map& map, bool is_random_spawn, loot_gen::LootGenerator loot_generator);
 
             std::pair<PlayerToken, size_t> AddPlayer(std::string& name);
@@ -70,38 +107,111 @@ namespace application {
             loot_gen::LootGenerator GetLootGenerator() const;
 
             void AddLoot(Loot loot);
+
+            // Фазы тика открыты отдельно, чтобы их можно было замерять по отдельности (см. bench/)
+            std::vector<InteractionEvent> CollectEvents(double time);
+
+            void ProcessEvents(std::vector<InteractionEvent>& events);
+
+            // Игроки и трофеи в области интереса viewer. Запоминает, что видел viewer, ради гистерезиса
+            void CollectVisible(const Player& viewer, const AreaOfInterest& area, std::vector<const Player*>& players, std::vector<const Loot*>& loots);
+
+            // Меняется при любом изменении, видимом клиентам: тик, вход игрока, смена направления.
+            // По ней кэши ответов понимают, что состояние устарело
+            uint64_t GetStateVersion() const;
+
+            void MarkStateChanged();
+
+            // Часы сессии: сумма времени всех тиков, мс
+            int64_t GetTime() const;
+
+            // Через сколько простоя игрок покидает игру; 0 - никогда. Задаётся до добавления игроков
+            void SetRetirementTime(std::chrono::milliseconds time);
+
+            // Игроки, ушедшие по простою с прошлого вызова, в порядке id
+            std::vector<RetiredPlayer> TakeRetiredPlayers();
         private:
+            struct VisibleSet {
+                std::unordered_set<size_t> players;
+                std::unordered_set<size_t> loots;
+            };
+
+            void RebuildPlayerIndex();
+
             void ProcessTimeMovement(int time);
 
             void GenerateLoot(int time);
 
-            void ProcessEvents(std::vector<InteractionEvent>& events);
+            // Пёс остановился: запоминает момент и ставит таймер ухода
+            void StartIdle(const PlayerToken& token, Player& player);
 
-            std::vector<InteractionEvent> CollectEvents(double time);
+            void RetireIdlePlayers();
+
+            using Players = std::unordered_map<PlayerToken, Player, PlayerTokenHash>;
+
+            // Единственный способ убрать игрока: вместе с ним из индекса и visible_ уходит всё, что о нём помнит сессия
+            void RemovePlayer(Players::iterator it);
 
             std::shared_ptr<Map> map_;
             bool is_random_spawn_;
             loot_gen::LootGenerator loot_generator_;
             std::unordered_map<int, const Road*> horizontal_roads_;
             std::unordered_map<int, const Road*> vertical_roads_;
-            std::unordered_map<PlayerToken, Player, PlayerTokenHash> players_;
+            Players players_;
+            // id не переиспользуются: после ухода игрока players_.size() уже не годится
+            size_t next_player_id_ = 0;
 
             std::unordered_map<size_t, Loot> loots_;
+            size_t next_loot_id_ = 0;
+
+            // Трофеи обновляются при добавлении и сборе, игроки - раз в тик после движения
+            spatial::UniformGrid<size_t> loot_index_;
+            spatial::UniformGrid<const Player*> player_index_;
+            // id зрителя -> что он видел в прошлом ответе
+            std::unordered_map<size_t, VisibleSet> visible_;
+
+            uint64_t state_version_ = 0;
+
+            int64_t time_ = 0;
+            int64_t retirement_time_ = 0;
+            // Таймеры срабатывают по сроку ухода; простой, прерванный движением, проверяется при срабатывании,
+            // поэтому тик не перебирает игроков в поисках истёкших
+            timing::TimingWheel<PlayerToken> retirement_wheel_;
+            std::vector<RetiredPlayer> retired_;
+
+            // Собственный генератор сессии: сессии обрабатываются параллельно,
+            // и только так порядок выпадения трофеев не зависит от планировщика
+            RandomEngine random_engine_;
+        };
+
+        // Как выбирается сессия карты для нового игрока, когда их несколько
+        enum class SessionPlacement {
+            FILL_FIRST,     // первая сессия со свободным местом: игроки собираются вместе
+            LEAST_LOADED    // сессия с наименьшим числом игроков: тики сессий выравниваются
+        };
+
+        struct SessionPolicy {
+            // 0 - без ограничения, на каждой карте ровно одна сессия
+            size_t max_players = 0;
+            SessionPlacement placement = SessionPlacement::FILL_FIRST;
         };
 
         class Game {
         public:
             using Maps = std::vector<Map>;
+            // Игроки хранят ссылку на свою сессию, поэтому нужен контейнер со стабильными адресами
+            using MapSessions = std::list<GameSession>;
+            using Sessions = std::map<std::string, MapSessions>;
 
             explicit Game(bool is_random_spawn, loot_gen::LootGenerator loot_generator);
 
             void AddMap(Map map);
 
-            void AddSession(GameSession& session);
+            GameSession& AddSession(const GameSession& session);
 
             std::pair<PlayerToken, size_t> AddPlayer(const Map* map, std::string& name);
 
-            void AddPlayer(const std::string& map_id, PlayerToken token, const Player& player);
+            void AddPlayer(GameSession& session, PlayerToken token, const Player& player);
 
             const Maps& GetMaps() const noexcept;
 
@@ -113,21 +223,46 @@ namespace application {
 
             void ProcessTimeMovement(int time);
 
-            const std::map<std::string, GameSession>& GetSessions() const;
+            const Sessions& GetSessions() const;
+
+            Sessions& GetSessions();
 
-            std::map<std::string, GameSession>& GetSessions();
+            // Удаляет сессии, в которых не осталось игроков
+            size_t RemoveEmptySessions();
+
+            void SetSessionPolicy(SessionPolicy policy);
+
+            const SessionPolicy& GetSessionPolicy() const;
+
+            void SetRetirementTime(std::chrono::milliseconds time);
+
+            std::chrono::milliseconds GetRetirementTime() const;
+
+            // nullptr - итоги ушедших игроков никуда не отдаются
+            void SetRecordSink(PlayerRecordSink* sink);
+
+            void SetAreaOfInterest(AreaOfInterest area);
+
+            const AreaOfInterest& GetAreaOfInterest() const;
 
             bool IsSpawnRandom() const;
 
             loot_gen::LootGenerator GetLootGenerator() const;
 
-            GameSession& GetSession(const std::string& map_id);
-
         private:
             using MapIdToIndex = std::unordered_map<std::string, size_t>;
 
+            GameSession& SelectSession(const Map& map);
+
+            // Убирает ушедших из индекса токенов и отдаёт их итоги в record_sink_
+            void CollectRetiredPlayers();
+
             std::unordered_map<PlayerToken, Player*, PlayerTokenHash> players_;
-            std::map<std::string, GameSession> sessions_;
+            Sessions sessions_;
+            SessionPolicy session_policy_;
+            AreaOfInterest area_of_interest_;
+            std::chrono::milliseconds retirement_time_{ 0 };
+            PlayerRecordSink* record_sink_ = nullptr;
             std::vector<Map> maps_;
             MapIdToIndex map_id_to_index_;
             loot_gen::LootGenerator loot_generator_;
@@ -119,6 +119,8 @@ namespace application {
 
                 utils::Coordinates GetRandomPosition() const;
 
+                utils::Coordinates GetRandomPosition(utils::RandomEngine& engine) const;
+
                 utils::Coordinates GetStartPosition() const;
 
                 double GetSpeed() const;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <iomanip>
@@ -67,6 +68,9 @@ namespace application {
 
                 void SetDirection(Direction direction);
 
+                // Пустая команда движения: пёс останавливается, направление остаётся прежним
+                void Stop();
+
                 void ChangeSpeed();
 
                 Coordinates Move(double time);
@@ -84,7 +88,24 @@ namespace application {
                 void SetScore(size_t score);
 
                 const Dog& GetDog() const;
+
+                // Время по часам сессии (GameSession::GetTime), в миллисекундах
+                int64_t GetPlayTime() const;
+
+                void SetJoinTime(int64_t time);
+
+                // Пёс простаивает, пока стоит на месте
+                bool IsIdle() const;
+
+                int64_t GetIdleTime() const;
+
+                void SetIdleSince(int64_t time);
+
+                // Пёс остановился по команде с прошлого вызова. Сессия ставит таймер ухода на тике:
+                // токен игрока знает только она
+                bool TakeIdleStarted();
             private:
+                void OnSpeedChanged(bool was_idle);
 
                 Coordinates ProccessVerticalMovement(double time);
 
@@ -93,6 +114,9 @@ namespace application {
                 Dog dog_;
                 GameSession& session_;
                 size_t score_ = 0;
+                int64_t join_time_ = 0;
+                int64_t idle_since_ = 0;
+                bool idle_started_ = false;
 
                 std::vector<Loot> loots_;
             };
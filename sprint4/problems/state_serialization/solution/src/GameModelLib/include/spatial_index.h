@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "utils.h"
+
+namespace application {
+    namespace game {
+        namespace spatial {
+            /*
+             * Равномерная сетка квадратных ячеек для поиска объектов рядом с точкой или отрезком.
+             * Хранит только непустые ячейки, поэтому размер карты на память не влияет.
+             * Порядок обхода определяется порядком операций, а не адресами, - это важно для реплея.
+             */
+            template <typename Value>
+            class UniformGrid {
+            public:
+                static constexpr double DEFAULT_CELL_SIZE = 10.0;
+
+                explicit UniformGrid(double cell_size = DEFAULT_CELL_SIZE)
+                    : cell_size_(cell_size) {
+                }
+
+                void Insert(const Value& value, const Coordinates& position) {
+                    cells_[KeyOf(position)].push_back(Entry{ value, position });
+                    ++size_;
+                }
+
+                // position должна совпадать с переданной в Insert: по ней находится ячейка
+                bool Remove(const Value& value, const Coordinates& position) {
+                    auto cell = cells_.find(KeyOf(position));
+                    if (cell == cells_.end()) {
+                        return false;
+                    }
+
+                    auto& entries = cell->second;
+                    auto it = std::find_if(entries.begin(), entries.end(), [&value](const Entry& entry) {
+                        return entry.value == value;
+                    });
+                    if (it == entries.end()) {
+                        return false;
+                    }
+
+                    // Порядок внутри ячейки сохраняется, чтобы обход оставался воспроизводимым
+                    entries.erase(it);
+                    if (entries.empty()) {
+                        cells_.erase(cell);
+                    }
+                    --size_;
+                    return true;
+                }
+
+                void Clear() {
+                    // Ячейки удаляются вместе с содержимым: иначе пустые ячейки копились бы по всему пути псов
+                    cells_.clear();
+                    size_ = 0;
+                }
+
+                size_t Size() const {
+                    return size_;
+                }
+
+                // Вызывает fn(value, position) для всех объектов из ячеек, задетых прямоугольником.
+                // Объекты из этих ячеек могут лежать вне прямоугольника - точную проверку делает вызывающий
+                template <typename Fn>
+                void ForEachInRect(Coordinates min, Coordinates max, Fn&& fn) const {
+                    const int64_t min_x = CellIndex(min.x), max_x = CellIndex(max.x);
+                    const int64_t min_y = CellIndex(min.y), max_y = CellIndex(max.y);
+
+                    for (int64_t y = min_y; y <= max_y; ++y) {
+                        for (int64_t x = min_x; x <= max_x; ++x) {
+                            auto cell = cells_.find(MakeKey(x, y));
+                            if (cell == cells_.end()) {
+                                continue;
+                            }
+                            for (const auto& entry : cell->second) {
+                                fn(entry.value, entry.position);
+                            }
+                        }
+                    }
+                }
+
+                template <typename Fn>
+                void ForEachNear(const Coordinates& center, double radius, Fn&& fn) const {
+                    ForEachInRect({ center.x - radius, center.y - radius }, { center.x + radius, center.y + radius }, std::forward<Fn>(fn));
+                }
+
+                // Объекты у отрезка from-to на расстоянии не больше radius (с точностью до ячейки)
+                template <typename Fn>
+                void ForEachNearSegment(const Coordinates& from, const Coordinates& to, double radius, Fn&& fn) const {
+                    ForEachInRect({ std::min(from.x, to.x) - radius, std::min(from.y, to.y) - radius },
+                        { std::max(from.x, to.x) + radius, std::max(from.y, to.y) + radius }, std::forward<Fn>(fn));
+                }
+            private:
+                struct Entry {
+                    Value value;
+                    Coordinates position;
+                };
+
+                int64_t CellIndex(double coordinate) const {
+                    return static_cast<int64_t>(std::floor(coordinate / cell_size_));
+                }
+
+                static uint64_t MakeKey(int64_t x, int64_t y) {
+                    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+                }
+
+                uint64_t KeyOf(const Coordinates& position) const {
+                    return MakeKey(CellIndex(position.x), CellIndex(position.y));
+                }
+
+                double cell_size_;
+                std::unordered_map<uint64_t, std::vector<Entry>> cells_;
+                size_t size_ = 0;
+            };
+        } // namespace spatial
+    } // namespace game
+} // namespace application
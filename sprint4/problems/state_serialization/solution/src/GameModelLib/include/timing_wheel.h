@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace application {
+    namespace game {
+        namespace timing {
+            /*
+             * Иерархическое колесо таймеров: LEVELS уровней по SLOTS ячеек, ячейка уровня l покрывает SLOTS^l единиц времени.
+             * Постановка и срабатывание - O(1) на таймер, продвижение времени - O(1) на единицу времени
+             * (пустое колесо перескакивает сразу). Таймеры дальше SLOTS^LEVELS единиц ждут в отдельном списке.
+             * Таймеры с одним сроком срабатывают в порядке постановки - это важно для реплея.
+             */
+            template <typename Value>
+            class TimingWheel {
+            public:
+                static constexpr unsigned SLOT_BITS = 6;
+                static constexpr size_t SLOTS = size_t{ 1 } << SLOT_BITS;
+                static constexpr size_t LEVELS = 4;
+
+                explicit TimingWheel(uint64_t now = 0)
+                    : now_(now) {
+                }
+
+                // Таймер со сроком не позже текущего времени сработает при следующем продвижении
+                void Schedule(uint64_t deadline, Value value) {
+                    Place(Entry{ std::max(deadline, now_ + 1), std::move(value) });
+                    ++size_;
+                }
+
+                // Продвигает время до now и вызывает fn(value) для всех таймеров со сроком <= now в порядке сроков
+                template <typename Fn>
+                void Advance(uint64_t now, Fn&& fn) {
+                    while (now_ < now) {
+                        if (size_ == 0) {
+                            now_ = now;
+                            return;
+                        }
+                        Step(fn);
+                    }
+                }
+
+                uint64_t GetNow() const {
+                    return now_;
+                }
+
+                size_t Size() const {
+                    return size_;
+                }
+            private:
+                struct Entry {
+                    uint64_t deadline;
+                    Value value;
+                };
+
+                using Slot = std::vector<Entry>;
+
+                static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+                static constexpr unsigned Shift(size_t level) {
+                    return static_cast<unsigned>(level * SLOT_BITS);
+                }
+
+                void Place(Entry entry) {
+                    // Уровень - старший разряд, в котором срок расходится с текущим временем
+                    for (size_t level = 0; level < LEVELS; ++level) {
+                        const unsigned upper = Shift(level + 1);
+                        if ((entry.deadline >> upper) == (now_ >> upper)) {
+                            slots_[level][(entry.deadline >> Shift(level)) & SLOT_MASK].push_back(std::move(entry));
+                            return;
+                        }
+                    }
+                    overflow_.push_back(std::move(entry));
+                }
+
+                // Перекладывает ячейку верхнего уровня на нижние
+                void Cascade(Slot& slot) {
+                    Slot entries = std::move(slot);
+                    slot.clear();
+                    for (auto& entry : entries) {
+                        Place(std::move(entry));
+                    }
+                }
+
+                template <typename Fn>
+                void Step(Fn& fn) {
+                    ++now_;
+
+                    if ((now_ & ((uint64_t{ 1 } << Shift(LEVELS)) - 1)) == 0 && !overflow_.empty()) {
+                        Cascade(overflow_);
+                    }
+
+                    // Сверху вниз: таймер, спущенный с верхнего уровня, может попасть в ячейку, которая разбирается следом
+                    for (size_t level = LEVELS - 1; level > 0; --level) {
+                        if ((now_ & ((uint64_t{ 1 } << Shift(level)) - 1)) == 0) {
+                            Cascade(slots_[level][(now_ >> Shift(level)) & SLOT_MASK]);
+                        }
+                    }
+
+                    auto& slot = slots_[0][now_ & SLOT_MASK];
+                    if (slot.empty()) {
+                        return;
+                    }
+
+                    Slot due = std::move(slot);
+                    slot.clear();
+                    size_ -= due.size();
+                    for (auto& entry : due) {
+                        fn(entry.value);
+                    }
+                }
+
+                uint64_t now_;
+                size_t size_ = 0;
+                std::array<std::array<Slot, SLOTS>, LEVELS> slots_;
+                Slot overflow_;
+            };
+        } // namespace timing
+    } // namespace game
+} // namespace application
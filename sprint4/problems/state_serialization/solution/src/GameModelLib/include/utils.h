@@ -24,9 +24,20 @@ namespace application {
                 double y = 0.0;
             };
 
+            using RandomEngine = std::mt19937;
+
+            // Общий генератор модели. Для воспроизводимых запусков (запись/реплей) его можно засеять явно
+            RandomEngine& GetRandomEngine();
+
+            void SetRandomSeed(RandomEngine::result_type seed);
+
             size_t GetRandomInteger(size_t max_value);
 
+            size_t GetRandomInteger(size_t max_value, RandomEngine& engine);
+
             double GetRandomReal(double max_value);
+
+            double GetRandomReal(double max_value, RandomEngine& engine);
 		}
 	}
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "game.h"
+#include "profiler.h"
+
+#include <atomic>
 
 using namespace std::literals;
 
@@ -8,7 +11,8 @@ namespace application {
         using namespace map;
 
         GameSession::GameSession(const Map& map, bool is_random_spawn, loot_gen::LootGenerator loot_generator) 
-            : map_(std::make_shared<Map>(map)), is_random_spawn_(is_random_spawn), loot_generator_(std::move(loot_generator)) {
+            : map_(std::make_shared<Map>(map)), is_random_spawn_(is_random_spawn), loot_generator_(std::move(loot_generator))
+            , random_engine_(GetRandomEngine()()) {
             const std::vector<Road>& roads = map_->GetRoads();
 
             for (const auto& road : roads) {
@@ -19,10 +23,16 @@ namespace application {
                     vertical_roads_.emplace(road.GetStart().x, &road);
                 }
             }
+
+            MarkStateChanged();
         }
 
         void GameSession::AddLoot(Loot loot) {
-            loots_.emplace(loot.id, std::move(loot));
+            next_loot_id_ = std::max(next_loot_id_, loot.id + 1);
+            if (auto [it, inserted] = loots_.emplace(loot.id, std::move(loot)); inserted) {
+                loot_index_.Insert(it->first, it->second.coordinates);
+                MarkStateChanged();
+            }
         }
 
 
@@ -38,14 +48,32 @@ namespace application {
                 coordinates = std::move(map_->GetStartPosition());
             }
 
-            Player player(Dog{ name, players_.size(), coordinates }, *this);
+            Player player(Dog{ name, next_player_id_++, coordinates }, *this);
+            player.SetJoinTime(time_);
             auto it = players_.emplace(token, std::move(player));
+            player_index_.Insert(&it.first->second, coordinates);
+            //     
+            StartIdle(it.first->first, it.first->second);
+            MarkStateChanged();
 
             return { token, it.first->second.GetId() };
         }
 
         void GameSession::AddPlayer(PlayerToken token, const Player& player) {
-            players_.emplace(std::move(token), player);
+            for (const auto& loot : player.GetLoots()) {
+                next_loot_id_ = std::max(next_loot_id_, loot.id + 1);
+            }
+
+            next_player_id_ = std::max(next_player_id_, player.GetId() + 1);
+
+            auto it = players_.emplace(std::move(token), player);
+            player_index_.Insert(&it.first->second, player.GetPosition());
+            if (player.IsIdle() && retirement_time_ > 0) {
+                //       
+                auto deadline = std::max<int64_t>(time_ - player.GetIdleTime() + retirement_time_, 0);
+                retirement_wheel_.Schedule(static_cast<uint64_t>(deadline), it.first->first);
+            }
+            MarkStateChanged();
         }
 
         Player* GameSession::GetPlayer(PlayerToken token) {
@@ -71,11 +99,17 @@ namespace application {
         }
 
         void GameSession::ProcessTick(int time) {
+            PROFILE_ZONE("GameSession::ProcessTick");
             GenerateLoot(time);
+            //     :        
+            time_ += time;
             ProcessTimeMovement(time);
+            RetireIdlePlayers();
+            MarkStateChanged();
         }
 
         void GameSession::GenerateLoot(int time) {
+            PROFILE_ZONE("GameSession::GenerateLoot");
             auto time_delta = std::chrono::milliseconds(time);
             unsigned loot_count = loots_.size();
             unsigned looter_count = players_.size();
@@ -83,7 +117,9 @@ namespace application {
             unsigned new_loot_count = loot_generator_.Generate(time_delta, loot_count, looter_count);
 
             for (unsigned i = 0; i < new_loot_count; i++) {
-                Loot new_loot(map_->GetRandomPosition(), GetRandomInteger(map_->GetLootTypesCount() - 1));
+                Loot new_loot(map_->GetRandomPosition(random_engine_), GetRandomInteger(map_->GetLootTypesCount() - 1, random_engine_), false);
+                new_loot.id = next_loot_id_++;
+                loot_index_.Insert(new_loot.id, new_loot.coordinates);
                 loots_.emplace(new_loot.id, new_loot);
             }
         }
@@ -93,24 +129,41 @@ namespace application {
             
             auto collected_events = CollectEvents(time_in_second);
             ProcessEvents(collected_events);
+            RebuildPlayerIndex();
+        }
+
+        void GameSession::RebuildPlayerIndex() {
+            player_index_.Clear();
+            for (const auto& [token, player] : players_) {
+                player_index_.Insert(&player, player.GetPosition());
+            }
         }
 
         std::vector<InteractionEvent> GameSession::CollectEvents(double time) {
+            PROFILE_ZONE("GameSession::CollectEvents");
             std::vector<InteractionEvent> events;
 
             for (auto& [token, player] : players_) {
+                //    :      ,      
+                const bool stopped = player.TakeIdleStarted();
+                const bool was_idle = player.IsIdle();
                 auto old_coordinates = player.GetPosition();
                 auto new_coordinates = player.Move(time);
 
+                if ((stopped || !was_idle) && player.IsIdle()) {
+                    StartIdle(token, player);
+                }
+
                 if (old_coordinates == new_coordinates) {
                     continue;
                 }
                 
-                for (auto& [id, loot] : loots_) {
-                    auto collect_result = TryCollectPoint(old_coordinates, new_coordinates, loot.coordinates);
+                //        ,     
+                loot_index_.ForEachNearSegment(old_coordinates, new_coordinates, Player::width / 2, [&](size_t loot_id, const Coordinates& loot_coordinates) {
+                    auto collect_result = TryCollectPoint(old_coordinates, new_coordinates, loot_coordinates);
 
                     if (collect_result.IsCollected(Player::width / 2)) {
-                        GatheringEvent gathering_event{ .loot_id = loot.id };
+                        GatheringEvent gathering_event{ .loot_id = loot_id };
 
                         InteractionEvent interaction_event{.event = gathering_event,
                             .player = &player,
@@ -118,7 +171,7 @@ namespace application {
 
                         events.push_back(interaction_event);
                     }
-                }              
+                });
 
                 for (const auto& office : map_->GetOffices()) {
                     auto pos = office.GetPosition();
@@ -137,15 +190,21 @@ namespace application {
                 }
             }
 
-            std::sort(events.begin(), events.end(),
+            // players_    ,    
+            //   id ,       
+            std::stable_sort(events.begin(), events.end(),
                 [](const InteractionEvent& e_l, const InteractionEvent& e_r) {
-                    return e_l.time < e_r.time;
+                    if (e_l.time != e_r.time) {
+                        return e_l.time < e_r.time;
+                    }
+                    return e_l.player->GetId() < e_r.player->GetId();
                 });
 
             return events;
         }
 
         void GameSession::ProcessEvents(std::vector<InteractionEvent>& interaction_events) {
+            PROFILE_ZONE("GameSession::ProcessEvents");
             auto max_bag_capacity = map_->GetBagCapacity();
 
             for (const auto& interaction_event : interaction_events) {
@@ -161,6 +220,7 @@ namespace application {
                     auto it = loots_.find(gathering_event.loot_id);
                     if (it != loots_.end()) {
                         interaction_event.player->AddLoot(it->second);
+                        loot_index_.Remove(it->first, it->second.coordinates);
                         loots_.erase(it);
                     }
                 }
@@ -170,6 +230,111 @@ namespace application {
             }
         }
 
+        void GameSession::CollectVisible(const Player& viewer, const AreaOfInterest& area, std::vector<const Player*>& players, std::vector<const Loot*>& loots) {
+            PROFILE_ZONE("GameSession::CollectVisible");
+            const auto center = viewer.GetPosition();
+            const double enter_sq = area.radius * area.radius;
+            const double leave_radius = area.radius + area.hysteresis;
+            const double leave_sq = leave_radius * leave_radius;
+
+            auto& previous = visible_[viewer.GetId()];
+            VisibleSet current;
+
+            auto is_visible = [&](const Coordinates& position, const std::unordered_set<size_t>& seen, size_t id) {
+                const double dx = position.x - center.x;
+                const double dy = position.y - center.y;
+                const double sq_distance = dx * dx + dy * dy;
+                return sq_distance <= enter_sq || (sq_distance <= leave_sq && seen.contains(id));
+            };
+
+            player_index_.ForEachNear(center, leave_radius, [&](const Player* player, const Coordinates&) {
+                //     :      
+                if (player == &viewer || is_visible(player->GetPosition(), previous.players, player->GetId())) {
+                    current.players.insert(player->GetId());
+                    players.push_back(player);
+                }
+            });
+
+            //     ,           
+            if (!current.players.contains(viewer.GetId())) {
+                current.players.insert(viewer.GetId());
+                players.push_back(&viewer);
+            }
+
+            loot_index_.ForEachNear(center, leave_radius, [&](size_t loot_id, const Coordinates& position) {
+                if (is_visible(position, previous.loots, loot_id)) {
+                    current.loots.insert(loot_id);
+                    loots.push_back(&loots_.at(loot_id));
+                }
+            });
+
+            previous = std::move(current);
+        }
+
+        void GameSession::StartIdle(const PlayerToken& token, Player& player) {
+            player.SetIdleSince(time_);
+            if (retirement_time_ > 0) {
+                retirement_wheel_.Schedule(static_cast<uint64_t>(time_ + retirement_time_), token);
+            }
+        }
+
+        void GameSession::RetireIdlePlayers() {
+            PROFILE_ZONE("GameSession::RetireIdlePlayers");
+            const size_t first_retired = retired_.size();
+
+            retirement_wheel_.Advance(static_cast<uint64_t>(time_), [this](const PlayerToken& token) {
+                auto it = players_.find(token);
+                //    ,  :     
+                if (it == players_.end() || it->second.GetIdleTime() < retirement_time_) {
+                    return;
+                }
+
+                auto& player = it->second;
+                retired_.push_back(RetiredPlayer{ .token = token, .player_id = player.GetId(), .record = PlayerRecord{
+                    .name = player.GetName(),
+                    .score = player.GetScore(),
+                    .play_time = std::chrono::milliseconds(player.GetPlayTime()) } });
+
+                RemovePlayer(it);
+            });
+
+            //          players_,    
+            std::sort(retired_.begin() + first_retired, retired_.end(), [](const RetiredPlayer& lhs, const RetiredPlayer& rhs) {
+                return lhs.player_id < rhs.player_id;
+            });
+        }
+
+        void GameSession::RemovePlayer(Players::iterator it) {
+            const auto& player = it->second;
+            player_index_.Remove(&player, player.GetPosition());
+            visible_.erase(player.GetId());
+            //    id      : id  ,    
+            players_.erase(it);
+        }
+
+        int64_t GameSession::GetTime() const {
+            return time_;
+        }
+
+        void GameSession::SetRetirementTime(std::chrono::milliseconds time) {
+            retirement_time_ = time.count();
+        }
+
+        std::vector<GameSession::RetiredPlayer> GameSession::TakeRetiredPlayers() {
+            return std::exchange(retired_, {});
+        }
+
+        uint64_t GameSession::GetStateVersion() const {
+            return state_version_;
+        }
+
+        void GameSession::MarkStateChanged() {
+            //    :      ,
+            //            
+            static std::atomic<uint64_t> next_state_version{ 1 };
+            state_version_ = next_state_version.fetch_add(1, std::memory_order_relaxed);
+        }
+
         const Road* GameSession::GetHorizontalRoad(int y) const {
             auto it = horizontal_roads_.find(y);
 
@@ -223,12 +388,10 @@ namespace application {
             }
         }
 
-        void Game::AddPlayer(const std::string& map_id, PlayerToken token, const Player& player) {
-            auto it = sessions_.find(map_id);
-
-            it->second.AddPlayer(token, player);
+        void Game::AddPlayer(GameSession& session, PlayerToken token, const Player& player) {
+            session.AddPlayer(token, player);
 
-            players_.emplace(token, it->second.GetPlayer(token));
+            players_.emplace(token, session.GetPlayer(token));
         }
 
         const Game::Maps& Game::GetMaps() const noexcept {
@@ -243,20 +406,48 @@ namespace application {
         }
 
         std::pair<PlayerToken, size_t> Game::AddPlayer(const Map* map, std::string& name) {
-            auto it = sessions_.find(map->GetId());
+            auto& session = SelectSession(*map);
 
-            if (it == sessions_.end()) {
-                GameSession new_session(*map, is_random_spawn_, loot_generator_);
-                it = sessions_.emplace(map->GetId(), std::move(new_session)).first;
-            }
-
-            auto data = it->second.AddPlayer(name);
+            auto data = session.AddPlayer(name);
 
-            players_.emplace(data.first, it->second.GetPlayer(data.first));
+            players_.emplace(data.first, session.GetPlayer(data.first));
 
             return data;
         }
 
+        GameSession& Game::SelectSession(const Map& map) {
+            auto& map_sessions = sessions_[map.GetId()];
+            const auto max_players = session_policy_.max_players;
+
+            auto has_room = [max_players](const GameSession& session) {
+                return max_players == 0 || session.GetPlayers().size() < max_players;
+            };
+
+            auto selected = map_sessions.end();
+            for (auto it = map_sessions.begin(); it != map_sessions.end(); ++it) {
+                if (!has_room(*it)) {
+                    continue;
+                }
+
+                if (session_policy_.placement == SessionPlacement::FILL_FIRST) {
+                    selected = it;
+                    break;
+                }
+
+                if (selected == map_sessions.end() || it->GetPlayers().size() < selected->GetPlayers().size()) {
+                    selected = it;
+                }
+            }
+
+            if (selected != map_sessions.end()) {
+                return *selected;
+            }
+
+            auto& session = map_sessions.emplace_back(map, is_random_spawn_, loot_generator_);
+            session.SetRetirementTime(retirement_time_);
+            return session;
+        }
+
         Player* Game::GetPlayer(const PlayerToken& token) {
             auto it = players_.find(token);
             if (it != players_.end()) {
@@ -270,31 +461,121 @@ namespace application {
         }
 
         void Game::ProcessTimeMovement(int time) {
+            PROFILE_ZONE("Game::ProcessTimeMovement");
+            RemoveEmptySessions();
+
+            std::vector<GameSession*> sessions;
+            for (auto& [map_id, map_sessions] : sessions_) {
+                for (auto& session : map_sessions) {
+                    sessions.push_back(&session);
+                }
+            }
+
+            //     ,  :     ,
+            //       
+            std::size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+            std::size_t num_chunks = std::min(num_threads, sessions.size());
+
+            auto process_chunk = [&sessions, num_chunks, time](std::size_t chunk) {
+                for (std::size_t i = chunk; i < sessions.size(); i += num_chunks) {
+                    sessions[i]->ProcessTick(time);
+                }
+            };
+
             std::vector<std::future<void>> futures;
-            std::size_t num_threads = std::thread::hardware_concurrency();
-            futures.reserve(sessions_.size());
+            futures.reserve(num_chunks);
 
-            for (auto& session : sessions_) {
-                futures.emplace_back(std::async(std::launch::async, [&session, time]() {
-                    session.second.ProcessTick(time);
-                    }));
+            for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+                futures.emplace_back(std::async(std::launch::async, process_chunk, chunk));
+            }
+
+            if (num_chunks > 0) {
+                process_chunk(0);
             }
 
             //    
             for (auto& future : futures) {
                 future.get();
             }
+
+            CollectRetiredPlayers();
         }
 
-        void Game::AddSession(GameSession& session) {
-            sessions_.emplace(session.GetMap()->GetId(), session);
+        void Game::CollectRetiredPlayers() {
+            std::vector<PlayerRecord> records;
+
+            for (auto& [map_id, map_sessions] : sessions_) {
+                for (auto& session : map_sessions) {
+                    for (auto& retired : session.TakeRetiredPlayers()) {
+                        players_.erase(retired.token);
+                        records.push_back(std::move(retired.record));
+                    }
+                }
+            }
+
+            if (record_sink_ && !records.empty()) {
+                record_sink_->Publish(std::move(records));
+            }
+        }
+
+        GameSession& Game::AddSession(const GameSession& session) {
+            auto& added = sessions_[session.GetMap()->GetId()].emplace_back(session);
+            added.SetRetirementTime(retirement_time_);
+            return added;
         }
 
-        const std::map<std::string, GameSession>& Game::GetSessions() const {
+        size_t Game::RemoveEmptySessions() {
+            size_t removed = 0;
+
+            for (auto it = sessions_.begin(); it != sessions_.end();) {
+                removed += it->second.remove_if([](const GameSession& session) {
+                    return session.GetPlayers().empty();
+                });
+
+                if (it->second.empty()) {
+                    it = sessions_.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+
+            return removed;
+        }
+
+        void Game::SetSessionPolicy(SessionPolicy policy) {
+            session_policy_ = policy;
+        }
+
+        const SessionPolicy& Game::GetSessionPolicy() const {
+            return session_policy_;
+        }
+
+        void Game::SetRetirementTime(std::chrono::milliseconds time) {
+            retirement_time_ = time;
+        }
+
+        std::chrono::milliseconds Game::GetRetirementTime() const {
+            return retirement_time_;
+        }
+
+        void Game::SetRecordSink(PlayerRecordSink* sink) {
+            record_sink_ = sink;
+        }
+
+        void Game::SetAreaOfInterest(AreaOfInterest area) {
+            area_of_interest_ = area;
+        }
+
+        const AreaOfInterest& Game::GetAreaOfInterest() const {
+            return area_of_interest_;
+        }
+
+        const Game::Sessions& Game::GetSessions() const {
             return sessions_;
         }
 
-        std::map<std::string, GameSession>& Game::GetSessions() {
+        Game::Sessions& Game::GetSessions() {
             return sessions_;
         }
 
@@ -306,12 +587,5 @@ namespace application {
             return loot_generator_;
         }
 
-        GameSession& Game::GetSession(const std::string& map_id) {
-            auto it = sessions_.find(map_id);
-            if (it != sessions_.end()) {
-                return it->second;
-            }
-        }
-
     } // namespace game
 } // namespace application
\ No newline at end of file
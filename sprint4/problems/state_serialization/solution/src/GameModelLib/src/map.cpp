@@ -113,9 +113,13 @@ namespace application {
             }
 
             utils::Coordinates Map::GetRandomPosition() const {
+                return GetRandomPosition(GetRandomEngine());
+            }
+
+            utils::Coordinates Map::GetRandomPosition(utils::RandomEngine& engine) const {
                 utils::Coordinates result;
 
-                size_t road_index = GetRandomInteger(roads_.size() - 1);
+                size_t road_index = GetRandomInteger(roads_.size() - 1, engine);
                 int road_length = 0;
 
                 const Road& road = roads_[road_index];
@@ -131,7 +135,7 @@ namespace application {
                     result.x = start.x;
                 }
 
-                double random_position = GetRandomReal(static_cast<double>(road_length));
+                double random_position = GetRandomReal(static_cast<double>(road_length), engine);
 
                 if (road.IsHorizontal()) {
                     result.x = std::min(road.GetStart().x, road.GetEnd().x) + static_cast<int>(random_position);
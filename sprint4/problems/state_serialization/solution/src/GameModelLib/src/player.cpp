@@ -2,6 +2,7 @@
 #include "game.h"
 
 #include <iostream>
+#include <utility>
 
 namespace application {
     namespace game {
@@ -77,8 +78,23 @@ namespace application {
             }
 
             void Player::SetDirection(Direction direction) {
+                const bool was_idle = IsIdle();
                 dog_.SetDirection(direction);
                 ChangeSpeed();
+                OnSpeedChanged(was_idle);
+            }
+
+            void Player::Stop() {
+                const bool was_idle = IsIdle();
+                dog_.SetSpeed({ 0.0, 0.0 });
+                OnSpeedChanged(was_idle);
+            }
+
+            void Player::OnSpeedChanged(bool was_idle) {
+                if (!was_idle && IsIdle()) {
+                    idle_started_ = true;
+                }
+                session_.MarkStateChanged();
             }
 
             void Player::ChangeSpeed() {
@@ -247,6 +263,31 @@ namespace application {
             const Dog& Player::GetDog() const {
                 return dog_;
             }
+
+            int64_t Player::GetPlayTime() const {
+                return session_.GetTime() - join_time_;
+            }
+
+            void Player::SetJoinTime(int64_t time) {
+                join_time_ = time;
+            }
+
+            bool Player::IsIdle() const {
+                auto speed = dog_.GetSpeed();
+                return speed.x == 0.0 && speed.y == 0.0;
+            }
+
+            int64_t Player::GetIdleTime() const {
+                return IsIdle() ? session_.GetTime() - idle_since_ : 0;
+            }
+
+            void Player::SetIdleSince(int64_t time) {
+                idle_since_ = time;
+            }
+
+            bool Player::TakeIdleStarted() {
+                return std::exchange(idle_started_, false);
+            }
             
         } // namespace player
     } // namespace game
@@ -7,18 +7,31 @@ namespace application {
                 return std::sqrt(std::pow(end.x - start.x, 2) + std::pow(end.y - start.y, 2));
             }
 
+            RandomEngine& GetRandomEngine() {
+                static RandomEngine engine{ std::random_device{}() };
+                return engine;
+            }
+
+            void SetRandomSeed(RandomEngine::result_type seed) {
+                GetRandomEngine().seed(seed);
+            }
+
             size_t GetRandomInteger(size_t max_value) {
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
+                return GetRandomInteger(max_value, GetRandomEngine());
+            }
+
+            size_t GetRandomInteger(size_t max_value, RandomEngine& engine) {
                 std::uniform_int_distribution<size_t> dist(0, max_value);
-                return dist(gen);
+                return dist(engine);
             }
 
             double GetRandomReal(double max_value) {
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
+                return GetRandomReal(max_value, GetRandomEngine());
+            }
+
+            double GetRandomReal(double max_value, RandomEngine& engine) {
                 std::uniform_real_distribution<> dist(0.0, max_value);
-                return dist(gen);
+                return dist(engine);
             }
         }
     }
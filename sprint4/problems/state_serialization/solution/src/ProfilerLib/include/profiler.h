@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/*
+ * Встроенный профилировщик горячих участков.
+ * Участок кода отмечается PROFILE_ZONE("Name") в начале области видимости. Каждый поток пишет
+ * в собственное дерево вызовов, поэтому запись не конкурирует с другими потоками.
+ * Пока профилировщик выключен, зона стоит одно чтение атомарного флага.
+ */
+namespace profiler {
+    namespace detail {
+        extern std::atomic<bool> enabled;
+        extern std::atomic<bool> tracing;
+
+        struct ThreadProfile;
+    }
+
+    inline bool IsEnabled() {
+        return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    void Enable(bool is_enabled);
+
+    // Обнуляет накопленное время, не трогая открытые в данный момент зоны
+    void Reset();
+
+    // Свёрнутые стеки для flamegraph.pl: "Zone;Child;Grandchild <собственное время в мкс>"
+    void WriteFoldedStacks(std::ostream& output);
+
+    // Начинает запись событий для Chrome trace на ближайшие tick_count тиков.
+    // Возвращает false, если запись уже идёт
+    bool StartTraceCapture(int tick_count);
+
+    bool IsTraceReady();
+
+    // JSON в формате Chrome trace (chrome://tracing, ui.perfetto.dev) последней завершённой записи.
+    // Возвращает false, если завершённой записи нет
+    bool WriteChromeTrace(std::ostream& output);
+
+    // Отмечает начало игрового тика: по тикам отсчитывается длина записи Chrome trace
+    void OnTickBegin();
+
+    class Zone {
+    public:
+        // name должен жить до конца программы: используются строковые литералы
+        explicit Zone(const char* name) {
+            if (IsEnabled()) {
+                Enter(name);
+            }
+        }
+
+        ~Zone() {
+            if (thread_) {
+                Exit();
+            }
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    private:
+        void Enter(const char* name);
+
+        void Exit();
+
+        detail::ThreadProfile* thread_ = nullptr;
+        uint32_t node_ = 0;
+        int64_t start_ns_ = 0;
+    };
+} // namespace profiler
+
+#define PROFILE_ZONE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ::profiler::Zone PROFILE_ZONE_CONCAT(profile_zone_, __LINE__)(name)
@@ -0,0 +1,320 @@
+#include "profiler.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace profiler {
+    namespace {
+        constexpr uint32_t NO_NODE = UINT32_MAX;
+        // Кольцевой буфер событий Chrome trace на поток: ~1.5 МБ, выделяется только при записи
+        constexpr size_t MAX_TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+        const auto EPOCH = std::chrono::steady_clock::now();
+
+        int64_t NowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - EPOCH).count();
+        }
+    }
+
+    namespace detail {
+        std::atomic<bool> enabled{ false };
+        std::atomic<bool> tracing{ false };
+
+        struct Node {
+            const char* name;
+            uint32_t parent;
+            uint32_t first_child = NO_NODE;
+            uint32_t next_sibling = NO_NODE;
+            int64_t total_ns = 0;
+            uint64_t count = 0;
+        };
+
+        struct TraceEvent {
+            const char* name;
+            int64_t start_ns;
+            int64_t duration_ns;
+        };
+
+        // Дерево вызовов и события одного потока. Мьютекс захватывает только сам поток,
+        // кроме редких выгрузок, поэтому он практически никогда не конкурирует
+        struct ThreadProfile {
+            explicit ThreadProfile(uint32_t id)
+                : id(id) {
+                nodes.push_back(Node{ .name = "root", .parent = NO_NODE });
+            }
+
+            uint32_t FindOrAddChild(const char* name) {
+                uint32_t last_child = NO_NODE;
+                for (uint32_t child = nodes[current].first_child; child != NO_NODE; child = nodes[child].next_sibling) {
+                    if (nodes[child].name == name || std::strcmp(nodes[child].name, name) == 0) {
+                        return child;
+                    }
+                    last_child = child;
+                }
+
+                auto index = static_cast<uint32_t>(nodes.size());
+                nodes.push_back(Node{ .name = name, .parent = current });
+                if (last_child == NO_NODE) {
+                    nodes[current].first_child = index;
+                }
+                else {
+                    nodes[last_child].next_sibling = index;
+                }
+                return index;
+            }
+
+            void PushEvent(const TraceEvent& event) {
+                if (events.size() < MAX_TRACE_EVENTS_PER_THREAD) {
+                    events.push_back(event);
+                }
+                else {
+                    events[next_event] = event;
+                }
+                next_event = (next_event + 1) % MAX_TRACE_EVENTS_PER_THREAD;
+            }
+
+            std::mutex mutex;
+            const uint32_t id;
+            std::vector<Node> nodes;
+            uint32_t current = 0;
+            std::vector<TraceEvent> events;
+            size_t next_event = 0;
+        };
+    } // namespace detail
+
+    namespace {
+        using detail::ThreadProfile;
+
+        class Registry {
+        public:
+            static Registry& Instance() {
+                // Не разрушается при выходе: потоки могут завершаться позже статических объектов
+                static Registry* instance = new Registry;
+                return *instance;
+            }
+
+            ThreadProfile* Acquire() {
+                std::lock_guard lock(mutex_);
+                if (!free_.empty()) {
+                    auto* profile = free_.back();
+                    free_.pop_back();
+                    return profile;
+                }
+                profiles_.push_back(std::make_unique<ThreadProfile>(static_cast<uint32_t>(profiles_.size())));
+                return profiles_.back().get();
+            }
+
+            void Release(ThreadProfile* profile) {
+                std::lock_guard lock(mutex_);
+                free_.push_back(profile);
+            }
+
+            template <typename Fn>
+            void ForEach(Fn&& fn) {
+                std::lock_guard lock(mutex_);
+                for (auto& profile : profiles_) {
+                    std::lock_guard profile_lock(profile->mutex);
+                    fn(*profile);
+                }
+            }
+        private:
+            std::mutex mutex_;
+            std::vector<std::unique_ptr<ThreadProfile>> profiles_;
+            std::vector<ThreadProfile*> free_;
+        };
+
+        // Игровые сессии обрабатываются в std::async, который может создавать поток на каждый тик,
+        // поэтому профиль завершившегося потока возвращается в пул, а не копится
+        struct ThreadProfileHolder {
+            ~ThreadProfileHolder() {
+                if (profile) {
+                    Registry::Instance().Release(profile);
+                }
+            }
+
+            ThreadProfile* profile = nullptr;
+        };
+
+        thread_local ThreadProfileHolder thread_profile_holder;
+
+        ThreadProfile& CurrentThreadProfile() {
+            if (!thread_profile_holder.profile) {
+                thread_profile_holder.profile = Registry::Instance().Acquire();
+            }
+            return *thread_profile_holder.profile;
+        }
+
+        enum class CaptureState {
+            IDLE, ARMED, CAPTURING, READY
+        };
+
+        std::atomic<CaptureState> capture_state{ CaptureState::IDLE };
+        std::mutex capture_mutex;
+        int capture_ticks_left = 0;
+
+        void WriteJsonString(std::ostream& output, const char* str) {
+            output << '"';
+            for (; *str; ++str) {
+                if (*str == '"' || *str == '\\') {
+                    output << '\\';
+                }
+                output << *str;
+            }
+            output << '"';
+        }
+    }
+
+    void Enable(bool is_enabled) {
+        detail::enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    void Reset() {
+        Registry::Instance().ForEach([](ThreadProfile& profile) {
+            for (auto& node : profile.nodes) {
+                node.total_ns = 0;
+                node.count = 0;
+            }
+        });
+    }
+
+    void WriteFoldedStacks(std::ostream& output) {
+        std::map<std::string, int64_t> stacks;
+
+        Registry::Instance().ForEach([&stacks](ThreadProfile& profile) {
+            const auto& nodes = profile.nodes;
+            // Родитель всегда добавляется раньше потомка, поэтому пути строятся одним проходом
+            std::vector<std::string> paths(nodes.size());
+            std::vector<int64_t> self_ns(nodes.size());
+
+            for (size_t i = 1; i < nodes.size(); ++i) {
+                auto parent = nodes[i].parent;
+                paths[i] = parent == 0 ? nodes[i].name : paths[parent] + ";" + nodes[i].name;
+                self_ns[i] += nodes[i].total_ns;
+                if (parent != 0) {
+                    self_ns[parent] -= nodes[i].total_ns;
+                }
+            }
+
+            for (size_t i = 1; i < nodes.size(); ++i) {
+                stacks[paths[i]] += self_ns[i];
+            }
+        });
+
+        for (const auto& [path, ns] : stacks) {
+            if (auto us = ns / 1000; us > 0) {
+                output << path << ' ' << us << '\n';
+            }
+        }
+    }
+
+    bool StartTraceCapture(int tick_count) {
+        if (tick_count <= 0) {
+            return false;
+        }
+
+        std::lock_guard lock(capture_mutex);
+        auto state = capture_state.load();
+        if (state == CaptureState::ARMED || state == CaptureState::CAPTURING) {
+            return false;
+        }
+
+        // Без включённого профилировщика зоны не создаются и записывать нечего
+        Enable(true);
+        capture_ticks_left = tick_count;
+        capture_state = CaptureState::ARMED;
+        return true;
+    }
+
+    bool IsTraceReady() {
+        return capture_state.load() == CaptureState::READY;
+    }
+
+    void OnTickBegin() {
+        auto state = capture_state.load(std::memory_order_relaxed);
+        if (state != CaptureState::ARMED && state != CaptureState::CAPTURING) {
+            return;
+        }
+
+        std::lock_guard lock(capture_mutex);
+        if (capture_state == CaptureState::ARMED) {
+            Registry::Instance().ForEach([](ThreadProfile& profile) {
+                profile.events.clear();
+                profile.next_event = 0;
+            });
+            detail::tracing = true;
+            capture_state = CaptureState::CAPTURING;
+        }
+        else if (capture_state == CaptureState::CAPTURING && --capture_ticks_left == 0) {
+            detail::tracing = false;
+            capture_state = CaptureState::READY;
+        }
+    }
+
+    bool WriteChromeTrace(std::ostream& output) {
+        if (!IsTraceReady()) {
+            return false;
+        }
+
+        output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool is_first = true;
+        auto separator = [&output, &is_first] {
+            if (!is_first) {
+                output << ",\n";
+            }
+            is_first = false;
+        };
+
+        Registry::Instance().ForEach([&](ThreadProfile& profile) {
+            if (profile.events.empty()) {
+                return;
+            }
+
+            separator();
+            output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << profile.id
+                << ",\"args\":{\"name\":\"thread " << profile.id << "\"}}";
+
+            for (const auto& event : profile.events) {
+                separator();
+                output << "{\"name\":";
+                WriteJsonString(output, event.name);
+                output << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << profile.id
+                    << ",\"ts\":" << event.start_ns / 1000 << '.' << event.start_ns / 100 % 10
+                    << ",\"dur\":" << event.duration_ns / 1000 << '.' << event.duration_ns / 100 % 10 << '}';
+            }
+        });
+
+        output << "]}\n";
+        return true;
+    }
+
+    void Zone::Enter(const char* name) {
+        auto& profile = CurrentThreadProfile();
+        {
+            std::lock_guard lock(profile.mutex);
+            node_ = profile.FindOrAddChild(name);
+            profile.current = node_;
+        }
+        thread_ = &profile;
+        start_ns_ = NowNs();
+    }
+
+    void Zone::Exit() {
+        auto duration_ns = NowNs() - start_ns_;
+
+        std::lock_guard lock(thread_->mutex);
+        auto& node = thread_->nodes[node_];
+        node.total_ns += duration_ns;
+        ++node.count;
+        thread_->current = node.parent;
+
+        if (detail::tracing.load(std::memory_order_relaxed)) {
+            thread_->PushEvent(detail::TraceEvent{ .name = node.name, .start_ns = start_ns_, .duration_ns = duration_ns });
+        }
+    }
+} // namespace profiler
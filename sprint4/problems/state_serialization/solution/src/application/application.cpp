@@ -1,9 +1,10 @@
 #include "application.h"
+#include "profiler.h"
 
 using namespace application;
 
 Application::Application(Game&& game, loot_type_info::LootTypeInfo&& type_info, const std::string& state_file, int save_state_period)
-	: game_(std::move(game)), loot_type_info_(std::move(type_info)), state_file_(state_file), save_state_period_(save_state_period_) {
+	: game_(std::move(game)), loot_type_info_(std::move(type_info)), state_file_(state_file), save_state_period_(save_state_period) {
 }
 
 std::pair<PlayerToken, size_t> Application::JoinGame(const Map* map, std::string& name) {
@@ -23,6 +24,9 @@ Player* Application::GetPlayer(const PlayerToken& token) {
 }
 
 void Application::ProcessTime(int time) {
+	profiler::OnTickBegin();
+	PROFILE_ZONE("Application::ProcessTime");
+
 	game_.ProcessTimeMovement(time);
 
 	if (save_state_period_ != -1) {
@@ -39,6 +43,7 @@ void Application::SaveGame() {
 		return;
 	}
 
+	PROFILE_ZONE("Application::SaveGame");
 	std::ofstream ofs(state_file_);
 	serialization::GameSerialization game_ser = serialization::GameSerialization::FromGame(game_);
 	boost::archive::text_oarchive oa(ofs);
@@ -49,4 +54,8 @@ void Application::SaveGame() {
 
 const loot_type_info::LootTypeInfo& Application::GetLootTypeInfo() const {
 	return loot_type_info_;
+}
+
+const Game& Application::GetGame() const {
+	return game_;
 }
\ No newline at end of file
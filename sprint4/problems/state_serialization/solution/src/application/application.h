@@ -53,6 +53,8 @@ namespace application {
 
 		const loot_type_info::LootTypeInfo& GetLootTypeInfo() const;
 
+		const Game& GetGame() const;
+
 	private:
 		Game game_;
 		loot_type_info::LootTypeInfo loot_type_info_;
@@ -53,6 +53,8 @@ namespace application {
 
             player_ser.dog_ = DogSerialization::FromDog(player.GetDog());
             player_ser.score_ = player.GetScore();
+            player_ser.play_time_ = player.GetPlayTime();
+            player_ser.idle_time_ = player.GetIdleTime();
 
             for (const auto& loot : player.GetLoots()) {
                 player_ser.loots_.emplace_back(LootSerialization::FromLoot(loot));
@@ -65,6 +67,8 @@ namespace application {
             Player player(dog_.ToDog(), session);
 
             player.SetScore(score_);
+            player.SetJoinTime(session.GetTime() - play_time_);
+            player.SetIdleSince(session.GetTime() - idle_time_);
 
             for (const auto& loot : loots_) {
                 player.AddLoot(loot.ToLoot());
@@ -109,8 +113,10 @@ namespace application {
         GameSerialization GameSerialization::FromGame(const Game& game) {
             GameSerialization game_ser;
 
-            for (const auto& [map_id, session] : game.GetSessions()) {
-                game_ser.sessions_.push_back(GameSessionSerialization::FromGameSession(session));
+            for (const auto& [map_id, map_sessions] : game.GetSessions()) {
+                for (const auto& session : map_sessions) {
+                    game_ser.sessions_.push_back(GameSessionSerialization::FromGameSession(session));
+                }
             }
 
             return game_ser;
@@ -118,11 +124,10 @@ namespace application {
 
         Game GameSerialization::ToGame(Game& game) {
             for (auto& session_ser : sessions_) {
-                auto session = session_ser.ToGameSession(*game.GetMap(session_ser.map_id), game.IsSpawnRandom(), game.GetLootGenerator());
-                game.AddSession(session);
+                auto& session = game.AddSession(session_ser.ToGameSession(*game.GetMap(session_ser.map_id), game.IsSpawnRandom(), game.GetLootGenerator()));
 
                 for (auto& [token_str, player_ser] : session_ser.players_) {
-                    game.AddPlayer(session_ser.map_id, PlayerToken::FromString(token_str), player_ser.ToPlayer(game.GetSession(session_ser.map_id)));
+                    game.AddPlayer(session, PlayerToken::FromString(token_str), player_ser.ToPlayer(session));
                 }
             }
 
@@ -6,6 +6,7 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "iostream"
 
@@ -63,15 +64,22 @@ namespace application {
             Player ToPlayer(GameSession& session) const;
 
             template <typename Archive>
-            void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+            void serialize(Archive& ar, const unsigned version) {
                 ar& dog_;
                 ar& score_;
                 ar& loots_;
+                // Версия 1: время в игре и простоя. В старых сохранениях простой отсчитывается с загрузки
+                if (version >= 1) {
+                    ar& play_time_;
+                    ar& idle_time_;
+                }
             }
         private:
             DogSerialization dog_;
             size_t score_;
             std::vector<LootSerialization> loots_;
+            int64_t play_time_ = 0;
+            int64_t idle_time_ = 0;
         };
 
         class GameSessionSerialization {
@@ -110,4 +118,6 @@ namespace application {
             std::vector<GameSessionSerialization> sessions_;
         };
     }
-} // namespace application
\ No newline at end of file
+} // namespace application
+
+BOOST_CLASS_VERSION(application::serialization::PlayerSerialization, 1)
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "json_loader.h"
+#include "application.h"
+#include "input_log.h"
+#include "state_hash.h"
+
+#include <boost/program_options.hpp>
+#include <boost/json/src.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace std::literals;
+
+/*
+ * Воспроизводит журнал, записанный game_server --record-file, напрямую через Application,
+ * без сокетов и таймеров, так быстро, как получается.
+ * Код возврата ненулевой, если хэш состояния разошёлся с записанным
+ * или скорость оказалась ниже --min-ticks-per-second.
+ */
+
+struct Args {
+    std::string config_file;
+    std::string record_file;
+    std::string hash_file;
+    std::optional<double> min_ticks_per_second;
+};
+
+[[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc{ "Allowed options" };
+    Args args;
+
+    desc.add_options()
+        ("help,h", "produce help message")
+        ("config-file,c", po::value(&args.config_file)->value_name("file"), "set config file path")
+        ("record-file,r", po::value(&args.record_file)->value_name("file"), "set recorded input log path")
+        ("hash-file", po::value(&args.hash_file)->value_name("file"), "write state hash of every tick to file")
+        ("min-ticks-per-second", po::value<double>()->value_name("ticks"), "fail if replay is slower");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    if (args.config_file.empty() || args.record_file.empty()) {
+        std::cerr << "Config file and record file must be specified.\n";
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    if (vm.count("min-ticks-per-second")) {
+        args.min_ticks_per_second = vm["min-ticks-per-second"].as<double>();
+    }
+
+    return args;
+}
+
+struct ReplayStats {
+    size_t joins = 0;
+    size_t actions = 0;
+    size_t ticks = 0;
+    size_t hash_mismatches = 0;
+    std::optional<size_t> first_mismatch_tick;
+    int64_t game_time = 0;
+    std::chrono::nanoseconds tick_time{};
+    std::chrono::nanoseconds total_time{};
+};
+
+std::optional<application::game::Direction> ParseMove(char move) {
+    using application::game::Direction;
+
+    switch (move) {
+    case 'U':
+        return Direction::NORTH;
+    case 'D':
+        return Direction::SOUTH;
+    case 'R':
+        return Direction::EAST;
+    case 'L':
+        return Direction::WEST;
+    }
+    return std::nullopt;
+}
+
+ReplayStats Replay(const Args& args, std::ostream* hash_output) {
+    using Clock = std::chrono::steady_clock;
+
+    std::ifstream record_stream(args.record_file, std::ios::binary);
+    if (!record_stream) {
+        throw std::runtime_error("Could not open record file: " + args.record_file);
+    }
+
+    recording::InputLogReader reader(record_stream);
+    const auto& header = reader.GetHeader();
+
+    if (header.config_hash != recording::HashFile(args.config_file)) {
+        throw std::runtime_error("Config file differs from the one used for recording");
+    }
+
+    application::game::utils::SetRandomSeed(static_cast<application::game::utils::RandomEngine::result_type>(header.random_seed));
+
+    json_loader::GameLoader game_loader(header.randomize_spawn_points);
+    auto game = game_loader.Load(args.config_file);
+    game.SetSessionPolicy(application::game::SessionPolicy{
+        .max_players = static_cast<size_t>(header.max_players_per_session),
+        .placement = static_cast<application::game::SessionPlacement>(header.session_placement) });
+    application::Application application(std::move(game), std::move(game_loader.GetLootTypeInfo()), "", -1);
+
+    std::vector<application::game::PlayerToken> tokens;
+    ReplayStats stats;
+
+    auto replay_start = Clock::now();
+
+    while (auto record = reader.Next()) {
+        if (const auto* join = std::get_if<recording::JoinRecord>(&record->data)) {
+            const auto* map = application.GetMap(join->map_id);
+            if (!map) {
+                throw std::runtime_error("Map from record not found: " + join->map_id);
+            }
+
+            std::string user_name = join->user_name;
+            tokens.push_back(application.JoinGame(map, user_name).first);
+            ++stats.joins;
+        }
+        else if (const auto* action = std::get_if<recording::ActionRecord>(&record->data)) {
+            auto* player = application.GetPlayer(tokens.at(action->player_index));
+            if (auto direction = ParseMove(action->move); player && direction) {
+                player->SetDirection(*direction);
+            }
+            else if (player && action->move == '\0') {
+                player->Stop();
+            }
+            ++stats.actions;
+        }
+        else if (const auto* tick = std::get_if<recording::TickRecord>(&record->data)) {
+            auto tick_start = Clock::now();
+            application.ProcessTime(static_cast<int>(tick->time_delta));
+            stats.tick_time += Clock::now() - tick_start;
+
+            auto hash = recording::ComputeStateHash(application.GetGame());
+            if (hash != tick->state_hash) {
+                ++stats.hash_mismatches;
+                if (!stats.first_mismatch_tick) {
+                    stats.first_mismatch_tick = stats.ticks;
+                }
+            }
+
+            if (hash_output) {
+                *hash_output << stats.ticks << ' ' << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << '\n';
+            }
+
+            stats.game_time += tick->time_delta;
+            ++stats.ticks;
+        }
+    }
+
+    stats.total_time = Clock::now() - replay_start;
+
+    return stats;
+}
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseCommandLine(argc, argv);
+
+        if (!args) {
+            return EXIT_FAILURE;
+        }
+
+        std::ofstream hash_file;
+        if (!args->hash_file.empty()) {
+            hash_file.open(args->hash_file);
+        }
+
+        auto stats = Replay(*args, hash_file.is_open() ? &hash_file : nullptr);
+
+        using Seconds = std::chrono::duration<double>;
+        double tick_seconds = std::chrono::duration_cast<Seconds>(stats.tick_time).count();
+        double total_seconds = std::chrono::duration_cast<Seconds>(stats.total_time).count();
+        double ticks_per_second = tick_seconds > 0 ? stats.ticks / tick_seconds : 0.0;
+
+        std::cout << "joins: " << stats.joins << "\n"
+            << "actions: " << stats.actions << "\n"
+            << "ticks: " << stats.ticks << "\n"
+            << "ticks/s: " << ticks_per_second << "\n"
+            << "game time: " << stats.game_time / 1000.0 << " s\n"
+            << "wall time: " << total_seconds << " s\n"
+            << "speedup: " << (total_seconds > 0 ? stats.game_time / 1000.0 / total_seconds : 0.0) << "x\n"
+            << "hash mismatches: " << stats.hash_mismatches << std::endl;
+
+        bool is_ok = true;
+
+        if (stats.first_mismatch_tick) {
+            std::cerr << "State diverged from recording at tick " << *stats.first_mismatch_tick << std::endl;
+            is_ok = false;
+        }
+
+        if (args->min_ticks_per_second && ticks_per_second < *args->min_ticks_per_second) {
+            std::cerr << "Replay is slower than " << *args->min_ticks_per_second << " ticks/s" << std::endl;
+            is_ok = false;
+        }
+
+        return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
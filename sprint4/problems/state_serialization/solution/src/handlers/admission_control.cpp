@@ -0,0 +1,119 @@
+#include "admission_control.h"
+
+#include <algorithm>
+
+namespace http_handler {
+    namespace {
+        constexpr std::string_view VERDICT_NAMES[] = { "admitted", "token_rate", "ip_rate", "queue_depth", "tick_lag" };
+
+        int64_t ToNs(AdmissionControl::Clock::time_point time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        }
+    }
+
+    AdmissionControl::AdmissionControl(AdmissionSettings settings)
+        : settings_(settings)
+        , token_buckets_(settings.per_token)
+        , ip_buckets_(settings.per_ip) {
+    }
+
+    AdmissionControl::Decision AdmissionControl::Admit(std::string_view token, std::string_view ip) {
+        const auto now = Clock::now();
+
+        // Сначала глобальная перегрузка: при ней корзины клиентов не списываются
+        if (settings_.max_queue_depth > 0 && queue_depth_.load(std::memory_order_relaxed) >= settings_.max_queue_depth) {
+            return Reject(Verdict::QUEUE_DEPTH, std::chrono::seconds(1));
+        }
+
+        if (settings_.max_tick_lag.count() > 0) {
+            if (auto lag = GetTickLag(now); lag > settings_.max_tick_lag) {
+                return Reject(Verdict::TICK_LAG, lag);
+            }
+        }
+
+        Clock::duration retry_after{};
+        if (settings_.per_ip.IsEnabled() && !ip_buckets_.TryAcquire(ip, now, retry_after)) {
+            return Reject(Verdict::IP_RATE, retry_after);
+        }
+
+        if (settings_.per_token.IsEnabled() && !token.empty()) {
+            // Корзины заводятся только для токенов, найденных в игре (OnTokenVerified). Иначе клиент, присылающий
+            // каждый раз новый выдуманный токен, обходил бы ограничение и растил бы таблицу корзин.
+            // Непроверенные токены делят одну корзину на адрес; адрес с токеном не спутать: в нём есть '.' или ':'
+            auto acquired = token_buckets_.TryAcquireExisting(token, now, retry_after);
+            if (!acquired) {
+                acquired = token_buckets_.TryAcquire(ip, now, retry_after);
+            }
+            if (!*acquired) {
+                return Reject(Verdict::TOKEN_RATE, retry_after);
+            }
+        }
+
+        admitted_.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    void AdmissionControl::OnTokenVerified(std::string_view token) {
+        if (settings_.per_token.IsEnabled()) {
+            token_buckets_.Track(token, Clock::now());
+        }
+    }
+
+    void AdmissionControl::OnEnqueued() {
+        auto depth = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto max_depth = max_observed_queue_depth_.load(std::memory_order_relaxed);
+        while (depth > max_depth && !max_observed_queue_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    void AdmissionControl::OnDequeued() {
+        queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void AdmissionControl::OnTick() {
+        last_tick_ns_.store(ToNs(Clock::now()), std::memory_order_relaxed);
+    }
+
+    std::chrono::milliseconds AdmissionControl::GetTickLag(Clock::time_point now) const {
+        auto last_tick_ns = last_tick_ns_.load(std::memory_order_relaxed);
+        if (last_tick_ns == 0 || settings_.tick_period.count() <= 0) {
+            return std::chrono::milliseconds(0);
+        }
+
+        // Тик, который не случился вовремя, тоже считается опозданием: strand может быть занят целиком
+        auto since_tick = std::chrono::nanoseconds(ToNs(now) - last_tick_ns);
+        auto lag = std::chrono::duration_cast<std::chrono::milliseconds>(since_tick) - settings_.tick_period;
+        return std::max(lag, std::chrono::milliseconds(0));
+    }
+
+    AdmissionControl::Decision AdmissionControl::Reject(Verdict verdict, Clock::duration retry_after) {
+        rejected_[static_cast<size_t>(verdict)].fetch_add(1, std::memory_order_relaxed);
+
+        // Retry-After передаётся в целых секундах, округляем вверх
+        auto seconds = std::chrono::ceil<std::chrono::seconds>(retry_after);
+        return Decision{ .verdict = verdict, .retry_after = std::max(seconds, std::chrono::seconds(1)) };
+    }
+
+    void AdmissionControl::WriteMetrics(std::ostream& output) const {
+        output << "# HELP game_server_api_requests_total API requests by admission decision\n"
+            << "# TYPE game_server_api_requests_total counter\n"
+            << "game_server_api_requests_total{decision=\"" << VERDICT_NAMES[0] << "\"} " << admitted_.load(std::memory_order_relaxed) << '\n';
+        for (size_t i = 1; i < VERDICT_COUNT; ++i) {
+            output << "game_server_api_requests_total{decision=\"" << VERDICT_NAMES[i] << "\"} " << rejected_[i].load(std::memory_order_relaxed) << '\n';
+        }
+
+        output << "# HELP game_server_api_queue_depth Requests waiting for the api strand\n"
+            << "# TYPE game_server_api_queue_depth gauge\n"
+            << "game_server_api_queue_depth " << queue_depth_.load(std::memory_order_relaxed) << '\n'
+            << "# HELP game_server_api_queue_depth_max Maximum observed api strand queue depth\n"
+            << "# TYPE game_server_api_queue_depth_max gauge\n"
+            << "game_server_api_queue_depth_max " << max_observed_queue_depth_.load(std::memory_order_relaxed) << '\n'
+            << "# HELP game_server_tick_lag_ms How late the game tick is\n"
+            << "# TYPE game_server_tick_lag_ms gauge\n"
+            << "game_server_tick_lag_ms " << GetTickLag(Clock::now()).count() << '\n'
+            << "# HELP game_server_rate_limit_buckets Tracked rate limit buckets\n"
+            << "# TYPE game_server_rate_limit_buckets gauge\n"
+            << "game_server_rate_limit_buckets{key=\"token\"} " << token_buckets_.Size() << '\n'
+            << "game_server_rate_limit_buckets{key=\"ip\"} " << ip_buckets_.Size() << '\n';
+    }
+} // namespace http_handler
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "token_bucket.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace http_handler {
+    struct AdmissionSettings {
+        rate_limit::BucketSettings per_token;
+        rate_limit::BucketSettings per_ip;
+        // Запросов, ждущих api strand; 0 - без ограничения
+        int64_t max_queue_depth = 0;
+        // Насколько тик может опоздать, прежде чем новые запросы начнут отклоняться; 0 - без ограничения
+        std::chrono::milliseconds max_tick_lag{ 0 };
+        std::chrono::milliseconds tick_period{ 0 };
+    };
+
+    /*
+     * Решает, пускать ли запрос к api strand. Проверки идут до постановки в очередь strand,
+     * поэтому отклонённый запрос не задерживает остальных.
+     * Потокобезопасен: вызывается из потоков соединений.
+     */
+    class AdmissionControl {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Verdict {
+            ADMIT, TOKEN_RATE, IP_RATE, QUEUE_DEPTH, TICK_LAG
+        };
+
+        struct Decision {
+            Verdict verdict = Verdict::ADMIT;
+            std::chrono::seconds retry_after{ 0 };
+        };
+
+        explicit AdmissionControl(AdmissionSettings settings);
+
+        // token - токен из Authorization (пустой, если его нет), ip - адрес клиента
+        Decision Admit(std::string_view token, std::string_view ip);
+
+        // Токен принадлежит игроку: с этого момента его запросы ограничиваются отдельно от адреса.
+        // Вызывается из api strand, где модель можно читать
+        void OnTokenVerified(std::string_view token);
+
+        // Запрос поставлен в очередь api strand
+        void OnEnqueued();
+
+        // Запрос дождался очереди и начал выполняться в api strand
+        void OnDequeued();
+
+        // Вызывается тикером из api strand
+        void OnTick();
+
+        // Метрики в текстовом формате Prometheus
+        void WriteMetrics(std::ostream& output) const;
+    private:
+        static constexpr size_t VERDICT_COUNT = 5;
+
+        std::chrono::milliseconds GetTickLag(Clock::time_point now) const;
+
+        Decision Reject(Verdict verdict, Clock::duration retry_after);
+
+        AdmissionSettings settings_;
+        rate_limit::KeyedTokenBuckets token_buckets_;
+        rate_limit::KeyedTokenBuckets ip_buckets_;
+
+        std::atomic<int64_t> queue_depth_{ 0 };
+        std::atomic<int64_t> max_observed_queue_depth_{ 0 };
+        // Время последнего тика в наносекундах steady_clock; 0 - тиков ещё не было
+        std::atomic<int64_t> last_tick_ns_{ 0 };
+        std::atomic<uint64_t> admitted_{ 0 };
+        std::array<std::atomic<uint64_t>, VERDICT_COUNT> rejected_{};
+    };
+} // namespace http_handler
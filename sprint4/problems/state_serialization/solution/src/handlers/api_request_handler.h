@@ -2,6 +2,10 @@
 
 #include "application.h"
 #include "json_serialization.h"
+#include "input_recorder.h"
+#include "leaderboard.h"
+#include "profiler.h"
+#include "state_cache.h"
 
 #include <boost/json.hpp>
 #include <boost/beast/core.hpp>
@@ -10,6 +14,8 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/config.hpp>
+#include <algorithm>
+#include <charconv>
 #include <optional>
 
 #include <string>
@@ -33,6 +39,7 @@ namespace http_handler {
             std::string content_type = "application/json";
             bool cache_control = false;
             std::optional<std::string> allow;
+            std::optional<std::string> retry_after;
 
             bool is_body_need = true;
 
@@ -53,6 +60,10 @@ namespace http_handler {
                     response.set(http::field::allow, allow.value());
                 }
 
+                if (retry_after.has_value()) {
+                    response.set(http::field::retry_after, retry_after.value());
+                }
+
                 if (is_body_need) {
                     boost::json::object error_obj{
                     {"code", code},
@@ -75,14 +86,27 @@ namespace http_handler {
         template <typename Body, typename Allocator, typename Send>
         class GameHandler {
         public:
-            GameHandler(Application& application, http::request<Body, http::basic_fields<Allocator>>&& request, Send&& send, bool is_tick_request_allowed)
-                : application_(application), request_(std::move(request)), send_(std::move(send)), is_tick_request_allowed_(is_tick_request_allowed) {
+            GameHandler(Application& application, http::request<Body, http::basic_fields<Allocator>>&& request, Send&& send, bool is_tick_request_allowed,
+                recording::InputRecorder* recorder, StateCache* state_cache, records::Leaderboard* leaderboard)
+                : application_(application), request_(std::move(request)), send_(std::move(send)), is_tick_request_allowed_(is_tick_request_allowed)
+                , recorder_(recorder), state_cache_(state_cache), leaderboard_(leaderboard) {
             }
 
+            // Больше записей таблицы рекордов за один запрос не отдаётся
+            static constexpr size_t MAX_RECORDS_PAGE = 100;
+            // Столько символов вмещает name VARCHAR(100) в таблице итогов игроков
+            static constexpr size_t MAX_USER_NAME_LENGTH = 100;
+
             void Run() {
                 auto target = request_.target();
                 std::string target_str = std::string(target);
 
+                std::string_view target_path(target.data(), target.size());
+                std::string_view query;
+                if (auto query_start = target_path.find('?'); query_start != std::string_view::npos) {
+                    query = target_path.substr(query_start + 1);
+                    target_path = target_path.substr(0, query_start);
+                }
 
                 std::string base_target = "/api/v1/game/";
 
@@ -101,6 +125,9 @@ namespace http_handler {
                 else if (target_str == base_target + "tick" && is_tick_request_allowed_) {
                     HandleTick();
                 }
+                else if (target_path == base_target + "records" && leaderboard_) {
+                    HandleRecords(query);
+                }
                 else {
                     BadRequestBuilder handler;
                     handler.version = request_.version();
@@ -150,7 +177,12 @@ namespace http_handler {
 
                 auto* map = application_.GetMap(map_id);
 
-                if (user_name.empty()) {
+                // Длина в символах UTF-8, как её считает Postgres: продолжающие байты 10xxxxxx не считаются
+                const auto name_length = std::count_if(user_name.begin(), user_name.end(), [](char c) {
+                    return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+                });
+
+                if (user_name.empty() || static_cast<size_t>(name_length) > MAX_USER_NAME_LENGTH) {
                     BadRequestBuilder handler;
                     handler.version = request_.version();
                     handler.status = http::status::bad_request;
@@ -176,6 +208,10 @@ namespace http_handler {
 
                 auto data = application_.JoinGame(map, user_name);
 
+                if (recorder_) {
+                    recorder_->RecordJoin(map_id, user_name, data.first);
+                }
+
                 return send_(std::move(MakeJoinGameResponse(data)));
             }
 
@@ -229,11 +265,12 @@ namespace http_handler {
 
 
                 auto token = application::player::PlayerToken::FromString(auth_token);
+                auth_token_ = token;
 
                 return application_.GetPlayer(token);
             }
 
-            std::vector<Player*> GetPlayersDefaultHandler() {
+            Player* GetRequestingPlayer() {
                 if (request_.method() != http::verb::head && request_.method() != http::verb::get) {
                     BadRequestBuilder handler;
                     handler.version = request_.version();
@@ -261,6 +298,16 @@ namespace http_handler {
                     return {};
                 }
 
+                return player;
+            }
+
+            std::vector<Player*> GetPlayersDefaultHandler() {
+                auto* player = GetRequestingPlayer();
+
+                if (!player) {
+                    return {};
+                }
+
                 return player->GetSession()->GetPlayersVector();
             }
 
@@ -279,6 +326,7 @@ namespace http_handler {
                 response.keep_alive(request_.keep_alive());
 
                 if (request_.method() != http::verb::head) {
+                    PROFILE_ZONE("SerializePlayers");
                     boost::json::object json_body;
 
                     for (const auto& player : players) {
@@ -298,9 +346,9 @@ namespace http_handler {
             }
 
             void HandleState() {
-                std::vector<Player*> players = GetPlayersDefaultHandler();
+                auto* viewer = GetRequestingPlayer();
 
-                if (players.empty()) {
+                if (!viewer) {
                     return;
                 }
 
@@ -312,80 +360,126 @@ namespace http_handler {
                 response.keep_alive(request_.keep_alive());
 
                 if (request_.method() != http::verb::head) {
-                    json::object players_object;
-
-                    for (const auto& player : players) {
-                        json::object player_body;
-                        
-                        Coordinates position = player->GetPosition();
-                        Speed speed = player->GetSpeed();
-
-                        player_body["pos"] = json::array({ position.x, position.y });
-
-                        player_body["speed"] = json::array({ speed.x, speed.y });
-
-                        std::string string_direction;
-
-                        switch (player->GetDirection()) {
-                        case Direction::NORTH:
-                            string_direction = "U";
-                            break;
-                        case Direction::SOUTH:
-                            string_direction = "D";
-                            break;
-                        case Direction::EAST:
-                            string_direction = "R";
-                            break;
-                        case Direction::WEST:
-                            string_direction = "L";
-                            break;
+                    if (state_cache_ && !application_.GetGame().GetAreaOfInterest().IsEnabled()) {
+                        // Ответ одинаков для всей сессии: сериализуется и сжимается один раз на версию состояния
+                        auto accept_encoding = request_[http::field::accept_encoding];
+                        auto coding = compression::ChooseContentCoding({ accept_encoding.data(), accept_encoding.size() });
+                        auto body = state_cache_->Get(*viewer->GetSession(), coding, [this, viewer] {
+                            return SerializeState(*viewer);
+                        });
+
+                        response.body() = body.data;
+                        if (auto encoding = compression::ToHeaderValue(body.coding); !encoding.empty()) {
+                            response.set(http::field::content_encoding, beast::string_view(encoding.data(), encoding.size()));
                         }
+                        response.set(http::field::vary, "Accept-Encoding");
+                    }
+                    else {
+                        response.body() = SerializeState(*viewer);
+                    }
+                    response.content_length(response.body().size());
+                }
+                else {
+                    response.content_length(0);
+                }
 
-                        player_body["dir"] = json::value(string_direction);
+                response.prepare_payload();
 
-                        json::array bag;
-                        for (const auto& loot : player->GetLoots()) {
-                            json::object loot_obj;
-                            loot_obj["id"] = json::value(loot.id);
-                            loot_obj["type"] = json::value(loot.type_index);
+                return send_(std::move(response));
+            }
 
-                            bag.push_back(loot_obj);
-                        }
+            std::string SerializeState(Player& viewer) {
+                PROFILE_ZONE("SerializeState");
+                std::vector<const Player*> players;
+                std::vector<const Loot*> loots;
+                CollectStateObjects(viewer, players, loots);
 
-                        player_body["bag"] = bag;
-                        
-                        player_body["score"] = json::value(player->GetScore());
+                json::object players_object;
 
-                        players_object[std::to_string(player->GetId())] = json::value(player_body);
-                    }
+                for (const auto* player : players) {
+                    players_object[std::to_string(player->GetId())] = MakePlayerState(*player);
+                }
 
-                    const auto& loots = players.front()->GetSession()->GetLoots();
+                json::object lost_objects;
 
-                    json::object lost_objects;
+                for (const auto* loot : loots) {
+                    json::object loot_json;
 
-                    for (const auto& [loot_id, loot] : loots) {
-                        json::object loot_json;
+                    loot_json["type"] = json::value(loot->type_index);
+                    loot_json["pos"] = json::array{ loot->coordinates.x, loot->coordinates.y };
+                    lost_objects[std::to_string(loot->id)] = json::value(loot_json);
+                }
 
-                        loot_json["type"] = json::value(loot.type_index);
-                        loot_json["pos"] = json::array{ loot.coordinates.x, loot.coordinates.y };
-                        lost_objects[std::to_string(loot_id)] = json::value(loot_json);
-                    }
+                json::object json_body;
 
-                    json::object json_body;
+                json_body["players"] = json::value(players_object);
+                json_body["lostObjects"] = json::value(lost_objects);
 
-                    json_body["players"] = json::value(players_object);
-                    json_body["lostObjects"] = json::value(lost_objects);
+                return json::serialize(json_body);
+            }
 
-                    response.body() = json::serialize(json_body);
-                    response.content_length(response.body().size());
+            // Без области интереса клиент получает всю сессию, с ней - только окрестность своего пса
+            void CollectStateObjects(Player& viewer, std::vector<const Player*>& players, std::vector<const Loot*>& loots) {
+                auto* session = viewer.GetSession();
+                const auto& area = application_.GetGame().GetAreaOfInterest();
+
+                if (area.IsEnabled()) {
+                    session->CollectVisible(viewer, area, players, loots);
+                    return;
                 }
-                else {
-                    response.content_length(0);
+
+                for (const auto& [token, player] : session->GetPlayers()) {
+                    players.push_back(&player);
                 }
 
-                response.prepare_payload();
+                for (const auto& [loot_id, loot] : session->GetLoots()) {
+                    loots.push_back(&loot);
+                }
+            }
 
-                return send_(std::move(response));
+            static json::value MakePlayerState(const Player& player) {
+                json::object player_body;
+
+                Coordinates position = player.GetPosition();
+                Speed speed = player.GetSpeed();
+
+                player_body["pos"] = json::array({ position.x, position.y });
+
+                player_body["speed"] = json::array({ speed.x, speed.y });
+
+                std::string string_direction;
+
+                switch (player.GetDirection()) {
+                case Direction::NORTH:
+                    string_direction = "U";
+                    break;
+                case Direction::SOUTH:
+                    string_direction = "D";
+                    break;
+                case Direction::EAST:
+                    string_direction = "R";
+                    break;
+                case Direction::WEST:
+                    string_direction = "L";
+                    break;
+                }
+
+                player_body["dir"] = json::value(string_direction);
+
+                json::array bag;
+                for (const auto& loot : player.GetLoots()) {
+                    json::object loot_obj;
+                    loot_obj["id"] = json::value(loot.id);
+                    loot_obj["type"] = json::value(loot.type_index);
+
+                    bag.push_back(loot_obj);
+                }
+
+                player_body["bag"] = bag;
+
+                player_body["score"] = json::value(player.GetScore());
+
+                return json::value(player_body);
             }
 
             void HandlePlayerAction() {
@@ -416,6 +510,21 @@ namespace http_handler {
 
                 auto* player = AuthenticatePlayer();
 
+                if (!player) {
+                    // Ответ уже отправлен, если токен некорректен; корректный токен мог принадлежать ушедшему игроку
+                    if (auth_token_) {
+                        BadRequestBuilder handler;
+                        handler.version = request_.version();
+                        handler.status = http::status::unauthorized;
+                        handler.cache_control = true;
+                        handler.code = "unknownToken";
+                        handler.message = "Player token has not been found";
+
+                        handler.HandleBadRequest(std::move(send_));
+                    }
+                    return;
+                }
+
                 boost::json::value request_body;
                 request_body = boost::json::parse(request_.body());
                 std::string move_str;
@@ -451,6 +560,14 @@ namespace http_handler {
                 case 'L':
                     player->SetDirection(Direction::WEST);
                     break;
+                case '\0':
+                    // "move": "" - остановка
+                    player->Stop();
+                    break;
+                }
+
+                if (recorder_) {
+                    recorder_->RecordAction(*auth_token_, move_char);
                 }
 
                 http::response<http::string_body> response;
@@ -508,6 +625,11 @@ namespace http_handler {
                 }
 
                 application_.ProcessTime(time);
+
+                if (recorder_) {
+                    recorder_->RecordTick(time, application_.GetGame());
+                }
+
                 application_.SaveGame();
 
                 http::response<http::string_body> response;
@@ -528,10 +650,116 @@ namespace http_handler {
                 return send_(std::move(response));
             }
 
+            /*
+             * GET /api/v1/game/records?start=N&maxItems=M - места с N по N+M-1.
+             * Вместо start можно передать after=<курсор> из заголовка Link предыдущей страницы:
+             * следующая страница находится поиском по индексу, а не отсчётом start записей от начала.
+             */
+            void HandleRecords(std::string_view query) {
+                if (request_.method() != http::verb::head && request_.method() != http::verb::get) {
+                    BadRequestBuilder handler;
+                    handler.version = request_.version();
+                    handler.status = http::status::method_not_allowed;
+                    handler.allow = "GET, HEAD";
+                    handler.cache_control = true;
+                    handler.code = "invalidMethod";
+                    handler.message = "Invalid method";
+
+                    handler.HandleBadRequest(std::move(send_));
+                    return;
+                }
+
+                size_t start = 0;
+                size_t max_items = MAX_RECORDS_PAGE;
+                std::optional<records::Leaderboard::Entry> cursor;
+
+                auto start_param = GetQueryParameter(query, "start"sv);
+                auto max_items_param = GetQueryParameter(query, "maxItems"sv);
+                auto after_param = GetQueryParameter(query, "after"sv);
+
+                bool is_valid = (!start_param || ParseSize(*start_param, start))
+                    && (!max_items_param || ParseSize(*max_items_param, max_items))
+                    && max_items <= MAX_RECORDS_PAGE;
+                if (is_valid && after_param) {
+                    cursor = records::Leaderboard::ParseCursor(*after_param);
+                    is_valid = cursor.has_value() && !start_param;
+                }
+
+                if (!is_valid) {
+                    BadRequestBuilder handler;
+                    handler.version = request_.version();
+                    handler.status = http::status::bad_request;
+                    handler.cache_control = true;
+                    handler.code = "invalidArgument";
+                    handler.message = "Invalid start, maxItems or after";
+
+                    handler.HandleBadRequest(std::move(send_));
+                    return;
+                }
+
+                // Лишняя запись показывает, есть ли следующая страница
+                auto page = cursor ? leaderboard_->GetPageAfter(*cursor, max_items + 1) : leaderboard_->GetPage(start, max_items + 1);
+                const bool has_next = page.size() > max_items;
+                page.resize(std::min(page.size(), max_items));
+
+                http::response<http::string_body> response;
+                response.result(http::status::ok);
+                response.version(request_.version());
+                response.set(http::field::content_type, "application/json");
+                response.set(http::field::cache_control, "no-cache");
+                response.keep_alive(request_.keep_alive());
+
+                if (has_next && !page.empty()) {
+                    response.set(http::field::link, "</api/v1/game/records?after="s + records::Leaderboard::MakeCursor(*page.back())
+                        + "&maxItems="s + std::to_string(max_items) + ">; rel=\"next\""s);
+                }
+
+                if (request_.method() != http::verb::head) {
+                    json::array records_json;
+                    for (const auto* entry : page) {
+                        records_json.emplace_back(json::object{
+                            {"name", entry->record.name},
+                            {"score", entry->record.score},
+                            {"playTime", std::chrono::duration<double>(entry->record.play_time).count()}
+                        });
+                    }
+                    response.body() = json::serialize(records_json);
+                    response.content_length(response.body().size());
+                }
+                else {
+                    response.content_length(0);
+                }
+
+                response.prepare_payload();
+
+                return send_(std::move(response));
+            }
+
+            static std::optional<std::string_view> GetQueryParameter(std::string_view query, std::string_view name) {
+                while (!query.empty()) {
+                    auto pair = query.substr(0, query.find('&'));
+                    query.remove_prefix(std::min(query.size(), pair.size() + 1));
+
+                    if (pair.size() > name.size() && pair.starts_with(name) && pair[name.size()] == '=') {
+                        return pair.substr(name.size() + 1);
+                    }
+                }
+                return std::nullopt;
+            }
+
+            static bool ParseSize(std::string_view text, size_t& value) {
+                const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                return error == std::errc{} && end == text.data() + text.size() && !text.empty();
+            }
+
             Application& application_;
             http::request<Body, http::basic_fields<Allocator>> request_;
             Send send_;
             bool is_tick_request_allowed_;
+            recording::InputRecorder* recorder_;
+            StateCache* state_cache_;
+            records::Leaderboard* leaderboard_;
+            std::optional<PlayerToken> auth_token_;
         };
 
         template <typename Body, typename Allocator, typename Send>
@@ -620,8 +848,10 @@ namespace http_handler {
 
         class ApiRequestHandler {
         public:
-            ApiRequestHandler(Application& application, bool is_tick_request_allowed) 
-                : application_(application), is_tick_request_allowed_(is_tick_request_allowed) {
+            ApiRequestHandler(Application& application, bool is_tick_request_allowed, recording::InputRecorder* recorder = nullptr, StateCache* state_cache = nullptr,
+                records::Leaderboard* leaderboard = nullptr) 
+                : application_(application), is_tick_request_allowed_(is_tick_request_allowed), recorder_(recorder), state_cache_(state_cache)
+                , leaderboard_(leaderboard) {
             }
 
             template <typename Body, typename Allocator, typename Send>
@@ -637,7 +867,7 @@ namespace http_handler {
                 std::string base_target = "/api/v1/";
 
                 if (target_str.starts_with(base_target + "game") ) {
-                    GameHandler<Body, Allocator, Send> handler(application_, std::move(request), std::move(send), is_tick_request_allowed_);
+                    GameHandler<Body, Allocator, Send> handler(application_, std::move(request), std::move(send), is_tick_request_allowed_, recorder_, state_cache_, leaderboard_);
                     handler.Run();
                 }
                 else if (target_str == base_target + "maps") {
@@ -659,6 +889,9 @@ namespace http_handler {
 
             Application& application_;
             bool is_tick_request_allowed_;
+            recording::InputRecorder* recorder_;
+            StateCache* state_cache_;
+            records::Leaderboard* leaderboard_;
         };      
     } // namespace api_handler
 } // namespace http_handler
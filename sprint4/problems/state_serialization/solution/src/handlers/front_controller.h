@@ -3,7 +3,11 @@
 #include "serialization.h"
 #include "api_request_handler.h"
 #include "static_request_handler.h"
+#include "profiler_request_handler.h"
+#include "admission_control.h"
 #include "application.h"
+#include "input_recorder.h"
+#include "profiler.h"
 
 #include <boost/json.hpp>
 #include <boost/beast/core.hpp>
@@ -19,8 +23,10 @@
 #include <thread>
 #include <vector>
 #include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <utility>
+#include <sstream>
 
 namespace http_handler {
     namespace beast = boost::beast;
@@ -33,29 +39,126 @@ namespace http_handler {
         explicit FrontController(application::Application& application, 
             const std::string& static_root, 
             boost::asio::strand<boost::asio::io_context::executor_type>& strand, 
-            bool is_tick_request_allowed)
-            : application_(application), static_root_(static_root), strand_(strand), is_tick_request_allowed_(is_tick_request_allowed) {
+            bool is_tick_request_allowed,
+            recording::InputRecorder* recorder = nullptr,
+            bool is_profiler_allowed = false,
+            compression::Settings compression_settings = {},
+            AdmissionControl* admission = nullptr,
+            records::Leaderboard* leaderboard = nullptr,
+            bool is_metrics_allowed = false)
+            : application_(application), static_root_(static_root), strand_(strand), is_tick_request_allowed_(is_tick_request_allowed)
+            , recorder_(recorder), is_profiler_allowed_(is_profiler_allowed), state_cache_(compression_settings), admission_(admission)
+            , leaderboard_(leaderboard), is_metrics_allowed_(is_metrics_allowed) {
         }
 
+        static constexpr std::string_view METRICS_TARGET = "/api/v1/admin/metrics"sv;
+
         template <typename Body, typename Allocator, typename Send>
-        void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
+        void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send, const std::string& client_ip) {
             const std::string target = req.target().to_string();
 
-            if (target.starts_with("/api/")) {
-                boost::asio::dispatch(strand_, [this, req = std::move(req), send = std::move(send)]() mutable {
-                    api_handler::ApiRequestHandler handlerr(application_, is_tick_request_allowed_);
+            if (is_profiler_allowed_ && target.starts_with(ProfilerRequestHandler::BASE_TARGET)) {
+                ProfilerRequestHandler handler;
+                handler.HandleRequest(std::move(req), std::forward<Send>(send));
+            }
+            else if (is_metrics_allowed_ && admission_ && target == METRICS_TARGET) {
+                // Метрики отдаются в обход ограничений: они нужнее всего как раз при перегрузке
+                HandleMetrics(std::move(req), std::forward<Send>(send));
+            }
+            else if (target.starts_with("/api/")) {
+                std::string token(GetBearerToken(req));
+                if (admission_) {
+                    auto decision = admission_->Admit(token, client_ip);
+                    if (decision.verdict != AdmissionControl::Verdict::ADMIT) {
+                        return SendRejection(req, std::forward<Send>(send), decision);
+                    }
+                    admission_->OnEnqueued();
+                }
+
+                boost::asio::dispatch(strand_, [this, req = std::move(req), send = std::move(send), token = std::move(token)]() mutable {
+                    if (admission_) {
+                        admission_->OnDequeued();
+                        if (IsPlayerToken(token)) {
+                            admission_->OnTokenVerified(token);
+                        }
+                    }
+                    PROFILE_ZONE("HandleApiRequest");
+                    api_handler::ApiRequestHandler handlerr(application_, is_tick_request_allowed_, recorder_, &state_cache_, leaderboard_);
                     handlerr.HandleRequest(std::move(req), std::move(send));
                     });
             }
             else {
+                PROFILE_ZONE("HandleStaticRequest");
                 StaticRequestHandler handler(static_root_);
                 handler.HandleRequest(std::move(req), std::forward<Send>(send));
             }
         }
     private:
+        template <typename Request>
+        static std::string_view GetBearerToken(const Request& req) {
+            constexpr auto PREFIX = "Bearer "sv;
+            auto authorization = req[http::field::authorization];
+            std::string_view value(authorization.data(), authorization.size());
+            return value.starts_with(PREFIX) ? value.substr(PREFIX.size()) : std::string_view{};
+        }
+
+        // Только из strand_: читает игроков модели
+        bool IsPlayerToken(const std::string& token) {
+            if (token.size() != 32 || !std::all_of(token.begin(), token.end(), [](unsigned char c) { return std::isxdigit(c); })) {
+                return false;
+            }
+            return application_.GetPlayer(application::player::PlayerToken::FromString(token)) != nullptr;
+        }
+
+        template <typename Request, typename Send>
+        static void SendRejection(const Request& req, Send&& send, const AdmissionControl::Decision& decision) {
+            const bool is_rate_limited = decision.verdict == AdmissionControl::Verdict::TOKEN_RATE
+                || decision.verdict == AdmissionControl::Verdict::IP_RATE;
+
+            api_handler::BadRequestBuilder handler;
+            handler.version = req.version();
+            handler.keep_alive = req.keep_alive();
+            handler.cache_control = true;
+            handler.retry_after = std::to_string(decision.retry_after.count());
+            if (is_rate_limited) {
+                handler.status = http::status::too_many_requests;
+                handler.code = "tooManyRequests";
+                handler.message = "Request rate limit exceeded";
+            }
+            else {
+                handler.status = http::status::service_unavailable;
+                handler.code = "serviceUnavailable";
+                handler.message = "Server is overloaded";
+            }
+            handler.is_body_need = req.method() != http::verb::head;
+
+            handler.HandleBadRequest(std::forward<Send>(send));
+        }
+
+        template <typename Request, typename Send>
+        void HandleMetrics(Request&& req, Send&& send) const {
+            std::ostringstream metrics;
+            admission_->WriteMetrics(metrics);
+
+            http::response<http::string_body> response{ http::status::ok, req.version() };
+            response.set(http::field::content_type, "text/plain; version=0.0.4");
+            response.set(http::field::cache_control, "no-cache");
+            response.keep_alive(req.keep_alive());
+            response.body() = metrics.str();
+            response.prepare_payload();
+            send(std::move(response));
+        }
+
         application::Application& application_;
         std::string static_root_;
         boost::asio::strand<boost::asio::io_context::executor_type>& strand_;
         bool is_tick_request_allowed_;
+        recording::InputRecorder* recorder_;
+        bool is_profiler_allowed_;
+        // Обращения только из strand_, как и к остальной модели
+        api_handler::StateCache state_cache_;
+        AdmissionControl* admission_;
+        records::Leaderboard* leaderboard_;
+        bool is_metrics_allowed_;
     };
 }  // namespace http_handler
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "api_request_handler.h"
+#include "profiler.h"
+
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+
+#include <charconv>
+#include <sstream>
+#include <string>
+
+namespace http_handler {
+    namespace beast = boost::beast;
+    namespace http = beast::http;
+    using namespace std::literals;
+
+    /*
+     * Управление встроенным профилировщиком, доступно при запуске с --profiler:
+     *   POST /api/v1/admin/profiler/start|stop|reset
+     *   GET  /api/v1/admin/profiler/folded         - свёрнутые стеки для flamegraph.pl
+     *   POST /api/v1/admin/profiler/trace?ticks=N  - записать Chrome trace ближайших N тиков
+     *   GET  /api/v1/admin/profiler/trace          - результат записи
+     * Не использует игровую модель, поэтому обрабатывается вне api strand.
+     */
+    class ProfilerRequestHandler {
+    public:
+        static constexpr std::string_view BASE_TARGET = "/api/v1/admin/profiler/"sv;
+
+        template <typename Body, typename Allocator, typename Send>
+        void HandleRequest(http::request<Body, http::basic_fields<Allocator>>&& request, Send&& send) {
+            std::string_view target(request.target().data(), request.target().size());
+            std::string_view query;
+
+            if (auto query_start = target.find('?'); query_start != std::string_view::npos) {
+                query = target.substr(query_start + 1);
+                target = target.substr(0, query_start);
+            }
+
+            auto command = target.substr(BASE_TARGET.size());
+
+            if (command == "folded"sv && request.method() == http::verb::get) {
+                std::ostringstream folded;
+                profiler::WriteFoldedStacks(folded);
+                return send(MakeResponse(request, http::status::ok, "text/plain", folded.str()));
+            }
+
+            if (command == "trace"sv && request.method() == http::verb::get) {
+                std::ostringstream trace;
+                if (!profiler::WriteChromeTrace(trace)) {
+                    return SendError(request, std::forward<Send>(send), http::status::not_found, "traceNotReady", "No finished trace capture");
+                }
+                return send(MakeResponse(request, http::status::ok, "application/json", trace.str()));
+            }
+
+            if (request.method() != http::verb::post) {
+                return SendError(request, std::forward<Send>(send), http::status::bad_request, "badRequest", "Bad request");
+            }
+
+            if (command == "start"sv) {
+                profiler::Enable(true);
+            }
+            else if (command == "stop"sv) {
+                profiler::Enable(false);
+            }
+            else if (command == "reset"sv) {
+                profiler::Reset();
+            }
+            else if (command == "trace"sv) {
+                int ticks = ParseTicks(query);
+                if (ticks <= 0) {
+                    return SendError(request, std::forward<Send>(send), http::status::bad_request, "invalidArgument", "Expected ticks=<positive number>");
+                }
+                if (!profiler::StartTraceCapture(ticks)) {
+                    return SendError(request, std::forward<Send>(send), http::status::conflict, "traceInProgress", "Trace capture is already in progress");
+                }
+            }
+            else {
+                return SendError(request, std::forward<Send>(send), http::status::bad_request, "badRequest", "Bad request");
+            }
+
+            boost::json::object status{ {"enabled", profiler::IsEnabled()}, {"traceReady", profiler::IsTraceReady()} };
+            return send(MakeResponse(request, http::status::ok, "application/json", boost::json::serialize(status)));
+        }
+    private:
+        static int ParseTicks(std::string_view query) {
+            constexpr auto KEY = "ticks="sv;
+
+            int ticks = 0;
+            if (auto key_start = query.find(KEY); key_start != std::string_view::npos) {
+                auto value = query.substr(key_start + KEY.size());
+                std::from_chars(value.data(), value.data() + value.size(), ticks);
+            }
+            return ticks;
+        }
+
+        template <typename Request>
+        static http::response<http::string_body> MakeResponse(const Request& request, http::status status, beast::string_view content_type, std::string body) {
+            http::response<http::string_body> response{ status, request.version() };
+            response.set(http::field::content_type, content_type);
+            response.set(http::field::cache_control, "no-cache");
+            response.keep_alive(request.keep_alive());
+            response.body() = std::move(body);
+            response.prepare_payload();
+            return response;
+        }
+
+        template <typename Request, typename Send>
+        static void SendError(const Request& request, Send&& send, http::status status, beast::string_view code, beast::string_view message) {
+            api_handler::BadRequestBuilder handler;
+            handler.version = request.version();
+            handler.status = status;
+            handler.cache_control = true;
+            handler.code = code;
+            handler.message = message;
+
+            handler.HandleBadRequest(std::forward<Send>(send));
+        }
+    };
+} // namespace http_handler
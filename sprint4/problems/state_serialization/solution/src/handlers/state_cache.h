@@ -0,0 +1,78 @@
+#pragma once
+
+#include "game.h"
+#include "compression.h"
+#include "profiler.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace http_handler {
+    namespace api_handler {
+        /*
+         * Тело /api/v1/game/state, общее для всех клиентов сессии, пока её состояние не изменилось.
+         * Сериализуется и сжимается один раз на версию состояния, а не на каждый запрос.
+         * Используется только без области интереса: с ней у каждого клиента свой ответ.
+         * Доступ только из api strand.
+         */
+        class StateCache {
+        public:
+            struct Body {
+                const std::string& data;
+                compression::ContentCoding coding;
+            };
+
+            explicit StateCache(compression::Settings settings = {})
+                : settings_(settings) {
+            }
+
+            template <typename MakeBody>
+            Body Get(const application::game::GameSession& session, compression::ContentCoding coding, MakeBody&& make_body) {
+                // Записи удалённых сессий не отслеживаются: их адреса могут занять новые сессии,
+                // а версии у всех сессий разные. Чтобы записи не копились, кэш иногда сбрасывается целиком
+                if (entries_.size() >= MAX_ENTRIES && !entries_.contains(&session)) {
+                    entries_.clear();
+                }
+
+                auto& entry = entries_[&session];
+
+                if (entry.version != session.GetStateVersion()) {
+                    entry.version = session.GetStateVersion();
+                    entry.identity = make_body();
+                    entry.gzip.reset();
+                    entry.deflate.reset();
+                }
+
+                if (!settings_.enabled || coding == compression::ContentCoding::IDENTITY || entry.identity.size() < settings_.min_size) {
+                    return { entry.identity, compression::ContentCoding::IDENTITY };
+                }
+
+                auto& compressed = coding == compression::ContentCoding::GZIP ? entry.gzip : entry.deflate;
+                if (!compressed) {
+                    PROFILE_ZONE("CompressState");
+                    compressed.emplace();
+                    compression::Compress(coding, entry.identity, *compressed);
+                }
+
+                if (compressed->size() >= entry.identity.size()) {
+                    return { entry.identity, compression::ContentCoding::IDENTITY };
+                }
+                return { *compressed, coding };
+            }
+        private:
+            static constexpr size_t MAX_ENTRIES = 4096;
+
+            struct Entry {
+                uint64_t version = 0;
+                std::string identity;
+                std::optional<std::string> gzip;
+                std::optional<std::string> deflate;
+            };
+
+            compression::Settings settings_;
+            std::unordered_map<const application::game::GameSession*, Entry> entries_;
+        };
+    } // namespace api_handler
+} // namespace http_handler
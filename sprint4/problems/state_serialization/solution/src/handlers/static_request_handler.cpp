@@ -1,5 +1,7 @@
 #include "static_request_handler.h"
 
+#include "percent_codec.h"
+
 namespace http_handler {
 	std::string GetMimeType(const std::string& extension) {
 		static const std::unordered_map<std::string, std::string> mime_types = {
@@ -46,22 +48,6 @@ namespace http_handler {
 	}
 
 	std::string UrlDecode(const std::string& encoded) {
-		std::ostringstream decoded;
-		for (size_t i = 0; i < encoded.length(); ++i) {
-			if (encoded[i] == '%' && i + 2 < encoded.length()) {
-				std::istringstream hex_stream(encoded.substr(i + 1, 2));
-				int hex;
-				hex_stream >> std::hex >> hex;
-				decoded << static_cast<char>(hex);
-				i += 2;
-			}
-			else if (encoded[i] == '+') {
-				decoded << ' ';
-			}
-			else {
-				decoded << encoded[i];
-			}
-		}
-		return decoded.str();
+		return percent_codec::Decode(encoded);
 	}
 } // namespace http_handler
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <unordered_map>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
 
 namespace http_handler {
 	namespace beast = boost::beast;
@@ -27,6 +28,7 @@ namespace http_handler {
 
 	bool IsSubPath(const fs::path& path, const fs::path& base);
 
+	// Бросает std::invalid_argument на неполной или неверной %-последовательности
 	std::string UrlDecode(const std::string& encoded);
 
 	class StaticRequestHandler {
@@ -48,7 +50,15 @@ namespace http_handler {
 	private:
 		template <typename Body, typename Allocator, typename Send>
 		void HandleGetRequest(http::request<Body, http::basic_fields<Allocator>>&& request, Send&& send) {
-			std::string target = static_root_path_.string() + UrlDecode(request.target().to_string());
+			std::string target;
+			try {
+				target = static_root_path_.string() + UrlDecode(request.target().to_string());
+			}
+			catch (const std::invalid_argument&) {
+				HandleBadRequest(std::move(request), std::forward<Send>(send)
+					, "Bad request: Malformed URL encoding", http::status::bad_request);
+				return;
+			}
 
 			if (target == static_root_path_.string() + "/") {
 				target += "/index.html";
@@ -6,27 +6,55 @@
 #include "ticker.h"
 #include "loot_type_info.h"
 #include "serialization.h"
+#include "input_recorder.h"
+#include "profiler.h"
+#include "async_record_writer.h"
+#include "leaderboard.h"
+#include "records_repository.h"
 
 #include <boost/program_options.hpp>
 #include <boost/json/src.hpp>
 #include <boost/asio.hpp>
 
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <optional>
 #include <thread>
 
+#include <pthread.h>
+#include <sched.h>
+
 using namespace std::literals;
 
 
 namespace net = boost::asio;
 
+enum class ThreadingMode {
+    // Один io_context на все потоки: соединения обслуживает любой свободный поток
+    SHARED,
+    // io_context и SO_REUSEPORT-acceptor на каждый поток: соединение живёт на принявшем его ядре
+    PER_CORE
+};
+
 struct Args {
     std::string config_file;
     std::string state_file;
     std::string www_root;
     std::optional<int> tick_period;
     std::optional<int> save_state_period;
+    std::string record_file;
     bool randomize_spawn_points;
+    application::game::SessionPolicy session_policy;
+    application::game::AreaOfInterest area_of_interest;
+    compression::Settings compression;
+    bool no_compression = false;
+    http_handler::AdmissionSettings admission;
+    int max_tick_lag = 0;
+    ThreadingMode threading_mode = ThreadingMode::SHARED;
+    bool pin_threads = false;
+    bool profiler = false;
+    bool metrics = false;
 };
 
 [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
@@ -42,7 +70,24 @@ struct Args {
         ("www-root,w", po::value<std::string>()->value_name("dir"), "set static files root")
         ("randomize-spawn-points", po::bool_switch(&args.randomize_spawn_points)->default_value(false), "spawn dogs at random positions")
         ("state-file", po::value<std::string>()->value_name("file"), "set state file path")
-        ("save-state-period", po::value<int>()->value_name("milliseconds"), "set save state period");
+        ("save-state-period", po::value<int>()->value_name("milliseconds"), "set save state period")
+        ("max-players-per-session", po::value(&args.session_policy.max_players)->value_name("players"), "open another session of the map when this many players joined (0 - unlimited)")
+        ("session-placement", po::value<std::string>()->value_name("policy")->default_value("fill-first"), "session for a new player: fill-first or least-loaded")
+        ("aoi-radius", po::value(&args.area_of_interest.radius)->value_name("distance"), "send clients only objects within this distance of their dog (0 - whole session)")
+        ("aoi-hysteresis", po::value(&args.area_of_interest.hysteresis)->value_name("distance"), "keep visible objects until they are farther than aoi-radius plus this distance")
+        ("threading-mode", po::value<std::string>()->value_name("mode")->default_value("shared"), "shared: one io_context for all threads, per-core: io_context and SO_REUSEPORT acceptor per thread")
+        ("pin-threads", po::bool_switch(&args.pin_threads)->default_value(false), "pin worker threads to CPU cores")
+        ("no-compression", po::bool_switch(&args.no_compression)->default_value(false), "never gzip/deflate responses")
+        ("compression-min-size", po::value(&args.compression.min_size)->value_name("bytes"), "compress only responses at least this large")
+        ("rate-limit-token", po::value(&args.admission.per_token.rate)->value_name("rps"), "API requests per second allowed for one player token (0 - unlimited)")
+        ("rate-limit-token-burst", po::value(&args.admission.per_token.burst)->value_name("requests"), "burst size for --rate-limit-token")
+        ("rate-limit-ip", po::value(&args.admission.per_ip.rate)->value_name("rps"), "API requests per second allowed for one client address (0 - unlimited)")
+        ("rate-limit-ip-burst", po::value(&args.admission.per_ip.burst)->value_name("requests"), "burst size for --rate-limit-ip")
+        ("max-api-queue", po::value(&args.admission.max_queue_depth)->value_name("requests"), "answer 503 when this many API requests wait for the game strand (0 - unlimited)")
+        ("max-tick-lag", po::value(&args.max_tick_lag)->value_name("milliseconds"), "answer 503 while the game tick is late by more than this (0 - unlimited)")
+        ("record-file", po::value<std::string>()->value_name("file"), "record joins, actions and ticks for game_replay")
+        ("profiler", po::bool_switch(&args.profiler)->default_value(false), "enable in-process profiler and /api/v1/admin/profiler/ endpoints")
+        ("metrics", po::bool_switch(&args.metrics)->default_value(false), "enable the /api/v1/admin/metrics endpoint");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -87,6 +132,33 @@ struct Args {
         args.save_state_period = vm["save-state-period"].as<int>();
     }
 
+    if (auto placement = vm["session-placement"].as<std::string>(); placement == "least-loaded"sv) {
+        args.session_policy.placement = application::game::SessionPlacement::LEAST_LOADED;
+    }
+    else if (placement != "fill-first"sv) {
+        std::cerr << "Unknown session placement: " << placement << "\n";
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    args.compression.enabled = !args.no_compression;
+
+    args.admission.max_tick_lag = std::chrono::milliseconds(args.max_tick_lag);
+    args.admission.tick_period = std::chrono::milliseconds(args.tick_period.value_or(0));
+
+    if (auto mode = vm["threading-mode"].as<std::string>(); mode == "per-core"sv) {
+        args.threading_mode = ThreadingMode::PER_CORE;
+    }
+    else if (mode != "shared"sv) {
+        std::cerr << "Unknown threading mode: " << mode << "\n";
+        std::cout << desc << "\n";
+        return std::nullopt;
+    }
+
+    if (vm.count("record-file")) {
+        args.record_file = vm["record-file"].as<std::string>();
+    }
+
     return args;
 }
 
@@ -116,17 +188,47 @@ void InitializeLogger() {
 
 namespace {
 
-    // Запускает функцию fn на n потоках, включая текущий
+    constexpr const char DB_URL_ENV_NAME[]{ "GAME_DB_URL" };
+
+    // Пишет в БД только поток AsyncRecordWriter, а лучшие записи читаются один раз при старте
+    constexpr size_t RECORDS_DB_CONNECTIONS = 1;
+
+    // Итоги ушедших игроков пишутся в Postgres, если задан GAME_DB_URL, иначе хранятся в памяти до остановки.
+    // В памяти держится не больше записей, чем вмещает таблица рекордов: остальные оттуда всё равно вытеснены
+    std::unique_ptr<records::RecordRepository> MakeRecordRepository() {
+        if (const auto* url = std::getenv(DB_URL_ENV_NAME)) {
+            return std::make_unique<postgres::RecordRepositoryImpl>(url, RECORDS_DB_CONNECTIONS);
+        }
+        return std::make_unique<records::InMemoryRecordRepository>(records::Leaderboard::DEFAULT_CAPACITY);
+    }
+
+    // Запускает функцию fn(index) на n потоках, включая текущий, которому достаётся index 0
     template <typename Fn>
     void RunWorkers(unsigned numWorkers, const Fn& fn) {
         numWorkers = std::max(1u, numWorkers);
         std::vector<std::jthread> workers;
         workers.reserve(numWorkers - 1);
         // Запускаем n-1 рабочих потоков, выполняющих функцию fn
-        while (--numWorkers) {
-            workers.emplace_back(fn);
+        for (unsigned index = 1; index < numWorkers; ++index) {
+            workers.emplace_back(fn, index);
+        }
+        fn(0u);
+    }
+
+    // Закрепляет текущий поток за ядром. Неудача не фатальна: поток просто остаётся незакреплённым
+    void PinCurrentThread(unsigned core) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core % std::max(1u, std::thread::hardware_concurrency()), &cpu_set);
+        if (int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set); error != 0) {
+            boost::json::value data{
+                {"core", core},
+                {"code", error},
+                {"text", std::strerror(error)},
+                {"where", "pin thread"}
+            };
+            BOOST_LOG_TRIVIAL(warning) << boost::log::add_value(additional_data, data) << "error";
         }
-        fn();
     }
 
 }
@@ -161,11 +263,35 @@ int main(int argc, const char* argv[]) {
             std::cout << std::unitbuf;
             InitializeLogger();
 
+            // Журнал записи создаётся до загрузки игры: генератор модели засеивается seed-ом из заголовка
+            std::unique_ptr<recording::InputRecorder> recorder;
+            if (!args->record_file.empty()) {
+                recording::InputLogHeader header;
+                header.random_seed = std::random_device{}();
+                header.randomize_spawn_points = args->randomize_spawn_points;
+                header.config_hash = recording::HashFile(args->config_file);
+                header.max_players_per_session = args->session_policy.max_players;
+                header.session_placement = static_cast<uint8_t>(args->session_policy.placement);
+
+                application::game::utils::SetRandomSeed(static_cast<application::game::utils::RandomEngine::result_type>(header.random_seed));
+                recorder = std::make_unique<recording::InputRecorder>(args->record_file, header);
+            }
+
             // 1. Загружаем карту из файла и построить модель игры
 
             json_loader::GameLoader game_loader(args->randomize_spawn_points);
 
             auto game = game_loader.Load(args->config_file);
+            game.SetSessionPolicy(args->session_policy);
+            game.SetAreaOfInterest(args->area_of_interest);
+
+            // Запись не должна задерживать тик: итоги уходят в хранилище из отдельного потока
+            auto record_repository = MakeRecordRepository();
+            records::AsyncRecordWriter record_writer(*record_repository);
+            // Таблица рекордов отдаётся из памяти; ушедшие игроки попадают в неё, затем в запись в БД
+            records::Leaderboard leaderboard(records::Leaderboard::DEFAULT_CAPACITY, &record_writer);
+            leaderboard.Load(record_repository->LoadBest(leaderboard.GetCapacity()));
+            game.SetRecordSink(&leaderboard);
 
             int save_period = -1;
 
@@ -177,13 +303,27 @@ int main(int argc, const char* argv[]) {
 
             TryLoadState(application);
 
-            // 2. Инициализируем io_context
-            const unsigned num_threads = std::thread::hardware_concurrency();
-            net::io_context ioc(num_threads);
+            // 2. Инициализируем io_context: один общий или по одному на рабочий поток
+            const unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+            const bool is_per_core = args->threading_mode == ThreadingMode::PER_CORE;
+
+            std::vector<std::unique_ptr<net::io_context>> contexts;
+            if (is_per_core) {
+                for (unsigned i = 0; i < num_threads; ++i) {
+                    // Подсказка 1: контекст обслуживает ровно один поток
+                    contexts.push_back(std::make_unique<net::io_context>(1));
+                }
+            }
+            else {
+                contexts.push_back(std::make_unique<net::io_context>(num_threads));
+            }
+
+            // Сигналы, тикер и api strand живут в первом контексте
+            net::io_context& ioc = *contexts.front();
 
             // 3. Добавляем асинхронный обработчик сигналов SIGINT и SIGTERM
             net::signal_set signals(ioc, SIGINT, SIGTERM);
-            signals.async_wait([&ioc](const boost::system::error_code& ec, int /*signo*/) {
+            signals.async_wait([&contexts](const boost::system::error_code& ec, int /*signo*/) {
                 boost::json::value data;
                 if (!ec) {
                     data = { {"code", "0"} };
@@ -192,34 +332,47 @@ int main(int argc, const char* argv[]) {
                     data = { {"code", "EXIT_FAILURE"}, {"exception", ec.message()} };
                 }
                 BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "server exited";
-                ioc.stop();
+                for (auto& context : contexts) {
+                    context->stop();
+                }
                 });
 
             auto api_strand = net::make_strand(ioc);
 
+            http_handler::AdmissionControl admission(args->admission);
+
             // Настраиваем вызов метода Application::Tick каждые tick_period миллисекунд внутри strand
 
             if (args->tick_period) {
                 auto ticker = std::make_shared<Ticker>(
                     api_strand,
                     std::chrono::milliseconds(args->tick_period.value()),
-                    [&application](std::chrono::milliseconds delta) {
-                        application.ProcessTime(delta.count() / 1000.0);
+                    [&application, &recorder, &admission](std::chrono::milliseconds delta) {
+                        admission.OnTick();
+                        application.ProcessTime(delta.count());
+
+                        if (recorder) {
+                            recorder->RecordTick(delta.count(), application.GetGame());
+                        }
                     }
                 );
                 ticker->Start();
             }
 
+            profiler::Enable(args->profiler);
+
             // 4. Создаём обработчик HTTP-запросов и связываем его с моделью игры
-            http_handler::FrontController handler{ application, args->www_root, api_strand, !args->tick_period.has_value() };
+            http_handler::FrontController handler{ application, args->www_root, api_strand, !args->tick_period.has_value(), recorder.get(), args->profiler, args->compression, &admission, &leaderboard, args->metrics };
 
             // 5. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
             std::string interface_address = "0.0.0.0";
             const auto address = net::ip::make_address(interface_address);
             const unsigned short port = 8080;
-            http_server::ServeHttp(ioc, { address, port }, [&handler](auto&& req, auto&& send) {
-                handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
-                });
+            for (auto& context : contexts) {
+                http_server::ServeHttp(*context, { address, port }, [&handler](auto&& req, auto&& send, const std::string& client_ip) {
+                    handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send), client_ip);
+                    }, args->compression, is_per_core);
+            }
 
             boost::json::value data{
                 {"port", port},
@@ -228,10 +381,22 @@ int main(int argc, const char* argv[]) {
             BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "server started";
 
             // 6. Запускаем обработку асинхронных операций
-            RunWorkers(std::max(1u, num_threads), [&ioc] {
-                ioc.run();
+            RunWorkers(num_threads, [&contexts, is_per_core, pin_threads = args->pin_threads](unsigned index) {
+                if (pin_threads) {
+                    PinCurrentThread(index);
+                }
+                contexts[is_per_core ? index : 0]->run();
                 });
 
+            record_writer.Stop();
+            auto record_stats = record_writer.GetStats();
+            boost::json::value records_data{
+                {"written", record_stats.written},
+                {"dropped", record_stats.dropped},
+                {"failed", record_stats.failed}
+            };
+            BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, records_data) << "records flushed";
+
             application.SaveGame();
             BOOST_LOG_TRIVIAL(info) << "state saved end";
         }
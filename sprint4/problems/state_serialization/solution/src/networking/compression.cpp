@@ -0,0 +1,158 @@
+#include "compression.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+namespace compression {
+    namespace {
+        // Сжатие идёт на пути ответа: уровень 1 на JSON состояния в 3-4 раза быстрее уровня 6,
+        // а результат больше всего на ~10%
+        constexpr int COMPRESSION_LEVEL = 1;
+        constexpr int MEMORY_LEVEL = 8;
+        constexpr int WINDOW_BITS = 15;
+        // +16 к windowBits - обёртка gzip вместо zlib
+        constexpr int GZIP_WINDOW_BITS = WINDOW_BITS + 16;
+
+        class Deflater {
+        public:
+            explicit Deflater(int window_bits) {
+                if (deflateInit2(&stream_, COMPRESSION_LEVEL, Z_DEFLATED, window_bits, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+                    throw std::runtime_error("deflateInit2 failed");
+                }
+            }
+
+            Deflater(const Deflater&) = delete;
+            Deflater& operator=(const Deflater&) = delete;
+
+            ~Deflater() {
+                deflateEnd(&stream_);
+            }
+
+            void Compress(std::string_view input, std::string& output) {
+                deflateReset(&stream_);
+
+                output.resize(deflateBound(&stream_, static_cast<uLong>(input.size())));
+
+                stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+                stream_.avail_in = static_cast<uInt>(input.size());
+                stream_.next_out = reinterpret_cast<Bytef*>(output.data());
+                stream_.avail_out = static_cast<uInt>(output.size());
+
+                // deflateBound гарантирует, что весь результат помещается за один вызов
+                if (deflate(&stream_, Z_FINISH) != Z_STREAM_END) {
+                    throw std::runtime_error("deflate failed");
+                }
+
+                output.resize(stream_.total_out);
+            }
+        private:
+            z_stream stream_{};
+        };
+
+        Deflater& ThreadDeflater(ContentCoding coding) {
+            thread_local Deflater gzip(GZIP_WINDOW_BITS);
+            thread_local Deflater deflate(WINDOW_BITS);
+            return coding == ContentCoding::GZIP ? gzip : deflate;
+        }
+
+        std::string_view Trim(std::string_view str) {
+            while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+                str.remove_prefix(1);
+            }
+            while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+                str.remove_suffix(1);
+            }
+            return str;
+        }
+
+        bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char l, char r) {
+                return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+            });
+        }
+
+        // q-значение из параметров вида "q=0.5"; без параметра - 1
+        double ParseQuality(std::string_view params) {
+            while (!params.empty()) {
+                auto end = params.find(';');
+                auto param = Trim(params.substr(0, end));
+                params = end == std::string_view::npos ? std::string_view{} : params.substr(end + 1);
+
+                if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                    double quality = 0.0;
+                    auto value = param.substr(2);
+                    if (std::from_chars(value.data(), value.data() + value.size(), quality).ec != std::errc{}) {
+                        return 0.0;
+                    }
+                    return quality;
+                }
+            }
+            return 1.0;
+        }
+    }
+
+    ContentCoding ChooseContentCoding(std::string_view accept_encoding) {
+        std::optional<double> gzip, deflate, any;
+
+        while (!accept_encoding.empty()) {
+            auto end = accept_encoding.find(',');
+            auto item = Trim(accept_encoding.substr(0, end));
+            accept_encoding = end == std::string_view::npos ? std::string_view{} : accept_encoding.substr(end + 1);
+
+            auto params_start = item.find(';');
+            auto coding = Trim(item.substr(0, params_start));
+            double quality = params_start == std::string_view::npos ? 1.0 : ParseQuality(item.substr(params_start + 1));
+
+            if (EqualsIgnoreCase(coding, "gzip") || EqualsIgnoreCase(coding, "x-gzip")) {
+                gzip = quality;
+            }
+            else if (EqualsIgnoreCase(coding, "deflate")) {
+                deflate = quality;
+            }
+            else if (coding == "*") {
+                any = quality;
+            }
+        }
+
+        const double gzip_quality = gzip.value_or(any.value_or(0.0));
+        const double deflate_quality = deflate.value_or(any.value_or(0.0));
+
+        if (gzip_quality > 0.0 && gzip_quality >= deflate_quality) {
+            return ContentCoding::GZIP;
+        }
+        if (deflate_quality > 0.0) {
+            return ContentCoding::DEFLATE;
+        }
+        return ContentCoding::IDENTITY;
+    }
+
+    std::string_view ToHeaderValue(ContentCoding coding) {
+        switch (coding) {
+        case ContentCoding::GZIP:
+            return "gzip";
+        case ContentCoding::DEFLATE:
+            return "deflate";
+        default:
+            return {};
+        }
+    }
+
+    bool IsCompressibleContentType(std::string_view content_type) {
+        return content_type.starts_with("application/json") || content_type.starts_with("text/")
+            || content_type.starts_with("application/javascript") || content_type.starts_with("application/xml")
+            || content_type.starts_with("image/svg+xml");
+    }
+
+    void Compress(ContentCoding coding, std::string_view input, std::string& output) {
+        if (coding == ContentCoding::IDENTITY) {
+            output.assign(input);
+            return;
+        }
+        ThreadDeflater(coding).Compress(input, output);
+    }
+} // namespace compression
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ * Сжатие динамических ответов по заголовку Accept-Encoding (RFC 9110, 12.5.3).
+ * Потоки zlib создаются один раз на поток и переиспользуются через deflateReset,
+ * поэтому на ответ не выделяется ничего, кроме буфера самого тела.
+ */
+namespace compression {
+    enum class ContentCoding {
+        IDENTITY, GZIP, DEFLATE
+    };
+
+    struct Settings {
+        bool enabled = true;
+        // Меньшие тела отправляются как есть: заголовки gzip и время сжатия не окупаются
+        size_t min_size = 1024;
+    };
+
+    // Выбирает кодировку с наибольшим q; при равных q gzip предпочтительнее deflate
+    ContentCoding ChooseContentCoding(std::string_view accept_encoding);
+
+    // Значение заголовка Content-Encoding; для IDENTITY - пустая строка
+    std::string_view ToHeaderValue(ContentCoding coding);
+
+    bool IsCompressibleContentType(std::string_view content_type);
+
+    // Сжимает input в output (прежнее содержимое output теряется). Бросает std::runtime_error при ошибке zlib
+    void Compress(ContentCoding coding, std::string_view input, std::string& output);
+} // namespace compression
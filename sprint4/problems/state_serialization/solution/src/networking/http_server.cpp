@@ -17,8 +17,12 @@ namespace http_server {
             beast::bind_front_handler(&SessionBase::Read, GetSharedThis()));
     }
 
-    SessionBase::SessionBase(tcp::socket&& socket)
-        : stream_(std::move(socket)) {
+    SessionBase::SessionBase(tcp::socket&& socket, compression::Settings compression_settings)
+        : stream_(std::move(socket))
+        , compression_settings_(compression_settings) {
+        beast::error_code ec;
+        auto endpoint = stream_.socket().remote_endpoint(ec);
+        client_ip_ = ec ? "unknown" : endpoint.address().to_string();
     }
 
     void SessionBase::Read() {
@@ -42,11 +46,20 @@ namespace http_server {
         }
         start_time_ = std::chrono::steady_clock::now();
 
-        boost::json::value data{ 
-            {"ip", GetClientIp()}, 
-            {"URI", request_.target().to_string()}, 
-            {"method", request_.method_string().to_string()}};
-        BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "request received";
+        {
+            PROFILE_ZONE("LogRequest");
+            boost::json::value data{ 
+                {"ip", GetClientIp()}, 
+                {"URI", request_.target().to_string()}, 
+                {"method", request_.method_string().to_string()}};
+            BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "request received";
+        }
+
+        response_coding_ = compression::ContentCoding::IDENTITY;
+        if (compression_settings_.enabled) {
+            auto accept_encoding = request_[http::field::accept_encoding];
+            response_coding_ = compression::ChooseContentCoding({ accept_encoding.data(), accept_encoding.size() });
+        }
 
         HandleRequest(std::move(request_));
     }
@@ -69,8 +82,8 @@ namespace http_server {
         stream_.socket().shutdown(tcp::socket::shutdown_send);
     }
 
-    std::string SessionBase::GetClientIp() const {
-        return stream_.socket().remote_endpoint().address().to_string();
+    const std::string& SessionBase::GetClientIp() const {
+        return client_ip_;
     }
 
 
@@ -7,8 +7,11 @@
 #include <chrono>
 
 #include "logger.h"
+#include "profiler.h"
+#include "compression.h"
 
 #include <iostream>
+#include <type_traits>
 
 namespace http_server {
     namespace net = boost::asio;
@@ -32,29 +35,45 @@ namespace http_server {
 
         void Run();
 
+        // Ответ может прийти из чужого потока (api strand): запись, сжатие и логирование
+        // выполняются на исполнителе соединения, то есть на ядре, которое его приняло
+        template <typename Response>
+        void PostWrite(Response&& response) {
+            net::dispatch(stream_.get_executor(), [self = GetSharedThis(), response = std::move(response)]() mutable {
+                self->Write(std::move(response));
+            });
+        }
+
         template <typename Body, typename Fields>
         void Write(http::response<Body, Fields>&& response) {
             // Запись выполняется асинхронно, поэтому response перемещаем в область кучи
             auto safe_response = std::make_shared<http::response<Body, Fields>>(std::move(response));
 
+            if constexpr (std::is_same_v<Body, http::string_body>) {
+                MaybeCompress(*safe_response);
+            }
+
             auto end_time = std::chrono::steady_clock::now();
 
             auto response_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time_).count();
 
-            std::string content_type;
-            if (safe_response->base().find(boost::beast::http::field::content_type) != safe_response->base().end()) {
-                content_type = safe_response->base().at(boost::beast::http::field::content_type).to_string();
-            }
-            else {
-                content_type = "null";
+            {
+                PROFILE_ZONE("LogResponse");
+                std::string content_type;
+                if (safe_response->base().find(boost::beast::http::field::content_type) != safe_response->base().end()) {
+                    content_type = safe_response->base().at(boost::beast::http::field::content_type).to_string();
+                }
+                else {
+                    content_type = "null";
+                }
+
+                boost::json::value data{ 
+                    {"response_time", response_time}, 
+                    {"code", safe_response->result_int()}, 
+                    {"content_type", content_type} };
+                BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "response sent";
             }
 
-            boost::json::value data{ 
-                {"response_time", response_time}, 
-                {"code", safe_response->result_int()}, 
-                {"content_type", content_type} };
-            BOOST_LOG_TRIVIAL(info) << boost::log::add_value(additional_data, data) << "response sent";
-
             auto self = GetSharedThis();
             http::async_write(stream_, *safe_response,
                 [safe_response, self](beast::error_code ec, std::size_t bytes_written) {
@@ -62,8 +81,39 @@ namespace http_server {
                 });
         }
     protected:
-        explicit SessionBase(tcp::socket&& socket);
+        SessionBase(tcp::socket&& socket, compression::Settings compression_settings);
+
+        // Адрес клиента определяется один раз при подключении
+        const std::string& GetClientIp() const;
     private:
+        // Тело, уже закодированное обработчиком (Content-Encoding задан), не трогаем
+        template <typename Fields>
+        void MaybeCompress(http::response<http::string_body, Fields>& response) const {
+            auto content_type = response[http::field::content_type];
+            if (response_coding_ == compression::ContentCoding::IDENTITY
+                || response.find(http::field::content_encoding) != response.end()
+                || !compression::IsCompressibleContentType({ content_type.data(), content_type.size() })) {
+                return;
+            }
+
+            response.set(http::field::vary, "Accept-Encoding");
+            if (response.body().size() < compression_settings_.min_size) {
+                return;
+            }
+
+            PROFILE_ZONE("CompressResponse");
+            std::string compressed;
+            compression::Compress(response_coding_, response.body(), compressed);
+            if (compressed.size() >= response.body().size()) {
+                return;
+            }
+
+            auto coding = compression::ToHeaderValue(response_coding_);
+            response.body() = std::move(compressed);
+            response.set(http::field::content_encoding, beast::string_view(coding.data(), coding.size()));
+            response.prepare_payload();
+        }
+
         void Read();
 
         void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
@@ -74,22 +124,25 @@ namespace http_server {
 
         virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
 
-        std::string GetClientIp() const;
-
         beast::tcp_stream stream_;
+        std::string client_ip_;
         beast::flat_buffer buffer_;
         HttpRequest request_;
         virtual void HandleRequest(HttpRequest&& request) = 0;
 
         std::chrono::steady_clock::time_point start_time_;
+
+        compression::Settings compression_settings_;
+        // Выбирается по Accept-Encoding текущего запроса до того, как запрос уйдёт обработчику
+        compression::ContentCoding response_coding_ = compression::ContentCoding::IDENTITY;
     };
 
     template <typename RequestHandler>
     class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler>> {
     public:
         template <typename Handler>
-        Session(tcp::socket&& socket, Handler&& request_handler)
-            : SessionBase(std::move(socket))
+        Session(tcp::socket&& socket, Handler&& request_handler, compression::Settings compression_settings)
+            : SessionBase(std::move(socket), compression_settings)
             , request_handler_(std::forward<Handler>(request_handler)) {
         }
 
@@ -103,8 +156,8 @@ namespace http_server {
             // чтобы продлить время жизни сессии до вызова лямбды.
             // Используется generic-лямбда функция, способная принять response произвольного типа
             request_handler_(std::move(request), [self = this->shared_from_this()](auto&& response) {
-                self->Write(std::move(response));
-                });
+                self->PostWrite(std::move(response));
+                }, GetClientIp());
         }
 
         RequestHandler request_handler_;
@@ -114,11 +167,12 @@ namespace http_server {
     class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
     public:
         template <typename Handler>
-        Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+        Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler, compression::Settings compression_settings, bool reuse_port)
             : ioc_(ioc)
             // Обработчики асинхронных операций acceptor_ будут вызываться в своём strand
             , acceptor_(net::make_strand(ioc))
-            , request_handler_(std::forward<Handler>(request_handler)) {
+            , request_handler_(std::forward<Handler>(request_handler))
+            , compression_settings_(compression_settings) {
             // Открываем acceptor, используя протокол (IPv4 или IPv6), указанный в endpoint
             acceptor_.open(endpoint.protocol());
 
@@ -127,6 +181,11 @@ namespace http_server {
             // Однако это может помешать повторно открыть сокет в полузакрытом состоянии.
             // Флаг reuse_address разрешает открыть сокет, когда он "наполовину закрыт"
             acceptor_.set_option(net::socket_base::reuse_address(true));
+            // Несколько acceptor-ов (по одному на io_context) слушают один порт,
+            // и ядро ОС само распределяет между ними входящие соединения
+            if (reuse_port) {
+                acceptor_.set_option(net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+            }
             // Привязываем acceptor к адресу и порту endpoint
             acceptor_.bind(endpoint);
             // Переводим acceptor в состояние, в котором он способен принимать новые соединения
@@ -170,19 +229,21 @@ namespace http_server {
         }
 
         void AsyncRunSession(tcp::socket&& socket) {
-            std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_)->Run();
+            std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_, compression_settings_)->Run();
         }
 
         net::io_context& ioc_;
         tcp::acceptor acceptor_;
         RequestHandler request_handler_;
+        compression::Settings compression_settings_;
     };
 
     template <typename RequestHandler>
-    void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler) {
+    void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler, compression::Settings compression_settings = {},
+        bool reuse_port = false) {
         using MyListener = Listener<std::decay_t<RequestHandler>>;
 
-        std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
+        std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler), compression_settings, reuse_port)->Run();
     }
 
 }  // namespace http_server
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "connection_pool.h"
+
+namespace postgres {
+    ConnectionPool::ConnectionPool(size_t capacity, ConnectionFactory connection_factory)
+        : connection_factory_(std::move(connection_factory)) {
+        pool_.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            pool_.emplace_back(connection_factory_());
+        }
+    }
+
+    ConnectionPool::ConnectionWrapper ConnectionPool::GetConnection() {
+        std::unique_lock lock{ mutex_ };
+        cond_var_.wait(lock, [this] {
+            return used_connections_ < pool_.size();
+        });
+        auto connection = std::move(pool_[used_connections_++]);
+        lock.unlock();
+
+        if (!connection->is_open()) {
+            try {
+                connection = connection_factory_();
+            }
+            catch (...) {
+                // Слот не должен пропасть: закрытое соединение вернётся в пул и пересоздастся в следующий раз
+                ReturnConnection(std::move(connection));
+                throw;
+            }
+        }
+
+        return { std::move(connection), *this };
+    }
+
+    void ConnectionPool::ReturnConnection(ConnectionPtr&& connection) {
+        {
+            std::lock_guard lock{ mutex_ };
+            assert(used_connections_ != 0);
+            pool_[--used_connections_] = std::move(connection);
+        }
+        cond_var_.notify_one();
+    }
+} // namespace postgres
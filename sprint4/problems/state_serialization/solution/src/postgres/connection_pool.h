@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pqxx/connection>
+
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace postgres {
+    /*
+     * Пул соединений: GetConnection ждёт свободное соединение, обёртка возвращает его в пул в деструкторе.
+     * Соединение, закрытое после сбоя БД, пересоздаётся при следующей выдаче.
+     */
+    class ConnectionPool {
+        using ConnectionPtr = std::shared_ptr<pqxx::connection>;
+    public:
+        using ConnectionFactory = std::function<ConnectionPtr()>;
+
+        class ConnectionWrapper {
+        public:
+            ConnectionWrapper(ConnectionPtr&& connection, ConnectionPool& pool) noexcept
+                : connection_{ std::move(connection) }
+                , pool_{ &pool } {
+            }
+
+            ConnectionWrapper(const ConnectionWrapper&) = delete;
+            ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
+
+            ConnectionWrapper(ConnectionWrapper&&) = default;
+            ConnectionWrapper& operator=(ConnectionWrapper&&) = default;
+
+            pqxx::connection& operator*() const& noexcept {
+                return *connection_;
+            }
+            pqxx::connection& operator*() const&& = delete;
+
+            pqxx::connection* operator->() const& noexcept {
+                return connection_.get();
+            }
+
+            ~ConnectionWrapper() {
+                if (connection_) {
+                    pool_->ReturnConnection(std::move(connection_));
+                }
+            }
+        private:
+            ConnectionPtr connection_;
+            ConnectionPool* pool_;
+        };
+
+        // Все соединения открываются сразу: недоступная при старте БД - ошибка конфигурации
+        ConnectionPool(size_t capacity, ConnectionFactory connection_factory);
+
+        ConnectionWrapper GetConnection();
+    private:
+        void ReturnConnection(ConnectionPtr&& connection);
+
+        ConnectionFactory connection_factory_;
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        std::vector<ConnectionPtr> pool_;
+        size_t used_connections_ = 0;
+    };
+} // namespace postgres
@@ -0,0 +1,95 @@
+#include "records_repository.h"
+
+#include <boost/uuid/uuid_io.hpp>
+
+#include <pqxx/params>
+#include <pqxx/transaction>
+#include <pqxx/zview.hxx>
+
+namespace postgres {
+    using namespace std::literals;
+    using pqxx::operator"" _zv;
+
+    namespace {
+        constexpr size_t COLUMN_COUNT = 4;
+    }
+
+    RecordRepositoryImpl::RecordRepositoryImpl(const std::string& db_url, size_t pool_size)
+        : pool_(pool_size, [db_url] {
+            return std::make_shared<pqxx::connection>(db_url);
+        }) {
+        auto connection = pool_.GetConnection();
+        pqxx::work work{ *connection };
+        work.exec(R"(
+CREATE TABLE IF NOT EXISTS retired_players (
+    id UUID PRIMARY KEY,
+    name VARCHAR(100) NOT NULL,
+    score BIGINT NOT NULL,
+    play_time_ms BIGINT NOT NULL
+);
+)"_zv);
+        // Таблицы, созданные прежней версией, хранили очки и время в INTEGER: время в мс переполняет его за 25 дней игры
+        work.exec(R"(
+ALTER TABLE retired_players ALTER COLUMN score TYPE BIGINT, ALTER COLUMN play_time_ms TYPE BIGINT;
+)"_zv);
+        // Порядок таблицы рекордов: по очкам, при равенстве - кто быстрее, затем по имени
+        work.exec(R"(
+CREATE INDEX IF NOT EXISTS retired_players_rating_idx ON retired_players (score DESC, play_time_ms, name);
+)"_zv);
+        work.commit();
+    }
+
+    void RecordRepositoryImpl::Save(const std::vector<records::StoredRecord>& records) {
+        if (records.empty()) {
+            return;
+        }
+
+        std::string query = "INSERT INTO retired_players (id, name, score, play_time_ms) VALUES "s;
+        query.reserve(query.size() + records.size() * 32);
+
+        pqxx::params params;
+        params.reserve(records.size() * COLUMN_COUNT);
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            const size_t first = i * COLUMN_COUNT;
+            if (i != 0) {
+                query += ", "sv;
+            }
+            query += "($"s + std::to_string(first + 1) + ", $"s + std::to_string(first + 2)
+                + ", $"s + std::to_string(first + 3) + ", $"s + std::to_string(first + 4) + ")"s;
+
+            const auto& [id, record] = records[i];
+            params.append(boost::uuids::to_string(id));
+            params.append(record.name);
+            params.append(static_cast<int64_t>(record.score));
+            params.append(static_cast<int64_t>(record.play_time.count()));
+        }
+        query += " ON CONFLICT (id) DO NOTHING;"sv;
+
+        auto connection = pool_.GetConnection();
+        pqxx::work work{ *connection };
+        work.exec_params(pqxx::zview{ query }, params);
+        work.commit();
+    }
+
+    std::vector<records::PlayerRecord> RecordRepositoryImpl::LoadBest(size_t limit) {
+        auto connection = pool_.GetConnection();
+        pqxx::read_transaction read{ *connection };
+        const auto rows = read.exec_params(R"(
+SELECT name, score, play_time_ms FROM retired_players
+ORDER BY score DESC, play_time_ms, name
+LIMIT $1;
+)"_zv, static_cast<int64_t>(limit));
+
+        std::vector<records::PlayerRecord> result;
+        result.reserve(rows.size());
+        for (const auto& row : rows) {
+            result.push_back(records::PlayerRecord{
+                .name = row[0].as<std::string>(),
+                .score = static_cast<size_t>(row[1].as<int64_t>()),
+                .play_time = std::chrono::milliseconds{ row[2].as<int64_t>() }
+            });
+        }
+        return result;
+    }
+} // namespace postgres
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "connection_pool.h"
+#include "records.h"
+
+#include <string>
+
+namespace postgres {
+    // Итоги игроков в таблице retired_players. Таблица и индекс создаются при подключении
+    class RecordRepositoryImpl : public records::RecordRepository {
+    public:
+        RecordRepositoryImpl(const std::string& db_url, size_t pool_size);
+
+        // Одна вставка на пачку; конфликт по id при повторе пачки пропускается
+        void Save(const std::vector<records::StoredRecord>& records) override;
+        // Читается по индексу retired_players_rating_idx
+        std::vector<records::PlayerRecord> LoadBest(size_t limit) override;
+    private:
+        ConnectionPool pool_;
+    };
+} // namespace postgres
@@ -0,0 +1,186 @@
+#include "input_log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace recording {
+    namespace {
+        enum RecordType : uint8_t {
+            JOIN = 1, ACTION = 2, TICK = 3
+        };
+
+        constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr uint64_t FNV_PRIME = 1099511628211ull;
+    }
+
+    InputLogWriter::InputLogWriter(std::ostream& output, const InputLogHeader& header)
+        : output_(output) {
+        output_.write(InputLogHeader::MAGIC, sizeof(InputLogHeader::MAGIC));
+        output_.put(static_cast<char>(InputLogHeader::VERSION));
+        WriteVarint(header.random_seed);
+        output_.put(header.randomize_spawn_points ? 1 : 0);
+        WriteFixed(header.config_hash);
+        WriteVarint(header.max_players_per_session);
+        output_.put(static_cast<char>(header.session_placement));
+    }
+
+    void InputLogWriter::Write(const InputRecord& record) {
+        auto timestamp_delta = std::max(record.timestamp - last_timestamp_, std::chrono::milliseconds::zero());
+        last_timestamp_ = std::max(record.timestamp, last_timestamp_);
+
+        if (const auto* join = std::get_if<JoinRecord>(&record.data)) {
+            output_.put(RecordType::JOIN);
+            WriteVarint(timestamp_delta.count());
+            WriteString(join->map_id);
+            WriteString(join->user_name);
+        }
+        else if (const auto* action = std::get_if<ActionRecord>(&record.data)) {
+            output_.put(RecordType::ACTION);
+            WriteVarint(timestamp_delta.count());
+            WriteVarint(action->player_index);
+            output_.put(action->move);
+        }
+        else if (const auto* tick = std::get_if<TickRecord>(&record.data)) {
+            output_.put(RecordType::TICK);
+            WriteVarint(timestamp_delta.count());
+            WriteVarint(static_cast<uint64_t>(tick->time_delta));
+            WriteFixed(tick->state_hash);
+        }
+    }
+
+    void InputLogWriter::Flush() {
+        output_.flush();
+    }
+
+    void InputLogWriter::WriteVarint(uint64_t value) {
+        while (value >= 0x80) {
+            output_.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        output_.put(static_cast<char>(value));
+    }
+
+    void InputLogWriter::WriteFixed(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            output_.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void InputLogWriter::WriteString(const std::string& str) {
+        WriteVarint(str.size());
+        output_.write(str.data(), str.size());
+    }
+
+    InputLogReader::InputLogReader(std::istream& input)
+        : input_(input) {
+        char magic[sizeof(InputLogHeader::MAGIC)];
+        if (!input_.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), InputLogHeader::MAGIC)) {
+            throw std::runtime_error("Not an input log");
+        }
+
+        if (ReadByte() != InputLogHeader::VERSION) {
+            throw std::runtime_error("Unsupported input log version");
+        }
+
+        header_.random_seed = ReadVarint();
+        header_.randomize_spawn_points = ReadByte() != 0;
+        header_.config_hash = ReadFixed();
+        header_.max_players_per_session = ReadVarint();
+        header_.session_placement = ReadByte();
+    }
+
+    const InputLogHeader& InputLogReader::GetHeader() const {
+        return header_;
+    }
+
+    std::optional<InputRecord> InputLogReader::Next() {
+        int type = input_.get();
+        if (type == std::istream::traits_type::eof()) {
+            return std::nullopt;
+        }
+
+        last_timestamp_ += std::chrono::milliseconds(ReadVarint());
+
+        InputRecord record{ .timestamp = last_timestamp_, .data = JoinRecord{} };
+
+        switch (type) {
+        case RecordType::JOIN: {
+            JoinRecord join;
+            join.map_id = ReadString();
+            join.user_name = ReadString();
+            record.data = std::move(join);
+            break;
+        }
+        case RecordType::ACTION: {
+            ActionRecord action;
+            action.player_index = ReadVarint();
+            action.move = static_cast<char>(ReadByte());
+            record.data = action;
+            break;
+        }
+        case RecordType::TICK: {
+            TickRecord tick;
+            tick.time_delta = static_cast<int64_t>(ReadVarint());
+            tick.state_hash = ReadFixed();
+            record.data = tick;
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown input log record type");
+        }
+
+        return record;
+    }
+
+    uint64_t InputLogReader::ReadVarint() {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = ReadByte();
+            result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return result;
+            }
+        }
+        throw std::runtime_error("Malformed varint in input log");
+    }
+
+    uint64_t InputLogReader::ReadFixed() {
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            result |= static_cast<uint64_t>(ReadByte()) << (i * 8);
+        }
+        return result;
+    }
+
+    std::string InputLogReader::ReadString() {
+        std::string result(ReadVarint(), '\0');
+        if (!input_.read(result.data(), result.size())) {
+            throw std::runtime_error("Truncated input log");
+        }
+        return result;
+    }
+
+    uint8_t InputLogReader::ReadByte() {
+        int byte = input_.get();
+        if (byte == std::istream::traits_type::eof()) {
+            throw std::runtime_error("Truncated input log");
+        }
+        return static_cast<uint8_t>(byte);
+    }
+
+    uint64_t HashFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Could not open file: " + path);
+        }
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        for (std::istreambuf_iterator<char> it(file), end; it != end; ++it) {
+            hash ^= static_cast<uint8_t>(*it);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+} // namespace recording
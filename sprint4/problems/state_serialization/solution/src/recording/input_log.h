@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <variant>
+
+namespace recording {
+    /*
+     * Формат журнала входных воздействий (все целые - LEB128 varint, кроме хэшей):
+     *   заголовок: "GREC", версия, seed генератора, флаг случайного спавна, хэш файла конфигурации (8 байт),
+     *              лимит игроков в сессии, способ выбора сессии (1 байт)
+     *   запись:    тип (1 байт), время от предыдущей записи в мс, данные записи
+     */
+    struct InputLogHeader {
+        static constexpr char MAGIC[4] = { 'G', 'R', 'E', 'C' };
+        static constexpr uint8_t VERSION = 2;
+
+        uint64_t random_seed = 0;
+        bool randomize_spawn_points = false;
+        uint64_t config_hash = 0;
+        // Распределение игроков по сессиям влияет на состояние, поэтому реплей берёт его из журнала
+        uint64_t max_players_per_session = 0;
+        uint8_t session_placement = 0;
+    };
+
+    struct JoinRecord {
+        std::string map_id;
+        std::string user_name;
+    };
+
+    struct ActionRecord {
+        // Порядковый номер входа игрока в журнале
+        uint64_t player_index;
+        char move;
+    };
+
+    struct TickRecord {
+        int64_t time_delta;
+        // Хэш состояния игры после обработки тика
+        uint64_t state_hash;
+    };
+
+    struct InputRecord {
+        std::chrono::milliseconds timestamp;
+        std::variant<JoinRecord, ActionRecord, TickRecord> data;
+    };
+
+    class InputLogWriter {
+    public:
+        InputLogWriter(std::ostream& output, const InputLogHeader& header);
+
+        void Write(const InputRecord& record);
+
+        void Flush();
+    private:
+        void WriteVarint(uint64_t value);
+
+        void WriteFixed(uint64_t value);
+
+        void WriteString(const std::string& str);
+
+        std::ostream& output_;
+        std::chrono::milliseconds last_timestamp_{};
+    };
+
+    class InputLogReader {
+    public:
+        // Бросает std::runtime_error, если поток не является журналом поддерживаемой версии
+        explicit InputLogReader(std::istream& input);
+
+        const InputLogHeader& GetHeader() const;
+
+        // Возвращает std::nullopt в конце журнала, бросает std::runtime_error на обрезанной записи
+        std::optional<InputRecord> Next();
+    private:
+        uint64_t ReadVarint();
+
+        uint64_t ReadFixed();
+
+        std::string ReadString();
+
+        uint8_t ReadByte();
+
+        std::istream& input_;
+        InputLogHeader header_;
+        std::chrono::milliseconds last_timestamp_{};
+    };
+
+    // FNV-1a по содержимому файла: реплей сверяет, что используется та же конфигурация карт
+    uint64_t HashFile(const std::string& path);
+} // namespace recording
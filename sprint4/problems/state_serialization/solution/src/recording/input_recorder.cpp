@@ -0,0 +1,42 @@
+#include "input_recorder.h"
+#include "state_hash.h"
+
+#include <stdexcept>
+
+namespace recording {
+    InputRecorder::InputRecorder(const std::string& file, const InputLogHeader& header)
+        : file_(file, std::ios::binary | std::ios::trunc)
+        , writer_(file_, header)
+        , start_time_(std::chrono::steady_clock::now()) {
+        if (!file_) {
+            throw std::runtime_error("Could not open record file: " + file);
+        }
+    }
+
+    InputRecorder::~InputRecorder() {
+        writer_.Flush();
+    }
+
+    void InputRecorder::RecordJoin(const std::string& map_id, const std::string& user_name, const application::game::PlayerToken& token) {
+        token_to_index_.emplace(token, token_to_index_.size());
+        writer_.Write({ .timestamp = Now(), .data = JoinRecord{ .map_id = map_id, .user_name = user_name } });
+    }
+
+    void InputRecorder::RecordAction(const application::game::PlayerToken& token, char move) {
+        auto it = token_to_index_.find(token);
+        if (it == token_to_index_.end()) {
+            // Игрок вошёл до начала записи - в реплее его нет
+            return;
+        }
+
+        writer_.Write({ .timestamp = Now(), .data = ActionRecord{ .player_index = it->second, .move = move } });
+    }
+
+    void InputRecorder::RecordTick(int64_t time_delta, const application::game::Game& game) {
+        writer_.Write({ .timestamp = Now(), .data = TickRecord{ .time_delta = time_delta, .state_hash = ComputeStateHash(game) } });
+    }
+
+    std::chrono::milliseconds InputRecorder::Now() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time_);
+    }
+} // namespace recording
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include "game.h"
+#include "input_log.h"
+
+namespace recording {
+    /*
+     * Пишет в журнал входы игроков, их действия и тики вместе с хэшем состояния после тика.
+     * Все методы вызываются из api strand, поэтому синхронизации нет.
+     * Журнал пригоден для реплея, только если запись начата с пустой игры (без --state-file).
+     */
+    class InputRecorder {
+    public:
+        InputRecorder(const std::string& file, const InputLogHeader& header);
+
+        ~InputRecorder();
+
+        void RecordJoin(const std::string& map_id, const std::string& user_name, const application::game::PlayerToken& token);
+
+        void RecordAction(const application::game::PlayerToken& token, char move);
+
+        void RecordTick(int64_t time_delta, const application::game::Game& game);
+    private:
+        std::chrono::milliseconds Now() const;
+
+        std::ofstream file_;
+        InputLogWriter writer_;
+        std::chrono::steady_clock::time_point start_time_;
+        std::unordered_map<application::game::PlayerToken, uint64_t, application::game::PlayerTokenHash> token_to_index_;
+    };
+} // namespace recording
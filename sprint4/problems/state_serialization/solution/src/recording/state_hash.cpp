@@ -0,0 +1,99 @@
+#include "state_hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace recording {
+    namespace {
+        using namespace application::game;
+
+        class Fnv1a {
+        public:
+            void Add(uint64_t value) {
+                for (int i = 0; i < 8; ++i) {
+                    hash_ ^= (value >> (i * 8)) & 0xFF;
+                    hash_ *= PRIME;
+                }
+            }
+
+            void Add(double value) {
+                Add(std::bit_cast<uint64_t>(value));
+            }
+
+            void Add(const std::string& str) {
+                Add(static_cast<uint64_t>(str.size()));
+                for (char c : str) {
+                    hash_ ^= static_cast<uint8_t>(c);
+                    hash_ *= PRIME;
+                }
+            }
+
+            uint64_t Get() const {
+                return hash_;
+            }
+        private:
+            static constexpr uint64_t PRIME = 1099511628211ull;
+            uint64_t hash_ = 14695981039346656037ull;
+        };
+
+        void HashSession(Fnv1a& hash, const GameSession& session) {
+            hash.Add(session.GetMap()->GetId());
+
+            std::vector<const Player*> players;
+            players.reserve(session.GetPlayers().size());
+            for (const auto& [token, player] : session.GetPlayers()) {
+                players.push_back(&player);
+            }
+            std::sort(players.begin(), players.end(), [](const Player* lhs, const Player* rhs) {
+                return lhs->GetId() < rhs->GetId();
+                });
+
+            hash.Add(static_cast<uint64_t>(players.size()));
+            for (const auto* player : players) {
+                hash.Add(static_cast<uint64_t>(player->GetId()));
+                hash.Add(player->GetPosition().x);
+                hash.Add(player->GetPosition().y);
+                hash.Add(player->GetSpeed().x);
+                hash.Add(player->GetSpeed().y);
+                hash.Add(static_cast<uint64_t>(player->GetDirection()));
+                hash.Add(static_cast<uint64_t>(player->GetScore()));
+
+                hash.Add(static_cast<uint64_t>(player->GetLoots().size()));
+                for (const auto& loot : player->GetLoots()) {
+                    hash.Add(static_cast<uint64_t>(loot.id));
+                    hash.Add(static_cast<uint64_t>(loot.type_index));
+                }
+            }
+
+            std::vector<const Loot*> loots;
+            loots.reserve(session.GetLoots().size());
+            for (const auto& [id, loot] : session.GetLoots()) {
+                loots.push_back(&loot);
+            }
+            std::sort(loots.begin(), loots.end(), [](const Loot* lhs, const Loot* rhs) {
+                return lhs->id < rhs->id;
+                });
+
+            hash.Add(static_cast<uint64_t>(loots.size()));
+            for (const auto* loot : loots) {
+                hash.Add(static_cast<uint64_t>(loot->id));
+                hash.Add(static_cast<uint64_t>(loot->type_index));
+                hash.Add(loot->coordinates.x);
+                hash.Add(loot->coordinates.y);
+            }
+        }
+    }
+
+    uint64_t ComputeStateHash(const Game& game) {
+        Fnv1a hash;
+
+        for (const auto& [map_id, map_sessions] : game.GetSessions()) {
+            for (const auto& session : map_sessions) {
+                HashSession(hash, session);
+            }
+        }
+
+        return hash.Get();
+    }
+} // namespace recording
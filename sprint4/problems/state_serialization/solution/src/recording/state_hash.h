@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+#include "game.h"
+
+namespace recording {
+    /*
+     * Хэш наблюдаемого состояния игры: позиции, скорости, направления, рюкзаки и очки собак,
+     * трофеи на картах. Токены не участвуют - они случайны и при реплее другие,
+     * поэтому игроки и трофеи хэшируются в порядке своих id.
+     */
+    uint64_t ComputeStateHash(const application::game::Game& game);
+} // namespace recording
@@ -0,0 +1,150 @@
+#include "async_record_writer.h"
+#include "logger.h"
+
+#include <algorithm>
+
+namespace records {
+    AsyncRecordWriter::AsyncRecordWriter(RecordRepository& repository, WriterSettings settings)
+        : repository_(repository)
+        , settings_(settings)
+        , queue_(settings.capacity)
+        , thread_([this] { Run(); }) {
+    }
+
+    AsyncRecordWriter::~AsyncRecordWriter() {
+        Stop();
+    }
+
+    void AsyncRecordWriter::Publish(std::vector<PlayerRecord> records) {
+        if (stopping_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(records.size(), std::memory_order_relaxed);
+            return;
+        }
+
+        for (auto& record : records) {
+            if (!queue_.TryPush(record)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_one();
+    }
+
+    void AsyncRecordWriter::Stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+
+        stopping_.store(true, std::memory_order_release);
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_one();
+        thread_.join();
+    }
+
+    AsyncRecordWriter::Stats AsyncRecordWriter::GetStats() const {
+        return Stats{
+            .written = written_.load(std::memory_order_relaxed),
+            .dropped = dropped_.load(std::memory_order_relaxed),
+            .failed = failed_.load(std::memory_order_relaxed) };
+    }
+
+    void AsyncRecordWriter::Run() {
+        while (true) {
+            const auto seen = signal_.load(std::memory_order_acquire);
+            const bool stopping = stopping_.load(std::memory_order_acquire);
+
+            Drain();
+
+            if (stopping) {
+                return;
+            }
+
+            // Публикация между Drain и ожиданием изменит signal_, и wait сразу вернётся
+            signal_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    void AsyncRecordWriter::Drain() {
+        std::vector<StoredRecord> batch;
+        batch.reserve(std::min(settings_.max_batch, queue_.Capacity()));
+
+        while (true) {
+            batch.clear();
+            while (batch.size() < settings_.max_batch) {
+                auto record = queue_.TryPop();
+                if (!record) {
+                    break;
+                }
+                batch.push_back(StoredRecord{ .id = id_generator_(), .record = std::move(*record) });
+            }
+
+            if (batch.empty()) {
+                return;
+            }
+
+            WriteBatch(batch);
+        }
+    }
+
+    void AsyncRecordWriter::WriteBatch(const std::vector<StoredRecord>& batch) {
+        auto backoff = settings_.initial_backoff;
+
+        for (int attempt = 1;; ++attempt) {
+            try {
+                repository_.Save(batch);
+                written_.fetch_add(batch.size(), std::memory_order_relaxed);
+                return;
+            }
+            catch (const std::exception& e) {
+                const int max_attempts = stopping_.load(std::memory_order_acquire)
+                    ? std::min(settings_.max_attempts, settings_.shutdown_attempts)
+                    : settings_.max_attempts;
+                const bool give_up = attempt >= max_attempts;
+
+                LogFailure(e, attempt, batch.size(), give_up && batch.size() == 1);
+
+                if (give_up) {
+                    // Пачку могла не пустить одна запись с недопустимыми данными: остальные не должны пропасть вместе с ней
+                    WriteSplit(batch);
+                    return;
+                }
+            }
+
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, settings_.max_backoff);
+        }
+    }
+
+    void AsyncRecordWriter::WriteSplit(const std::vector<StoredRecord>& batch) {
+        if (batch.size() == 1) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Половины пробуются по разу, без пауз: пачка уже исчерпала попытки, и ждать восстановления БД незачем
+        const auto middle = batch.begin() + batch.size() / 2;
+        for (auto half : { std::vector<StoredRecord>(batch.begin(), middle), std::vector<StoredRecord>(middle, batch.end()) }) {
+            try {
+                repository_.Save(half);
+                written_.fetch_add(half.size(), std::memory_order_relaxed);
+            }
+            catch (const std::exception& e) {
+                if (half.size() == 1) {
+                    LogFailure(e, 1, 1, true);
+                }
+                WriteSplit(half);
+            }
+        }
+    }
+
+    void AsyncRecordWriter::LogFailure(const std::exception& e, int attempt, size_t records, bool dropped) {
+        boost::json::value data{
+            {"text", e.what()},
+            {"where", "records"},
+            {"attempt", attempt},
+            {"records", records}
+        };
+        BOOST_LOG_TRIVIAL(error) << boost::log::add_value(additional_data, data) << (dropped ? "records dropped" : "error");
+    }
+} // namespace records
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "records.h"
+#include "spsc_queue.h"
+
+#include <boost/uuid/random_generator.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace records {
+    struct WriterSettings {
+        // Записей, ожидающих записи; не поместившиеся отбрасываются, чтобы не задерживать тик
+        size_t capacity = 4096;
+        // Записей в одном обращении к хранилищу
+        size_t max_batch = 256;
+        // Пауза перед повтором удваивается от initial_backoff до max_backoff
+        std::chrono::milliseconds initial_backoff{ 100 };
+        std::chrono::milliseconds max_backoff{ 5000 };
+        // Попыток записать пачку; после них она делится пополам, чтобы отбросить только не принятые записи
+        int max_attempts = 8;
+        // При остановке сервер не ждёт недоступную БД дольше нескольких попыток
+        int shutdown_attempts = 2;
+    };
+
+    /*
+     * Приёмник итогов игроков, пишущий их в хранилище из отдельного потока.
+     * Publish вызывается из тика (api strand) и только кладёт записи в очередь без блокировок.
+     * Поток записи собирает их в пачки, повторяет неудачные записи с нарастающей паузой
+     * и при остановке дописывает всё, что осталось в очереди.
+     */
+    class AsyncRecordWriter : public application::game::PlayerRecordSink {
+    public:
+        struct Stats {
+            uint64_t written = 0;
+            // Не поместились в очередь
+            uint64_t dropped = 0;
+            // Исчерпали попытки записи
+            uint64_t failed = 0;
+        };
+
+        explicit AsyncRecordWriter(RecordRepository& repository, WriterSettings settings = {});
+
+        AsyncRecordWriter(const AsyncRecordWriter&) = delete;
+        AsyncRecordWriter& operator=(const AsyncRecordWriter&) = delete;
+
+        ~AsyncRecordWriter() override;
+
+        // Только из одного потока за раз: очередь рассчитана на одного производителя
+        void Publish(std::vector<PlayerRecord> records) override;
+
+        // Дописывает очередь и останавливает поток записи. Записи, опубликованные после этого, отбрасываются
+        void Stop();
+
+        Stats GetStats() const;
+    private:
+        void Run();
+
+        // Пишет всё, что есть в очереди
+        void Drain();
+
+        void WriteBatch(const std::vector<StoredRecord>& batch);
+
+        // Делит пачку пополам, пока не останутся отдельные записи, которые хранилище не принимает
+        void WriteSplit(const std::vector<StoredRecord>& batch);
+
+        void LogFailure(const std::exception& e, int attempt, size_t records, bool dropped);
+
+        RecordRepository& repository_;
+        WriterSettings settings_;
+        lockfree::SpscQueue<PlayerRecord> queue_;
+
+        // Меняется при каждой публикации и остановке, поток записи ждёт его изменения
+        std::atomic<uint64_t> signal_{ 0 };
+        std::atomic<bool> stopping_{ false };
+
+        std::atomic<uint64_t> written_{ 0 };
+        std::atomic<uint64_t> dropped_{ 0 };
+        std::atomic<uint64_t> failed_{ 0 };
+
+        // Используется только потоком записи
+        boost::uuids::random_generator id_generator_;
+
+        std::thread thread_;
+    };
+} // namespace records
@@ -0,0 +1,145 @@
+#include "leaderboard.h"
+
+#include "records.h"
+
+#include <charconv>
+
+namespace records {
+    using namespace std::literals;
+
+    namespace {
+        template <typename Integer>
+        bool ParseInteger(std::string_view text, Integer& value) {
+            const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+            return error == std::errc{} && end == text.data() + text.size() && !text.empty();
+        }
+
+        // Имя в курсоре - в hex, чтобы курсор можно было подставить в URL как есть
+        std::string EncodeHex(std::string_view text) {
+            constexpr std::string_view DIGITS = "0123456789abcdef"sv;
+            std::string result;
+            result.reserve(text.size() * 2);
+            for (unsigned char c : text) {
+                result += DIGITS[c >> 4];
+                result += DIGITS[c & 0xF];
+            }
+            return result;
+        }
+
+        std::optional<std::string> DecodeHex(std::string_view text) {
+            if (text.size() % 2 != 0) {
+                return std::nullopt;
+            }
+            std::string result;
+            result.reserve(text.size() / 2);
+            for (size_t i = 0; i < text.size(); i += 2) {
+                unsigned char c = 0;
+                const auto [end, error] = std::from_chars(text.data() + i, text.data() + i + 2, c, 16);
+                if (error != std::errc{} || end != text.data() + i + 2) {
+                    return std::nullopt;
+                }
+                result += static_cast<char>(c);
+            }
+            return result;
+        }
+    }
+
+    bool Leaderboard::EntryOrder::operator()(const Entry& lhs, const Entry& rhs) const {
+        if (IsBetterRecord(lhs.record, rhs.record)) {
+            return true;
+        }
+        if (IsBetterRecord(rhs.record, lhs.record)) {
+            return false;
+        }
+        return lhs.seq < rhs.seq;
+    }
+
+    Leaderboard::Leaderboard(size_t capacity, PlayerRecordSink* downstream)
+        : capacity_(capacity)
+        , downstream_(downstream) {
+    }
+
+    void Leaderboard::Load(const std::vector<PlayerRecord>& records) {
+        for (const auto& record : records) {
+            Add(record);
+        }
+    }
+
+    void Leaderboard::Publish(std::vector<PlayerRecord> records) {
+        for (const auto& record : records) {
+            Add(record);
+        }
+        if (downstream_) {
+            downstream_->Publish(std::move(records));
+        }
+    }
+
+    void Leaderboard::Add(PlayerRecord record) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        Entry entry{ .record = std::move(record), .seq = next_seq_++ };
+        if (index_.Size() == capacity_) {
+            // Хуже последней в полной таблице - не попадает
+            if (!EntryOrder{}(entry, index_.Back())) {
+                return;
+            }
+            index_.Erase(index_.Back());
+        }
+        index_.Insert(std::move(entry));
+    }
+
+    std::vector<const Leaderboard::Entry*> Leaderboard::GetPage(size_t start, size_t max_items) const {
+        std::vector<const Entry*> result;
+        for (auto it = index_.At(start); it != index_.end() && result.size() < max_items; ++it) {
+            result.push_back(&*it);
+        }
+        return result;
+    }
+
+    std::vector<const Leaderboard::Entry*> Leaderboard::GetPageAfter(const Entry& cursor, size_t max_items) const {
+        std::vector<const Entry*> result;
+        for (auto it = index_.UpperBound(cursor); it != index_.end() && result.size() < max_items; ++it) {
+            result.push_back(&*it);
+        }
+        return result;
+    }
+
+    size_t Leaderboard::Size() const {
+        return index_.Size();
+    }
+
+    size_t Leaderboard::GetCapacity() const {
+        return capacity_;
+    }
+
+    std::string Leaderboard::MakeCursor(const Entry& entry) {
+        return std::to_string(entry.record.score) + "."s + std::to_string(entry.record.play_time.count())
+            + "."s + std::to_string(entry.seq) + "."s + EncodeHex(entry.record.name);
+    }
+
+    std::optional<Leaderboard::Entry> Leaderboard::ParseCursor(std::string_view cursor) {
+        std::string_view parts[4];
+        for (size_t i = 0; i < 3; ++i) {
+            const auto dot = cursor.find('.');
+            if (dot == std::string_view::npos) {
+                return std::nullopt;
+            }
+            parts[i] = cursor.substr(0, dot);
+            cursor.remove_prefix(dot + 1);
+        }
+        parts[3] = cursor;
+
+        Entry entry;
+        int64_t play_time_ms = 0;
+        auto name = DecodeHex(parts[3]);
+        if (!ParseInteger(parts[0], entry.record.score) || !ParseInteger(parts[1], play_time_ms)
+            || !ParseInteger(parts[2], entry.seq) || !name) {
+            return std::nullopt;
+        }
+        entry.record.play_time = std::chrono::milliseconds{ play_time_ms };
+        entry.record.name = std::move(*name);
+        return entry;
+    }
+} // namespace records
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "game.h"
+#include "skip_list.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace records {
+    using application::game::PlayerRecord;
+    using application::game::PlayerRecordSink;
+
+    /*
+     * Таблица рекордов в памяти: лучшие capacity записей, упорядоченные как в retired_players.
+     * Загружается из хранилища при старте и пополняется ушедшими игроками, после чего они передаются дальше (в запись БД).
+     * Обращения только из api strand - как и к остальной модели игры.
+     */
+    class Leaderboard : public PlayerRecordSink {
+    public:
+        struct Entry {
+            PlayerRecord record;
+            // Порядок поступления - различает одинаковые записи
+            uint64_t seq = 0;
+        };
+
+        struct EntryOrder {
+            bool operator()(const Entry& lhs, const Entry& rhs) const;
+        };
+
+        static constexpr size_t DEFAULT_CAPACITY = 100'000;
+
+        explicit Leaderboard(size_t capacity = DEFAULT_CAPACITY, PlayerRecordSink* downstream = nullptr);
+
+        void Load(const std::vector<PlayerRecord>& records);
+        void Publish(std::vector<PlayerRecord> records) override;
+
+        // Не больше max_items записей, начиная с места start (с нуля)
+        std::vector<const Entry*> GetPage(size_t start, size_t max_items) const;
+        // Не больше max_items записей, следующих за cursor
+        std::vector<const Entry*> GetPageAfter(const Entry& cursor, size_t max_items) const;
+
+        size_t Size() const;
+        size_t GetCapacity() const;
+
+        // Курсор - позиция записи в таблице, не зависящая от вставок перед ней
+        static std::string MakeCursor(const Entry& entry);
+        static std::optional<Entry> ParseCursor(std::string_view cursor);
+    private:
+        void Add(PlayerRecord record);
+
+        using Index = skip_list::IndexableSkipList<Entry, EntryOrder>;
+
+        size_t capacity_;
+        PlayerRecordSink* downstream_;
+        uint64_t next_seq_ = 0;
+        Index index_;
+    };
+} // namespace records
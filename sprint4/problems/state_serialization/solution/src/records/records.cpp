@@ -0,0 +1,66 @@
+#include "records.h"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace records {
+    bool IsBetterRecord(const PlayerRecord& lhs, const PlayerRecord& rhs) {
+        return std::tie(rhs.score, lhs.play_time, lhs.name) < std::tie(lhs.score, rhs.play_time, rhs.name);
+    }
+
+    InMemoryRecordRepository::InMemoryRecordRepository(size_t capacity)
+        : capacity_(capacity) {
+    }
+
+    void InMemoryRecordRepository::Save(const std::vector<StoredRecord>& records) {
+        std::lock_guard lock(mutex_);
+
+        for (const auto& stored : records) {
+            if (ids_.insert(stored.id).second) {
+                records_.push_back(stored);
+            }
+        }
+
+        // Чистка раз в capacity_ вставок, а не на каждую. Сравнение без 2 * capacity_, который переполнился бы
+        if (records_.size() > capacity_ && records_.size() - capacity_ > capacity_) {
+            Trim();
+        }
+    }
+
+    void InMemoryRecordRepository::Trim() {
+        auto is_better = [](const StoredRecord& lhs, const StoredRecord& rhs) {
+            return IsBetterRecord(lhs.record, rhs.record);
+        };
+        std::nth_element(records_.begin(), records_.begin() + capacity_, records_.end(), is_better);
+
+        for (auto it = records_.begin() + capacity_; it != records_.end(); ++it) {
+            ids_.erase(it->id);
+        }
+        records_.resize(capacity_);
+    }
+
+    std::vector<PlayerRecord> InMemoryRecordRepository::LoadBest(size_t limit) {
+        auto result = GetAll();
+        limit = std::min(limit, result.size());
+        std::partial_sort(result.begin(), result.begin() + limit, result.end(), IsBetterRecord);
+        result.resize(limit);
+        return result;
+    }
+
+    std::vector<PlayerRecord> InMemoryRecordRepository::GetAll() const {
+        std::lock_guard lock(mutex_);
+
+        std::vector<PlayerRecord> result;
+        result.reserve(records_.size());
+        for (const auto& stored : records_) {
+            result.push_back(stored.record);
+        }
+        return result;
+    }
+
+    size_t InMemoryRecordRepository::UuidHash::operator()(const boost::uuids::uuid& id) const {
+        return boost::hash_range(id.begin(), id.end());
+    }
+} // namespace records
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "game.h"
+
+#include <boost/uuid/uuid.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace records {
+    using application::game::PlayerRecord;
+
+    struct StoredRecord {
+        // Назначается до первой попытки записи: повтор той же пачки не создаёт дубликатов
+        boost::uuids::uuid id;
+        PlayerRecord record;
+    };
+
+    class RecordRepository {
+    public:
+        virtual ~RecordRepository() = default;
+
+        // Сохраняет пачку целиком или бросает исключение. Уже сохранённые id пропускаются
+        virtual void Save(const std::vector<StoredRecord>& records) = 0;
+
+        // Не больше limit лучших записей в порядке таблицы рекордов
+        virtual std::vector<PlayerRecord> LoadBest(size_t limit) = 0;
+    };
+
+    // Порядок таблицы рекордов: больше очков, при равенстве - меньше время в игре, затем по имени
+    bool IsBetterRecord(const PlayerRecord& lhs, const PlayerRecord& rhs);
+
+    // Хранилище на время работы сервера: когда БД не задана, и для тестов.
+    // Держит не больше capacity лучших записей (до 2 * capacity между чистками): LoadBest большего не вернёт
+    class InMemoryRecordRepository : public RecordRepository {
+    public:
+        explicit InMemoryRecordRepository(size_t capacity = SIZE_MAX);
+
+        void Save(const std::vector<StoredRecord>& records) override;
+        std::vector<PlayerRecord> LoadBest(size_t limit) override;
+
+        std::vector<PlayerRecord> GetAll() const;
+    private:
+        struct UuidHash {
+            size_t operator()(const boost::uuids::uuid& id) const;
+        };
+
+        // Оставляет capacity_ лучших записей
+        void Trim();
+
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        // id хранимых записей: повтор пачки не задваивает их
+        std::unordered_set<boost::uuids::uuid, UuidHash> ids_;
+        std::vector<StoredRecord> records_;
+    };
+} // namespace records
@@ -146,6 +146,8 @@ namespace json_loader {
 
         double default_dog_speed = 1;
         size_t default_bag_capacity = 3;
+        // Секунды простоя, после которых игрок покидает игру; 0 - без ключа в конфигурации игроки не уходят
+        double dog_retirement_time = 0.0;
 
         {
             auto it = json_obj.find("defaultDogSpeed");
@@ -157,9 +159,15 @@ namespace json_loader {
             if (it != json_obj.end()) {
                 default_bag_capacity = it->value().as_int64();
             }
+
+            it = json_obj.find("dogRetirementTime");
+            if (it != json_obj.end()) {
+                dog_retirement_time = it->value().to_number<double>();
+            }
         }
 
         game::Game game(is_random_spawn_, ParseLootGenerator(json_obj));
+        game.SetRetirementTime(std::chrono::milliseconds(static_cast<int64_t>(dog_retirement_time * 1000)));
 
         MapParser parser(default_dog_speed, default_bag_capacity);
 
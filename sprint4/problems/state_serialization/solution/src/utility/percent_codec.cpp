@@ -0,0 +1,156 @@
+#include "percent_codec.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace percent_codec {
+    namespace {
+        constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+        // Значение шестнадцатеричной цифры или -1
+        constexpr auto HEX_VALUES = [] {
+            std::array<int8_t, 256> values{};
+            values.fill(-1);
+            for (int i = 0; i < 10; ++i) {
+                values['0' + i] = static_cast<int8_t>(i);
+            }
+            for (int i = 0; i < 6; ++i) {
+                values['a' + i] = values['A' + i] = static_cast<int8_t>(10 + i);
+            }
+            return values;
+        }();
+
+        constexpr auto IS_UNRESERVED = [] {
+            std::array<bool, 256> unreserved{};
+            for (int c = 0; c < 256; ++c) {
+                unreserved[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                    || c == '-' || c == '.' || c == '_' || c == '~';
+            }
+            return unreserved;
+        }();
+
+#if defined(__SSE2__)
+        // Байты блока из диапазона [lo, hi]. Сравнения в SSE2 знаковые, поэтому диапазон сдвигается к -128
+        inline __m128i InRange(__m128i chunk, char lo, char hi) {
+            const __m128i shifted = _mm_add_epi8(chunk, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+            return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + (hi - lo + 1))));
+        }
+#endif
+
+        // Позиция первого '%' (или '+', если plus_as_space) начиная с pos, size - если их нет
+        size_t FindEscape(const char* data, size_t pos, size_t size, bool plus_as_space) {
+#if defined(__SSE2__)
+            const __m128i percent = _mm_set1_epi8('%');
+            const __m128i plus = _mm_set1_epi8(plus_as_space ? '+' : '%');
+            for (; pos + 16 <= size; pos += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, percent), _mm_cmpeq_epi8(chunk, plus)));
+                if (mask != 0) {
+                    return pos + std::countr_zero(static_cast<unsigned>(mask));
+                }
+            }
+#endif
+            for (; pos < size; ++pos) {
+                if (data[pos] == '%' || (plus_as_space && data[pos] == '+')) {
+                    return pos;
+                }
+            }
+            return size;
+        }
+
+        // Позиция первого символа, который надо кодировать, начиная с pos
+        size_t FindUnsafe(const char* data, size_t pos, size_t size) {
+#if defined(__SSE2__)
+            for (; pos + 16 <= size; pos += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                __m128i safe = _mm_or_si128(_mm_or_si128(InRange(chunk, 'a', 'z'), InRange(chunk, 'A', 'Z')), InRange(chunk, '0', '9'));
+                safe = _mm_or_si128(safe, _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('-')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('.'))));
+                safe = _mm_or_si128(safe, _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('~'))));
+                const unsigned unsafe = ~static_cast<unsigned>(_mm_movemask_epi8(safe)) & 0xFFFF;
+                if (unsafe != 0) {
+                    return pos + std::countr_zero(unsafe);
+                }
+            }
+#endif
+            for (; pos < size; ++pos) {
+                if (!IS_UNRESERVED[static_cast<unsigned char>(data[pos])]) {
+                    return pos;
+                }
+            }
+            return size;
+        }
+    } // namespace
+
+    size_t DecodeInPlace(char* data, size_t size, bool plus_as_space) {
+        size_t read = FindEscape(data, 0, size, plus_as_space);
+        size_t write = read;
+
+        while (read < size) {
+            if (data[read] == '+') {
+                data[write++] = ' ';
+                ++read;
+            }
+            else {
+                if (size - read < 3) {
+                    throw std::invalid_argument("Incomplete percent-encoded sequence");
+                }
+                const int high = HEX_VALUES[static_cast<unsigned char>(data[read + 1])];
+                const int low = HEX_VALUES[static_cast<unsigned char>(data[read + 2])];
+                if (high < 0 || low < 0) {
+                    throw std::invalid_argument("Invalid hex digit in percent-encoded sequence");
+                }
+                data[write++] = static_cast<char>(high << 4 | low);
+                read += 3;
+            }
+
+            // Обычные символы до следующей последовательности переносятся одним куском
+            const size_t next = FindEscape(data, read, size, plus_as_space);
+            std::memmove(data + write, data + read, next - read);
+            write += next - read;
+            read = next;
+        }
+        return write;
+    }
+
+    void DecodeInPlace(std::string& str, bool plus_as_space) {
+        str.resize(DecodeInPlace(str.data(), str.size(), plus_as_space));
+    }
+
+    std::string Decode(std::string_view encoded, bool plus_as_space) {
+        std::string decoded(encoded);
+        DecodeInPlace(decoded, plus_as_space);
+        return decoded;
+    }
+
+    std::string Encode(std::string_view str, bool space_as_plus) {
+        std::string encoded;
+        encoded.reserve(str.size());
+
+        size_t pos = 0;
+        while (pos < str.size()) {
+            const size_t next = FindUnsafe(str.data(), pos, str.size());
+            encoded.append(str.data() + pos, next - pos);
+            if (next == str.size()) {
+                break;
+            }
+
+            const auto c = static_cast<unsigned char>(str[next]);
+            if (c == ' ' && space_as_plus) {
+                encoded += '+';
+            }
+            else {
+                const char escape[] = { '%', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF] };
+                encoded.append(escape, sizeof(escape));
+            }
+            pos = next + 1;
+        }
+        return encoded;
+    }
+} // namespace percent_codec
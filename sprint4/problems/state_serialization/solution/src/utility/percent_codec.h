@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace percent_codec {
+    /*
+     * Раскодирует %XX (и '+' в пробел, если plus_as_space) прямо в буфере, возвращает новую длину.
+     * Результат не длиннее исходной строки, поэтому запись никогда не обгоняет чтение.
+     * Неполная последовательность или не шестнадцатеричная цифра - std::invalid_argument.
+     */
+    size_t DecodeInPlace(char* data, size_t size, bool plus_as_space = true);
+
+    void DecodeInPlace(std::string& str, bool plus_as_space = true);
+
+    std::string Decode(std::string_view encoded, bool plus_as_space = true);
+
+    /*
+     * Оставляет как есть буквы, цифры и -._~ (unreserved из RFC 3986), остальное кодирует в %XX
+     * с заглавными цифрами. Пробел - "+", если space_as_plus, иначе %20.
+     */
+    std::string Encode(std::string_view str, bool space_as_plus = false);
+} // namespace percent_codec
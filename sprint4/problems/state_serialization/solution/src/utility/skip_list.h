@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace skip_list {
+    /*
+     * Упорядоченный список с пропусками, в котором каждая ссылка хранит, сколько элементов она перепрыгивает.
+     * Поэтому кроме поиска по ключу за O(log n) находится и элемент по номеру - без прохода по предыдущим.
+     * Ключи уникальны. Не потокобезопасен.
+     */
+    template <typename Key, typename Less = std::less<Key>>
+    class IndexableSkipList {
+        struct Node;
+
+        struct Link {
+            Node* next = nullptr;
+            // Позиций до next, а для последнего узла уровня - до конца списка
+            size_t width = 1;
+        };
+
+        struct Node {
+            explicit Node(size_t level)
+                : links(level) {
+            }
+
+            Node(Key key, size_t level)
+                : key(std::move(key))
+                , links(level) {
+            }
+
+            Key key{};
+            std::vector<Link> links;
+        };
+    public:
+        static constexpr size_t MAX_LEVEL = 24;
+
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Key;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Key*;
+            using reference = const Key&;
+
+            ConstIterator() = default;
+
+            reference operator*() const {
+                return node_->key;
+            }
+
+            pointer operator->() const {
+                return &node_->key;
+            }
+
+            ConstIterator& operator++() {
+                node_ = node_->links[0].next;
+                return *this;
+            }
+
+            ConstIterator operator++(int) {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const ConstIterator& other) const = default;
+        private:
+            friend class IndexableSkipList;
+
+            explicit ConstIterator(const Node* node)
+                : node_(node) {
+            }
+
+            const Node* node_ = nullptr;
+        };
+
+        explicit IndexableSkipList(Less less = {}, std::mt19937::result_type seed = 5489u)
+            : less_(std::move(less))
+            , head_(MAX_LEVEL)
+            , random_(seed) {
+        }
+
+        IndexableSkipList(const IndexableSkipList&) = delete;
+        IndexableSkipList& operator=(const IndexableSkipList&) = delete;
+
+        ~IndexableSkipList() {
+            Clear();
+        }
+
+        // false, если равный ключ уже есть
+        bool Insert(Key key) {
+            std::array<Node*, MAX_LEVEL> update;
+            std::array<size_t, MAX_LEVEL> rank;
+            FindPredecessors(key, update, rank);
+
+            if (auto* existing = update[0]->links[0].next; existing && !less_(key, existing->key)) {
+                return false;
+            }
+
+            const size_t level = RandomLevel();
+            auto* node = new Node(std::move(key), level);
+            const size_t position = rank[0] + 1;
+
+            for (size_t i = 0; i < MAX_LEVEL; ++i) {
+                auto& link = update[i]->links[i];
+                if (i < level) {
+                    node->links[i] = Link{ link.next, link.width - (position - rank[i]) + 1 };
+                    link = Link{ node, position - rank[i] };
+                }
+                else {
+                    ++link.width;
+                }
+            }
+
+            ++size_;
+            return true;
+        }
+
+        bool Erase(const Key& key) {
+            std::array<Node*, MAX_LEVEL> update;
+            std::array<size_t, MAX_LEVEL> rank;
+            FindPredecessors(key, update, rank);
+
+            auto* node = update[0]->links[0].next;
+            if (!node || less_(key, node->key)) {
+                return false;
+            }
+
+            for (size_t i = 0; i < MAX_LEVEL; ++i) {
+                auto& link = update[i]->links[i];
+                if (link.next == node) {
+                    link = Link{ node->links[i].next, link.width + node->links[i].width - 1 };
+                }
+                else {
+                    --link.width;
+                }
+            }
+
+            delete node;
+            --size_;
+            return true;
+        }
+
+        void Clear() {
+            auto* node = head_.links[0].next;
+            while (node) {
+                auto* next = node->links[0].next;
+                delete node;
+                node = next;
+            }
+            for (auto& link : head_.links) {
+                link = Link{};
+            }
+            size_ = 0;
+        }
+
+        // Элемент с номером rank (с нуля) или end()
+        ConstIterator At(size_t rank) const {
+            if (rank >= size_) {
+                return end();
+            }
+
+            const Node* node = &head_;
+            size_t position = 0;
+            const size_t target = rank + 1;
+
+            for (size_t i = MAX_LEVEL; i-- > 0;) {
+                while (node->links[i].next && position + node->links[i].width <= target) {
+                    position += node->links[i].width;
+                    node = node->links[i].next;
+                }
+            }
+
+            return ConstIterator(node);
+        }
+
+        // Первый элемент больше key
+        ConstIterator UpperBound(const Key& key) const {
+            const Node* node = &head_;
+            for (size_t i = MAX_LEVEL; i-- > 0;) {
+                while (node->links[i].next && !less_(key, node->links[i].next->key)) {
+                    node = node->links[i].next;
+                }
+            }
+            return ConstIterator(node->links[0].next);
+        }
+
+        // Последний элемент; список не должен быть пуст
+        const Key& Back() const {
+            const Node* node = &head_;
+            for (size_t i = MAX_LEVEL; i-- > 0;) {
+                while (node->links[i].next) {
+                    node = node->links[i].next;
+                }
+            }
+            return node->key;
+        }
+
+        ConstIterator begin() const {
+            return ConstIterator(head_.links[0].next);
+        }
+
+        ConstIterator end() const {
+            return ConstIterator();
+        }
+
+        size_t Size() const {
+            return size_;
+        }
+
+        bool Empty() const {
+            return size_ == 0;
+        }
+    private:
+        // update[i] - последний узел уровня i меньше key, rank[i] - его позиция (у головы 0)
+        void FindPredecessors(const Key& key, std::array<Node*, MAX_LEVEL>& update, std::array<size_t, MAX_LEVEL>& rank) {
+            Node* node = &head_;
+            size_t position = 0;
+
+            for (size_t i = MAX_LEVEL; i-- > 0;) {
+                while (node->links[i].next && less_(node->links[i].next->key, key)) {
+                    position += node->links[i].width;
+                    node = node->links[i].next;
+                }
+                update[i] = node;
+                rank[i] = position;
+            }
+        }
+
+        size_t RandomLevel() {
+            // Вероятность перейти на следующий уровень - 1/4
+            size_t level = 1;
+            while (level < MAX_LEVEL && (random_() & 3) == 0) {
+                ++level;
+            }
+            return level;
+        }
+
+        Less less_;
+        Node head_;
+        size_t size_ = 0;
+        std::mt19937 random_;
+    };
+} // namespace skip_list
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace lockfree {
+    /*
+     * Ограниченная очередь без блокировок для одного производителя и одного потребителя.
+     * Ёмкость округляется вверх до степени двойки. Индексы только растут, переполнение size_t на практике недостижимо.
+     */
+    template <typename T>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(size_t capacity)
+            : mask_(RoundUpToPowerOfTwo(capacity) - 1)
+            , slots_(mask_ + 1) {
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Вызывается только производителем. false - очередь полна, value не тронут
+        bool TryPush(T& value) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ > mask_) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ > mask_) {
+                    return false;
+                }
+            }
+
+            slots_[tail & mask_] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Вызывается только потребителем
+        std::optional<T> TryPop() {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_) {
+                    return std::nullopt;
+                }
+            }
+
+            std::optional<T> value(std::move(slots_[head & mask_]));
+            head_.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+        size_t Capacity() const {
+            return mask_ + 1;
+        }
+    private:
+        static size_t RoundUpToPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        const size_t mask_;
+        std::vector<T> slots_;
+
+        // Индексы производителя и потребителя в разных кэш-линиях, каждый со своей копией чужого индекса
+        alignas(64) std::atomic<size_t> head_{ 0 };
+        size_t tail_cache_ = 0;
+
+        alignas(64) std::atomic<size_t> tail_{ 0 };
+        size_t head_cache_ = 0;
+    };
+} // namespace lockfree
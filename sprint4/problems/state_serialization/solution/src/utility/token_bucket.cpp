@@ -0,0 +1,99 @@
+#include "token_bucket.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace rate_limit {
+    KeyedTokenBuckets::KeyedTokenBuckets(BucketSettings settings)
+        : settings_(settings) {
+        settings_.burst = std::max(settings_.burst, 1.0);
+    }
+
+    bool KeyedTokenBuckets::TryAcquire(std::string_view key, Clock::time_point now, Clock::duration& retry_after) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock(shard.mutex);
+
+        auto it = shard.buckets.find(std::string(key));
+        if (it == shard.buckets.end()) {
+            it = Insert(shard, key, now);
+        }
+        return Acquire(it->second, now, retry_after);
+    }
+
+    std::optional<bool> KeyedTokenBuckets::TryAcquireExisting(std::string_view key, Clock::time_point now, Clock::duration& retry_after) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock(shard.mutex);
+
+        auto it = shard.buckets.find(std::string(key));
+        if (it == shard.buckets.end()) {
+            return std::nullopt;
+        }
+        return Acquire(it->second, now, retry_after);
+    }
+
+    void KeyedTokenBuckets::Track(std::string_view key, Clock::time_point now) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock(shard.mutex);
+
+        if (!shard.buckets.contains(std::string(key))) {
+            Insert(shard, key, now);
+        }
+    }
+
+    KeyedTokenBuckets::Shard& KeyedTokenBuckets::GetShard(std::string_view key) {
+        return shards_[std::hash<std::string_view>{}(key) % SHARD_COUNT];
+    }
+
+    KeyedTokenBuckets::Buckets::iterator KeyedTokenBuckets::Insert(Shard& shard, std::string_view key, Clock::time_point now) {
+        if (shard.buckets.size() >= MAX_KEYS_PER_SHARD) {
+            EvictIdle(shard, now);
+        }
+        if (shard.buckets.size() >= MAX_KEYS_PER_SHARD) {
+            // Все корзины заняты: забываем самую давнюю, иначе поток новых ключей растил бы шард без предела
+            auto oldest = std::min_element(shard.buckets.begin(), shard.buckets.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second.updated < rhs.second.updated;
+            });
+            shard.buckets.erase(oldest);
+        }
+        return shard.buckets.emplace(std::string(key), Bucket{ settings_.burst, now }).first;
+    }
+
+    bool KeyedTokenBuckets::Acquire(Bucket& bucket, Clock::time_point now, Clock::duration& retry_after) const {
+        Refill(bucket, now);
+
+        if (bucket.tokens >= 1.0) {
+            bucket.tokens -= 1.0;
+            return true;
+        }
+
+        retry_after = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((1.0 - bucket.tokens) / settings_.rate));
+        return false;
+    }
+
+    size_t KeyedTokenBuckets::Size() const {
+        size_t size = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            size += shard.buckets.size();
+        }
+        return size;
+    }
+
+    void KeyedTokenBuckets::Refill(Bucket& bucket, Clock::time_point now) const {
+        if (now <= bucket.updated) {
+            return;
+        }
+        const double elapsed = std::chrono::duration<double>(now - bucket.updated).count();
+        bucket.tokens = std::min(settings_.burst, bucket.tokens + elapsed * settings_.rate);
+        bucket.updated = now;
+    }
+
+    void KeyedTokenBuckets::EvictIdle(Shard& shard, Clock::time_point now) const {
+        // Полная корзина ничем не отличается от новой, поэтому её можно забыть
+        std::erase_if(shard.buckets, [this, now](const auto& item) {
+            const auto& bucket = item.second;
+            const double elapsed = std::chrono::duration<double>(now - bucket.updated).count();
+            return bucket.tokens + elapsed * settings_.rate >= settings_.burst;
+        });
+    }
+} // namespace rate_limit
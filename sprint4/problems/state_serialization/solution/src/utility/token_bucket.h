@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rate_limit {
+    struct BucketSettings {
+        // Пополнение, запросов в секунду; 0 - ограничение выключено
+        double rate = 0.0;
+        // Сколько запросов можно сделать подряд после простоя
+        double burst = 1.0;
+
+        bool IsEnabled() const {
+            return rate > 0.0;
+        }
+    };
+
+    /*
+     * Token bucket на каждый ключ (токен игрока, IP-адрес).
+     * Вызывается из потоков соединений одновременно, поэтому ключи разбиты по шардам со своим мьютексом.
+     * Простаивающие корзины, успевшие наполниться, удаляются, когда шард разрастается; если их нет,
+     * удаляется корзина, к которой дольше всех не обращались, так что шард не растёт больше MAX_KEYS_PER_SHARD.
+     */
+    class KeyedTokenBuckets {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit KeyedTokenBuckets(BucketSettings settings);
+
+        // Списывает запрос с корзины key. Если корзина пуста, возвращает false и время до следующего запроса
+        bool TryAcquire(std::string_view key, Clock::time_point now, Clock::duration& retry_after);
+
+        // То же, но без создания корзины: для ключа, которого нет, возвращает nullopt
+        std::optional<bool> TryAcquireExisting(std::string_view key, Clock::time_point now, Clock::duration& retry_after);
+
+        // Заводит корзину для key, если её ещё нет
+        void Track(std::string_view key, Clock::time_point now);
+
+        size_t Size() const;
+    private:
+        static constexpr size_t SHARD_COUNT = 16;
+        static constexpr size_t MAX_KEYS_PER_SHARD = 4096;
+
+        struct Bucket {
+            double tokens;
+            Clock::time_point updated;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, Bucket> buckets;
+        };
+
+        using Buckets = std::unordered_map<std::string, Bucket>;
+
+        Shard& GetShard(std::string_view key);
+
+        Buckets::iterator Insert(Shard& shard, std::string_view key, Clock::time_point now);
+
+        bool Acquire(Bucket& bucket, Clock::time_point now, Clock::duration& retry_after) const;
+
+        void Refill(Bucket& bucket, Clock::time_point now) const;
+
+        void EvictIdle(Shard& shard, Clock::time_point now) const;
+
+        BucketSettings settings_;
+        std::array<Shard, SHARD_COUNT> shards_;
+    };
+} // namespace rate_limit
@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <boost/json/src.hpp>
+
+#include "../src/records/async_record_writer.h"
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace records;
+using namespace std::literals;
+
+namespace {
+    std::vector<PlayerRecord> MakeRecords(size_t count, size_t first_score = 0) {
+        std::vector<PlayerRecord> result;
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(PlayerRecord{ .name = "dog" + std::to_string(first_score + i), .score = first_score + i, .play_time = 1000ms });
+        }
+        return result;
+    }
+
+    // Отказывает первые failures раз, затем пишет в память
+    class FlakyRepository : public RecordRepository {
+    public:
+        explicit FlakyRepository(int failures)
+            : failures_left_(failures) {
+        }
+
+        void Save(const std::vector<StoredRecord>& records) override {
+            ++attempts;
+            if (failures_left_ > 0) {
+                --failures_left_;
+                // Сбой после записи: повтор той же пачки не должен её задвоить
+                storage.Save(records);
+                throw std::runtime_error("connection lost");
+            }
+            storage.Save(records);
+        }
+
+        std::vector<PlayerRecord> LoadBest(size_t limit) override {
+            return storage.LoadBest(limit);
+        }
+
+        InMemoryRecordRepository storage;
+        std::atomic<int> attempts = 0;
+    private:
+        int failures_left_;
+    };
+
+    WriterSettings FastRetries() {
+        return WriterSettings{ .capacity = 64, .max_batch = 16, .initial_backoff = 1ms, .max_backoff = 4ms, .max_attempts = 5, .shutdown_attempts = 5 };
+    }
+}
+
+TEST_CASE("Writer flushes all published records on stop") {
+    InMemoryRecordRepository repository;
+    AsyncRecordWriter writer(repository, FastRetries());
+
+    writer.Publish(MakeRecords(10));
+    writer.Publish(MakeRecords(40, 10));
+    writer.Stop();
+
+    CHECK(repository.GetAll().size() == 50);
+    CHECK(writer.GetStats().written == 50);
+    CHECK(writer.GetStats().dropped == 0);
+}
+
+TEST_CASE("Writer retries failed batches without duplicates") {
+    FlakyRepository repository(2);
+    AsyncRecordWriter writer(repository, FastRetries());
+
+    writer.Publish(MakeRecords(5));
+    writer.Stop();
+
+    CHECK(repository.attempts == 3);
+    CHECK(repository.storage.GetAll().size() == 5);
+    CHECK(writer.GetStats().written == 5);
+    CHECK(writer.GetStats().failed == 0);
+}
+
+TEST_CASE("Writer gives up after max attempts") {
+    FlakyRepository repository(100);
+    auto settings = FastRetries();
+    settings.max_attempts = 3;
+    AsyncRecordWriter writer(repository, settings);
+
+    writer.Publish(MakeRecords(5));
+    writer.Stop();
+
+    // 3 попытки целой пачки и по одной на каждую часть при делении 5 -> 2 + 3 -> ... -> 1
+    CHECK(repository.attempts == 3 + 8);
+    CHECK(writer.GetStats().failed == 5);
+    CHECK(writer.GetStats().written == 0);
+}
+
+TEST_CASE("A record the storage rejects doesn't take the rest of the batch down") {
+    // Отказывает любой пачке с записью "bad", как БД - строке, нарушающей ограничения схемы
+    struct PickyRepository : RecordRepository {
+        void Save(const std::vector<StoredRecord>& records) override {
+            for (const auto& stored : records) {
+                if (stored.record.name == "bad") {
+                    throw std::runtime_error("value too long");
+                }
+            }
+            storage.Save(records);
+        }
+
+        std::vector<PlayerRecord> LoadBest(size_t limit) override {
+            return storage.LoadBest(limit);
+        }
+
+        InMemoryRecordRepository storage;
+    } repository;
+
+    auto settings = FastRetries();
+    settings.max_attempts = 2;
+    AsyncRecordWriter writer(repository, settings);
+
+    auto records = MakeRecords(10);
+    records[3].name = "bad";
+    writer.Publish(std::move(records));
+    writer.Stop();
+
+    CHECK(writer.GetStats().written == 9);
+    CHECK(writer.GetStats().failed == 1);
+    CHECK(repository.storage.GetAll().size() == 9);
+}
+
+TEST_CASE("In-memory storage keeps only the best records") {
+    InMemoryRecordRepository repository(3);
+    AsyncRecordWriter writer(repository, FastRetries());
+
+    writer.Publish(MakeRecords(20));
+    writer.Stop();
+
+    CHECK(repository.GetAll().size() <= 2 * 3);
+    const auto best = repository.LoadBest(3);
+    REQUIRE(best.size() == 3);
+    CHECK(best[0].score == 19);
+    CHECK(best[2].score == 17);
+}
+
+TEST_CASE("Records beyond buffer capacity are dropped, not blocked on") {
+    // Хранилище держит поток записи, пока тест не опубликует больше, чем помещается в очередь
+    struct BlockingRepository : RecordRepository {
+        void Save(const std::vector<StoredRecord>& records) override {
+            entered = true;
+            entered.notify_one();
+            release.wait(false);
+            storage.Save(records);
+        }
+
+        std::vector<PlayerRecord> LoadBest(size_t limit) override {
+            return storage.LoadBest(limit);
+        }
+
+        std::atomic<bool> entered = false;
+        std::atomic<bool> release = false;
+        InMemoryRecordRepository storage;
+    } repository;
+
+    auto settings = FastRetries();
+    settings.capacity = 8;
+    settings.max_batch = 1;
+    AsyncRecordWriter writer(repository, settings);
+
+    writer.Publish(MakeRecords(1));
+    repository.entered.wait(false);
+
+    writer.Publish(MakeRecords(20, 1));
+    repository.release = true;
+    repository.release.notify_one();
+    writer.Stop();
+
+    const auto stats = writer.GetStats();
+    CHECK(stats.dropped == 12);
+    CHECK(stats.written == 9);
+    CHECK(repository.storage.GetAll().size() == 9);
+}
+
+TEST_CASE("Publish after stop drops records") {
+    InMemoryRecordRepository repository;
+    AsyncRecordWriter writer(repository, FastRetries());
+    writer.Stop();
+
+    writer.Publish(MakeRecords(3));
+
+    CHECK(writer.GetStats().dropped == 3);
+    CHECK(repository.GetAll().empty());
+}
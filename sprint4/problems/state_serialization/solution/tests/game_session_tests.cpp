@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/GameModelLib/include/game.h"
+
+using namespace application::game;
+using namespace std::literals;
+
+namespace {
+    // Одна горизонтальная дорога; игроки появляются в её начале, трофеи не генерируются
+    map::Map MakeRoadMap() {
+        std::string id = "road";
+        std::vector<size_t> loot_values{ 10 };
+
+        auto map = map::MapBuilder()
+            .SetId(id)
+            .SetName("Road")
+            .SetDogSpeed(1.0)
+            .SetTypesValue(loot_values)
+            .SetBagCapacity(3)
+            .Build();
+        map.AddRoad(map::Road(map::Road::HORIZONTAL, { 0, 0 }, 100));
+        return map;
+    }
+
+    loot_gen::LootGenerator MakeNoLootGenerator() {
+        return loot_gen::LootGenerator(1000ms, 0.0, [] {
+            return 0.0;
+        });
+    }
+}
+
+SCENARIO("Players retire after standing idle") {
+    GIVEN("a session with a retirement time of one second") {
+        GameSession session(MakeRoadMap(), false, MakeNoLootGenerator());
+        session.SetRetirementTime(1000ms);
+
+        std::string name = "dog";
+        auto [token, id] = session.AddPlayer(name);
+        auto* player = session.GetPlayer(token);
+
+        WHEN("the dog moves past its spawn timer and is then stopped with an empty move") {
+            player->SetDirection(Direction::EAST);
+            session.ProcessTick(1000);
+            REQUIRE(session.TakeRetiredPlayers().empty());
+
+            player->Stop();
+            session.ProcessTick(50);
+            session.ProcessTick(900);
+
+            THEN("it stays while the retirement time has not passed") {
+                CHECK(session.TakeRetiredPlayers().empty());
+                CHECK(session.GetPlayers().size() == 1);
+
+                AND_WHEN("the retirement time passes") {
+                    session.ProcessTick(100);
+
+                    THEN("the player is retired") {
+                        auto retired = session.TakeRetiredPlayers();
+                        REQUIRE(retired.size() == 1);
+                        CHECK(retired.front().player_id == id);
+                        CHECK(retired.front().record.name == "dog");
+                        CHECK(session.GetPlayers().empty());
+                    }
+                }
+            }
+        }
+
+        WHEN("the dog starts moving again before the retirement time") {
+            session.ProcessTick(500);
+            player->SetDirection(Direction::EAST);
+            player->Stop();
+            session.ProcessTick(600);
+
+            THEN("the timer from the first stop doesn't retire it") {
+                CHECK(session.TakeRetiredPlayers().empty());
+                CHECK(session.GetPlayers().size() == 1);
+            }
+        }
+    }
+}
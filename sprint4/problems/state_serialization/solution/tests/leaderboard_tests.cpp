@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/records/leaderboard.h"
+#include "../src/records/records.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace records;
+using namespace std::literals;
+
+namespace {
+    PlayerRecord MakeRecord(std::string name, size_t score, std::chrono::milliseconds play_time = 1000ms) {
+        return PlayerRecord{ .name = std::move(name), .score = score, .play_time = play_time };
+    }
+
+    std::vector<std::string> Names(const std::vector<const Leaderboard::Entry*>& page) {
+        std::vector<std::string> result;
+        for (const auto* entry : page) {
+            result.push_back(entry->record.name);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Skip list keeps order and rank access in sync with std::set") {
+    skip_list::IndexableSkipList<int> list;
+    std::set<int> reference;
+    std::mt19937 random(42);
+
+    for (int step = 0; step < 5000; ++step) {
+        const int value = static_cast<int>(random() % 1000);
+        if (random() % 3 == 0) {
+            CHECK(list.Erase(value) == (reference.erase(value) == 1));
+        }
+        else {
+            CHECK(list.Insert(value) == reference.insert(value).second);
+        }
+    }
+
+    REQUIRE(list.Size() == reference.size());
+    CHECK(std::equal(list.begin(), list.end(), reference.begin(), reference.end()));
+    CHECK(list.Back() == *reference.rbegin());
+
+    size_t rank = 0;
+    for (int value : reference) {
+        REQUIRE(*list.At(rank++) == value);
+        auto next = reference.upper_bound(value);
+        CHECK((list.UpperBound(value) == list.end()) == (next == reference.end()));
+    }
+    CHECK(list.At(reference.size()) == list.end());
+}
+
+TEST_CASE("Leaderboard orders by score, then play time, then name") {
+    Leaderboard leaderboard;
+    leaderboard.Publish({ MakeRecord("b", 10, 5000ms), MakeRecord("a", 10, 5000ms), MakeRecord("c", 10, 1000ms), MakeRecord("d", 20) });
+
+    CHECK(Names(leaderboard.GetPage(0, 10)) == std::vector{ "d"s, "c"s, "a"s, "b"s });
+    CHECK(Names(leaderboard.GetPage(1, 2)) == std::vector{ "c"s, "a"s });
+    CHECK(leaderboard.GetPage(4, 10).empty());
+}
+
+TEST_CASE("Leaderboard keeps only the best records within capacity") {
+    Leaderboard leaderboard(3);
+    leaderboard.Load({ MakeRecord("a", 1), MakeRecord("b", 5), MakeRecord("c", 3) });
+    leaderboard.Publish({ MakeRecord("d", 4), MakeRecord("e", 0) });
+
+    CHECK(leaderboard.Size() == 3);
+    CHECK(Names(leaderboard.GetPage(0, 10)) == std::vector{ "b"s, "d"s, "c"s });
+}
+
+TEST_CASE("Cursor pages are stable when better records arrive") {
+    Leaderboard leaderboard;
+    for (size_t i = 0; i < 10; ++i) {
+        leaderboard.Publish({ MakeRecord("dog" + std::to_string(i), 100 - i) });
+    }
+
+    auto first = leaderboard.GetPage(0, 3);
+    auto cursor = Leaderboard::ParseCursor(Leaderboard::MakeCursor(*first.back()));
+    REQUIRE(cursor);
+
+    leaderboard.Publish({ MakeRecord("best", 1000) });
+
+    CHECK(Names(leaderboard.GetPageAfter(*cursor, 3)) == std::vector{ "dog3"s, "dog4"s, "dog5"s });
+    CHECK(Names(leaderboard.GetPage(3, 3)) == std::vector{ "dog2"s, "dog3"s, "dog4"s });
+}
+
+TEST_CASE("Malformed cursors are rejected") {
+    CHECK_FALSE(Leaderboard::ParseCursor(""sv));
+    CHECK_FALSE(Leaderboard::ParseCursor("1.2.3"sv));
+    CHECK_FALSE(Leaderboard::ParseCursor("1.2.x.00"sv));
+    CHECK_FALSE(Leaderboard::ParseCursor("1.2.3.abc"sv));
+
+    auto cursor = Leaderboard::ParseCursor(Leaderboard::MakeCursor(Leaderboard::Entry{ .record = MakeRecord("Пёс & co", 7, 1500ms), .seq = 9 }));
+    REQUIRE(cursor);
+    CHECK(cursor->record.name == "Пёс & co");
+    CHECK(cursor->record.score == 7);
+    CHECK(cursor->record.play_time == 1500ms);
+    CHECK(cursor->seq == 9);
+}
+
+TEST_CASE("Leaderboard forwards published records downstream") {
+    struct CollectingSink : PlayerRecordSink {
+        void Publish(std::vector<PlayerRecord> records) override {
+            received.insert(received.end(), records.begin(), records.end());
+        }
+        std::vector<PlayerRecord> received;
+    } sink;
+
+    Leaderboard leaderboard(1, &sink);
+    leaderboard.Load({ MakeRecord("loaded", 100) });
+    leaderboard.Publish({ MakeRecord("a", 1), MakeRecord("b", 2) });
+
+    CHECK(sink.received.size() == 2);
+    CHECK(Names(leaderboard.GetPage(0, 10)) == std::vector{ "loaded"s });
+}
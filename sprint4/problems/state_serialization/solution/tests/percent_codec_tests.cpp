@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/utility/percent_codec.h"
+
+#include <random>
+#include <stdexcept>
+
+using namespace std::literals;
+
+TEST_CASE("Percent decoding") {
+    CHECK(percent_codec::Decode(""sv) == ""s);
+    CHECK(percent_codec::Decode("simpletext"sv) == "simpletext"s);
+    CHECK(percent_codec::Decode("simple+text"sv) == "simple text"s);
+    CHECK(percent_codec::Decode("simple+text"sv, false) == "simple+text"s);
+    CHECK(percent_codec::Decode("%7B%7d%5B%5D"sv) == "{}[]"s);
+    CHECK(percent_codec::Decode("+%2B"sv) == " +"s);
+    CHECK(percent_codec::Decode("%E3%81%93"sv) == "こ"s);
+
+    // Последовательность на границе 16-байтных блоков
+    CHECK(percent_codec::Decode("/images/long-name%20with%20spaces.png"sv) == "/images/long-name with spaces.png"s);
+}
+
+TEST_CASE("Malformed escapes are rejected") {
+    CHECK_THROWS_AS(percent_codec::Decode("%ZZ"sv), std::invalid_argument);
+    CHECK_THROWS_AS(percent_codec::Decode("%2Z"sv), std::invalid_argument);
+    CHECK_THROWS_AS(percent_codec::Decode("text%2"sv), std::invalid_argument);
+    CHECK_THROWS_AS(percent_codec::Decode("text%"sv), std::invalid_argument);
+    CHECK_THROWS_AS(percent_codec::Decode("a-long-prefix-before-bad-escape%G0"sv), std::invalid_argument);
+}
+
+TEST_CASE("Decoding in place") {
+    std::string path = "/static/my%20file+1.txt";
+    percent_codec::DecodeInPlace(path);
+    CHECK(path == "/static/my file 1.txt");
+
+    char buffer[] = "%41%42c";
+    CHECK(percent_codec::DecodeInPlace(buffer, 7) == 3);
+    CHECK(std::string_view(buffer, 3) == "ABc"sv);
+}
+
+TEST_CASE("Percent encoding") {
+    CHECK(percent_codec::Encode("hello"sv) == "hello"s);
+    CHECK(percent_codec::Encode("abc-_.~123"sv) == "abc-_.~123"s);
+    CHECK(percent_codec::Encode("hello world"sv) == "hello%20world"s);
+    CHECK(percent_codec::Encode("hello world"sv, true) == "hello+world"s);
+    CHECK(percent_codec::Encode("!#$&'()*+,/:;=?@[]"sv) == "%21%23%24%26%27%28%29%2A%2B%2C%2F%3A%3B%3D%3F%40%5B%5D"s);
+    CHECK(percent_codec::Encode("こんにちは"sv) == "%E3%81%93%E3%82%93%E3%81%AB%E3%81%A1%E3%81%AF"s);
+    CHECK(percent_codec::Encode("an-unreserved-prefix-of-32-bytes/"sv) == "an-unreserved-prefix-of-32-bytes%2F"s);
+}
+
+TEST_CASE("Decoding reverses encoding for any bytes") {
+    std::mt19937 random(42);
+    for (int step = 0; step < 1000; ++step) {
+        std::string str(random() % 100, '\0');
+        for (auto& c : str) {
+            // Чаще безопасные символы, чтобы векторный путь находил длинные куски без кодирования
+            c = random() % 4 == 0 ? static_cast<char>(random() % 256) : static_cast<char>('a' + random() % 26);
+        }
+        const bool space_as_plus = step % 2 == 0;
+        CHECK(percent_codec::Decode(percent_codec::Encode(str, space_as_plus), space_as_plus) == str);
+    }
+}
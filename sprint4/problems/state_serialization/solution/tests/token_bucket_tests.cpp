@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/utility/token_bucket.h"
+
+#include <string>
+
+using namespace std::literals;
+
+TEST_CASE("Token buckets are created only for tracked keys when asked") {
+    rate_limit::KeyedTokenBuckets buckets({ .rate = 1.0, .burst = 2.0 });
+    const auto now = rate_limit::KeyedTokenBuckets::Clock::now();
+    rate_limit::KeyedTokenBuckets::Clock::duration retry_after{};
+
+    CHECK_FALSE(buckets.TryAcquireExisting("token", now, retry_after).has_value());
+    CHECK(buckets.Size() == 0);
+
+    buckets.Track("token", now);
+    CHECK(buckets.TryAcquireExisting("token", now, retry_after) == true);
+    CHECK(buckets.TryAcquireExisting("token", now, retry_after) == true);
+    CHECK(buckets.TryAcquireExisting("token", now, retry_after) == false);
+    CHECK(retry_after > 0s);
+
+    // Пополнение за секунду простоя
+    CHECK(buckets.TryAcquireExisting("token", now + 1s, retry_after) == true);
+}
+
+TEST_CASE("Token buckets stay bounded under a flood of new keys") {
+    rate_limit::KeyedTokenBuckets buckets({ .rate = 1.0, .burst = 1.0 });
+    const auto now = rate_limit::KeyedTokenBuckets::Clock::now();
+    rate_limit::KeyedTokenBuckets::Clock::duration retry_after{};
+
+    // Все корзины только что опустошены, поэтому простаивающих среди них нет
+    for (int i = 0; i < 100'000; ++i) {
+        buckets.TryAcquire("key" + std::to_string(i), now, retry_after);
+    }
+    CHECK(buckets.Size() <= 16 * 4096);
+}